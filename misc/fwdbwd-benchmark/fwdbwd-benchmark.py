@@ -0,0 +1,328 @@
+#! /usr/bin/env python
+
+"""
+Compare search with backward analysis (fwdbwd) against classic eager
+and lazy search on a fixed list of tasks from downward-benchmarks.
+
+For each task and configuration, the script records solved status,
+plan cost, expansions, evaluations, wall-clock and CPU time, peak
+resident memory and the fwdbwd counters in a CSV file. Afterwards, the
+results are compared against a stored baseline and all regressions
+are listed. The exit code is 1 if there is a regression.
+
+Usage:
+    ./build.py release64
+    misc/fwdbwd-benchmark/fwdbwd-benchmark.py --build release64
+
+All tasks are in transition normal form (every effect variable has a
+precondition and there are no conditional effects), and the fwdbwd
+configurations make backward steps on all of them. The larger tasks run
+for seconds.
+
+To update the baseline after an intended change, run the script with
+--write-baseline. This also stores a description of the machine next to
+the baseline. Since times depend on the machine, CPU times are only
+compared if the current machine has the same description. Wall-clock
+times are recorded but not compared, because they vary too much on
+shared machines.
+"""
+
+from __future__ import print_function
+
+import argparse
+import csv
+import os
+import platform
+import re
+import resource
+import subprocess
+import sys
+import time
+
+DIR = os.path.dirname(os.path.abspath(__file__))
+REPO = os.path.dirname(os.path.dirname(DIR))
+BENCHMARKS_DIR = os.path.join(REPO, "downward-benchmarks")
+FAST_DOWNWARD = os.path.join(REPO, "fast-downward.py")
+DEFAULT_BASELINE = os.path.join(DIR, "baseline.csv")
+
+# TNF tasks that all configurations solve within the limits below. With
+# backward analysis, tpp:p06 takes about 1 second and 400 MB, and
+# hiking-opt14-strips:ptesting-1-2-3 about 5 seconds and 1.3 GB.
+TASKS = [
+    ("hiking-opt14-strips", "ptesting-1-2-3"),
+    ("mystery", "prob01"),
+    ("tpp", "p05"),
+    ("tpp", "p06"),
+]
+
+CONFIGS = [
+    ("fwdbwd-eager-ff", ["eager_greedy([ff()])"]),
+    ("classic-eager-ff", ["eager_greedy([ff()], backward_analysis=false)"]),
+    ("fwdbwd-lazy-ff", ["fwdbwd_lazy_greedy([ff()])"]),
+    ("classic-lazy-ff", ["lazy_greedy([ff()])"]),
+]
+
+TIME_LIMIT = 60
+MEMORY_LIMIT = 2 * 1024 ** 3
+
+# Patterns for the values that the search component prints.
+PATTERNS = [
+    ("plan_cost", r"^Plan cost: (\d+)$"),
+    ("expansions", r"^Expanded (\d+) state\(s\)\.$"),
+    ("evaluations", r"^Evaluated (\d+) state\(s\)\.$"),
+    ("generated", r"^Generated (\d+) state\(s\)\.$"),
+    ("forward_steps", r"^Forward steps: (\d+)$"),
+    ("backward_steps", r"^Backward steps: (\d+)$"),
+    ("stack_entries", r"^Operator stack entries: (\d+)$"),
+]
+
+FIELDS = (["task", "config", "solved", "wall_time", "cpu_time", "peak_rss_kb"] +
+          [name for name, _ in PATTERNS])
+
+
+class Check(object):
+    """
+    Compare the attribute values x and y of two runs and check whether
+    y/x <= *max_rel*. Skip the check if x is smaller than *min_base*,
+    since small values are dominated by measurement noise and the fixed
+    costs of starting the planner. Checks of machine-dependent
+    attributes are skipped if the baseline comes from another machine.
+    """
+    def __init__(self, attribute, max_rel, min_base=0, machine_dependent=False):
+        self.attribute = attribute
+        self.max_rel = max_rel
+        self.min_base = min_base
+        self.machine_dependent = machine_dependent
+
+    def get_error(self, base, new):
+        val1 = base.get(self.attribute)
+        val2 = new.get(self.attribute)
+        if val1 is None or val2 is None:
+            # Unsolved runs and some configs don't produce certain attributes.
+            return ""
+        if val1 == 0 or val1 < self.min_base:
+            return ""
+        factor = val2 / float(val1)
+        if factor > self.max_rel:
+            return "{} | {:.2f} / {:.2f} = {:.2f} > {:.2f}".format(
+                self.attribute, val2, val1, factor, self.max_rel)
+        return ""
+
+
+CHECKS = [
+    Check("expansions", max_rel=1.0),
+    Check("evaluations", max_rel=1.0),
+    Check("cpu_time", max_rel=1.25, min_base=0.2, machine_dependent=True),
+    Check("peak_rss_kb", max_rel=1.1, min_base=50 * 1024),
+]
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(
+        description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument(
+        "--build", default="release32",
+        help="build name or path to the directory holding the binaries "
+             "(as for fast-downward.py, default: %(default)s)")
+    parser.add_argument(
+        "--output", default="fwdbwd-benchmark.csv",
+        help="CSV file for the results of this run (default: %(default)s)")
+    parser.add_argument(
+        "--baseline", default=DEFAULT_BASELINE,
+        help="CSV file with the baseline results (default: %(default)s)")
+    parser.add_argument(
+        "--write-baseline", action="store_true",
+        help="store the results as new baseline instead of comparing")
+    parser.add_argument(
+        "--scratch", default="fwdbwd-benchmark-tasks",
+        help="directory for the translated tasks (default: %(default)s)")
+    return parser.parse_args()
+
+
+def get_search_executable(build):
+    build_dir = build
+    if not os.path.exists(build_dir):
+        build_dir = os.path.join(REPO, "builds", build, "bin")
+    executable = os.path.join(build_dir, "downward")
+    if not os.path.exists(executable):
+        sys.exit("Could not find {}. Please run './build.py {}'.".format(
+            executable, build))
+    return executable
+
+
+def translate(build, domain, problem, scratch):
+    sas_file = os.path.join(scratch, "{}-{}.sas".format(domain, problem))
+    if not os.path.exists(sas_file):
+        domain_dir = os.path.join(BENCHMARKS_DIR, domain)
+        subprocess.check_call(
+            [sys.executable, FAST_DOWNWARD, "--build", build,
+             "--sas-file", sas_file, "--translate",
+             os.path.join(domain_dir, "domain.pddl"),
+             os.path.join(domain_dir, problem + ".pddl")],
+            stdout=open(os.devnull, "w"))
+    return sas_file
+
+
+def set_limits():
+    resource.setrlimit(resource.RLIMIT_CPU, (TIME_LIMIT, TIME_LIMIT + 1))
+    resource.setrlimit(resource.RLIMIT_AS, (MEMORY_LIMIT, MEMORY_LIMIT))
+
+
+def run_search(executable, sas_file, search_options):
+    plan_file = sas_file + ".plan"
+    cmd = [executable, "--internal-plan-file", plan_file] + search_options
+    start = time.time()
+    with open(sas_file) as input_file:
+        process = subprocess.Popen(
+            cmd, stdin=input_file, stdout=subprocess.PIPE,
+            universal_newlines=True, preexec_fn=set_limits)
+        output = process.stdout.read()
+        # Use wait4 to obtain the CPU time and peak resident memory of the
+        # search alone.
+        _, status, rusage = os.wait4(process.pid, 0)
+        process.returncode = status
+    run = {
+        "solved": int(os.WIFEXITED(status) and os.WEXITSTATUS(status) == 0),
+        "wall_time": time.time() - start,
+        "cpu_time": rusage.ru_utime + rusage.ru_stime,
+        "peak_rss_kb": rusage.ru_maxrss,
+    }
+    for name, pattern in PATTERNS:
+        match = re.search(pattern, output, re.M)
+        run[name] = int(match.group(1)) if match else None
+    if not run["solved"]:
+        # Only compare values of solved runs.
+        for name in (["wall_time", "cpu_time", "peak_rss_kb"] +
+                     [name for name, _ in PATTERNS]):
+            run[name] = None
+    return run
+
+
+def write_csv(path, runs):
+    with open(path, "w") as f:
+        writer = csv.DictWriter(f, FIELDS, lineterminator="\n")
+        writer.writeheader()
+        for run in runs:
+            writer.writerow(run)
+
+
+def read_csv(path):
+    runs = []
+    with open(path) as f:
+        for row in csv.DictReader(f):
+            run = {}
+            for key, value in row.items():
+                if key in ["task", "config"]:
+                    run[key] = value
+                elif value == "":
+                    run[key] = None
+                elif key in ["wall_time", "cpu_time"]:
+                    run[key] = float(value)
+                else:
+                    run[key] = int(value)
+            runs.append(run)
+    return runs
+
+
+def get_machine_description():
+    lines = ["platform: " + platform.platform()]
+    try:
+        with open("/proc/cpuinfo") as f:
+            models = re.findall(r"^model name\s*: (.*)$", f.read(), re.M)
+        if models:
+            lines.append("processor: " + models[0])
+    except IOError:
+        lines.append("processor: " + platform.processor())
+    lines.append("cores: {}".format(os.cpu_count() if hasattr(os, "cpu_count")
+                                    else "unknown"))
+    return "\n".join(lines) + "\n"
+
+
+def get_machine_file(baseline):
+    return os.path.splitext(baseline)[0] + "-machine.txt"
+
+
+def compare(baseline_runs, runs, same_machine):
+    baseline = dict(((run["task"], run["config"]), run) for run in baseline_runs)
+    lines = []
+    for run in runs:
+        key = (run["task"], run["config"])
+        if key not in baseline:
+            continue
+        base = baseline[key]
+        errors = []
+        if base["solved"] and not run["solved"]:
+            errors.append("task is no longer solved")
+        errors.extend(check.get_error(base, run) for check in CHECKS
+                      if same_machine or not check.machine_dependent)
+        for error in errors:
+            if error:
+                lines.append("| {} | {} | {} |".format(key[0], key[1], error))
+    return lines
+
+
+def print_summary(runs):
+    print("\nSummary (solved tasks, total wall time, total expansions):")
+    for nick, _ in CONFIGS:
+        config_runs = [run for run in runs if run["config"] == nick]
+        solved = [run for run in config_runs if run["solved"]]
+        print("{:20} {:3d}/{:d} {:10.2f}s {:12d}".format(
+            nick, len(solved), len(config_runs),
+            sum(run["wall_time"] for run in solved),
+            sum(run["expansions"] for run in solved)))
+
+
+def main():
+    args = parse_args()
+    executable = get_search_executable(args.build)
+    if not os.path.exists(args.scratch):
+        os.makedirs(args.scratch)
+
+    runs = []
+    for domain, problem in TASKS:
+        sas_file = translate(args.build, domain, problem, args.scratch)
+        for nick, config in CONFIGS:
+            print("Running {} on {}:{}".format(nick, domain, problem))
+            sys.stdout.flush()
+            run = run_search(executable, sas_file, ["--search"] + config)
+            run["task"] = "{}:{}".format(domain, problem)
+            run["config"] = nick
+            runs.append(run)
+
+    print_summary(runs)
+    write_csv(args.output, runs)
+    print("\nWrote results to {}".format(args.output))
+
+    machine = get_machine_description()
+    machine_file = get_machine_file(args.baseline)
+    if args.write_baseline:
+        write_csv(args.baseline, runs)
+        with open(machine_file, "w") as f:
+            f.write(machine)
+        print("Wrote baseline to {} and {}".format(args.baseline, machine_file))
+        return
+
+    if not os.path.exists(args.baseline):
+        sys.exit("Baseline {} not found. Use --write-baseline to create it.".format(
+            args.baseline))
+    baseline_machine = ""
+    if os.path.exists(machine_file):
+        with open(machine_file) as f:
+            baseline_machine = f.read()
+    same_machine = baseline_machine == machine
+    if not same_machine:
+        print("\nThe baseline was recorded on another machine, so CPU "
+              "times are not compared.\nBaseline machine:\n{}"
+              "This machine:\n{}".format(baseline_machine or "unknown\n", machine),
+              end="")
+    lines = compare(read_csv(args.baseline), runs, same_machine)
+    if lines:
+        print("\nThere has been a regression:\n")
+        print("| Task | Config | Attribute | Error |")
+        print("\n".join(lines))
+        sys.exit(1)
+    print("\nNo regressions compared to {}".format(args.baseline))
+
+
+if __name__ == "__main__":
+    main()
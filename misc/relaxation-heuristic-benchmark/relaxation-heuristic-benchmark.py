@@ -0,0 +1,145 @@
+#! /usr/bin/env python
+
+"""
+Compare the evaluation speed of the relaxation heuristics (h^add, h^FF
+and h^max) of two planner builds, e.g. before and after a change to the
+data layout of the relaxed task.
+
+The script runs A* with each heuristic and a fixed search time limit
+on each task and reports the number of evaluated states per second of
+both builds. The heuristics dominate the runtime of these searches, so
+the rates compare the heuristic computations. (A* is only used because
+it rarely solves these tasks within the time limit.)
+
+Usage:
+    misc/relaxation-heuristic-benchmark/relaxation-heuristic-benchmark.py \\
+        --base-build path/to/base/bin --build release64
+"""
+
+from __future__ import print_function
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+DIR = os.path.dirname(os.path.abspath(__file__))
+REPO = os.path.dirname(os.path.dirname(DIR))
+BENCHMARKS_DIR = os.path.join(REPO, "downward-benchmarks")
+FAST_DOWNWARD = os.path.join(REPO, "fast-downward.py")
+
+TASKS = [
+    ("gripper", "prob07"),
+    ("logistics98", "prob05"),
+    ("rovers", "p10"),
+    ("satellite", "p06-pfile6"),
+    ("satellite", "p10-pfile10"),
+    ("scanalyzer-08-strips", "p10"),
+    ("visitall-opt11-strips", "problem06-half"),
+]
+
+SEARCH_TIME = 20
+CONFIGS = [
+    ("add", "astar(add(), backward_analysis=false, max_time={})"),
+    ("ff", "astar(ff(), backward_analysis=false, max_time={})"),
+    ("hmax", "astar(hmax(), backward_analysis=false, max_time={})"),
+]
+
+PATTERNS = [
+    ("evaluations", r"^Evaluated (\d+) state\(s\)\.$", int),
+    ("search_time", r"^Actual search time: (.+)s \[", float),
+]
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(
+        description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument(
+        "--base-build", required=True,
+        help="build name or path to the directory holding the binaries "
+             "of the baseline")
+    parser.add_argument(
+        "--build", default="release32",
+        help="build name or path to the directory holding the binaries "
+             "to compare against the baseline (default: %(default)s)")
+    parser.add_argument(
+        "--scratch", default="relaxation-heuristic-benchmark-tasks",
+        help="directory for the translated tasks (default: %(default)s)")
+    return parser.parse_args()
+
+
+def get_build_dir(build):
+    if os.path.exists(build):
+        return build
+    build_dir = os.path.join(REPO, "builds", build, "bin")
+    if not os.path.exists(os.path.join(build_dir, "downward")):
+        sys.exit("Could not find build {}. Please run './build.py {}'.".format(
+            build, build))
+    return build_dir
+
+
+def translate(build, domain, problem, scratch):
+    sas_file = os.path.join(scratch, "{}-{}.sas".format(domain, problem))
+    if not os.path.exists(sas_file):
+        domain_dir = os.path.join(BENCHMARKS_DIR, domain)
+        subprocess.check_call(
+            [sys.executable, FAST_DOWNWARD, "--build", build,
+             "--sas-file", sas_file, "--translate",
+             os.path.join(domain_dir, "domain.pddl"),
+             os.path.join(domain_dir, problem + ".pddl")],
+            stdout=open(os.devnull, "w"))
+    return sas_file
+
+
+def run_search(build_dir, sas_file, search):
+    cmd = [os.path.join(build_dir, "downward"),
+           "--internal-plan-file", sas_file + ".plan", "--search", search]
+    with open(sas_file) as input_file:
+        output = subprocess.Popen(
+            cmd, stdin=input_file, stdout=subprocess.PIPE,
+            universal_newlines=True).communicate()[0]
+    run = {}
+    for name, pattern, convert in PATTERNS:
+        match = re.search(pattern, output, re.M)
+        run[name] = convert(match.group(1)) if match else None
+    return run
+
+
+def get_evaluation_rate(run):
+    if not run["evaluations"] or not run["search_time"]:
+        return 0.0
+    return run["evaluations"] / run["search_time"]
+
+
+def main():
+    args = parse_args()
+    base_dir = get_build_dir(args.base_build)
+    build_dir = get_build_dir(args.build)
+    if not os.path.exists(args.scratch):
+        os.makedirs(args.scratch)
+
+    print("{:6} {:45} {:>12} {:>12} {:>7}".format(
+        "config", "task", "base eval/s", "new eval/s", "ratio"))
+    for config, search_template in CONFIGS:
+        search = search_template.format(SEARCH_TIME)
+        ratios = []
+        for domain, problem in TASKS:
+            sas_file = translate(args.build, domain, problem, args.scratch)
+            base_rate = get_evaluation_rate(run_search(base_dir, sas_file, search))
+            new_rate = get_evaluation_rate(run_search(build_dir, sas_file, search))
+            ratio = new_rate / base_rate if base_rate else 0.0
+            ratios.append(ratio)
+            print("{:6} {:45} {:12.0f} {:12.0f} {:7.3f}".format(
+                config, "{}:{}".format(domain, problem), base_rate, new_rate,
+                ratio))
+            sys.stdout.flush()
+
+        product = 1.0
+        for ratio in ratios:
+            product *= ratio
+        print("{:6} geometric mean of evaluation rate ratios: {:.3f}\n".format(
+            config, product ** (1.0 / len(ratios))))
+
+if __name__ == "__main__":
+    main()
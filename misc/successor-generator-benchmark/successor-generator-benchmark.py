@@ -0,0 +1,143 @@
+#! /usr/bin/env python
+
+"""
+Compare the speed of successor generation of two planner builds, e.g.
+a build of the tree-based successor generator and one of the compiled
+GeneratorProgram.
+
+Blind search spends most of its time generating successors, so the
+script runs blind A* with a fixed search time limit on tasks with many
+operators and reports the number of expansions per second of both
+builds, together with the time for building the successor generator.
+
+Usage:
+    misc/successor-generator-benchmark/successor-generator-benchmark.py \\
+        --base-build path/to/base/bin --build release64
+"""
+
+from __future__ import print_function
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+DIR = os.path.dirname(os.path.abspath(__file__))
+REPO = os.path.dirname(os.path.dirname(DIR))
+BENCHMARKS_DIR = os.path.join(REPO, "downward-benchmarks")
+FAST_DOWNWARD = os.path.join(REPO, "fast-downward.py")
+
+TASKS = [
+    ("gripper", "prob07"),
+    ("logistics98", "prob05"),
+    ("rovers", "p10"),
+    ("satellite", "p06-pfile6"),
+    ("satellite", "p10-pfile10"),
+    ("scanalyzer-08-strips", "p10"),
+    ("visitall-opt11-strips", "problem06-half"),
+]
+
+SEARCH_TIME = 20
+SEARCH = "astar(blind(), backward_analysis=false, max_time={})".format(SEARCH_TIME)
+
+PATTERNS = [
+    ("expansions", r"^Expanded (\d+) state\(s\)\.$", int),
+    ("search_time", r"^Actual search time: (.+)s \[", float),
+    ("generator_time", r"^time for successor generation creation: (.+)s$", float),
+]
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(
+        description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument(
+        "--base-build", required=True,
+        help="build name or path to the directory holding the binaries "
+             "of the baseline")
+    parser.add_argument(
+        "--build", default="release32",
+        help="build name or path to the directory holding the binaries "
+             "to compare against the baseline (default: %(default)s)")
+    parser.add_argument(
+        "--scratch", default="successor-generator-benchmark-tasks",
+        help="directory for the translated tasks (default: %(default)s)")
+    return parser.parse_args()
+
+
+def get_build_dir(build):
+    if os.path.exists(build):
+        return build
+    build_dir = os.path.join(REPO, "builds", build, "bin")
+    if not os.path.exists(os.path.join(build_dir, "downward")):
+        sys.exit("Could not find build {}. Please run './build.py {}'.".format(
+            build, build))
+    return build_dir
+
+
+def translate(build, domain, problem, scratch):
+    sas_file = os.path.join(scratch, "{}-{}.sas".format(domain, problem))
+    if not os.path.exists(sas_file):
+        domain_dir = os.path.join(BENCHMARKS_DIR, domain)
+        subprocess.check_call(
+            [sys.executable, FAST_DOWNWARD, "--build", build,
+             "--sas-file", sas_file, "--translate",
+             os.path.join(domain_dir, "domain.pddl"),
+             os.path.join(domain_dir, problem + ".pddl")],
+            stdout=open(os.devnull, "w"))
+    return sas_file
+
+
+def run_search(build_dir, sas_file):
+    cmd = [os.path.join(build_dir, "downward"),
+           "--internal-plan-file", sas_file + ".plan", "--search", SEARCH]
+    with open(sas_file) as input_file:
+        output = subprocess.Popen(
+            cmd, stdin=input_file, stdout=subprocess.PIPE,
+            universal_newlines=True).communicate()[0]
+    run = {}
+    for name, pattern, convert in PATTERNS:
+        match = re.search(pattern, output, re.M)
+        run[name] = convert(match.group(1)) if match else None
+    return run
+
+
+def get_expansion_rate(run):
+    if not run["expansions"] or not run["search_time"]:
+        return 0.0
+    return run["expansions"] / run["search_time"]
+
+
+def main():
+    args = parse_args()
+    base_dir = get_build_dir(args.base_build)
+    build_dir = get_build_dir(args.build)
+    if not os.path.exists(args.scratch):
+        os.makedirs(args.scratch)
+
+    print("{:45} {:>12} {:>12} {:>7} {:>10} {:>10}".format(
+        "task", "base exp/s", "new exp/s", "ratio",
+        "base init", "new init"))
+    ratios = []
+    for domain, problem in TASKS:
+        sas_file = translate(args.build, domain, problem, args.scratch)
+        base_run = run_search(base_dir, sas_file)
+        new_run = run_search(build_dir, sas_file)
+        base_rate = get_expansion_rate(base_run)
+        new_rate = get_expansion_rate(new_run)
+        ratio = new_rate / base_rate if base_rate else 0.0
+        ratios.append(ratio)
+        print("{:45} {:12.0f} {:12.0f} {:7.3f} {:9.4f}s {:9.4f}s".format(
+            "{}:{}".format(domain, problem), base_rate, new_rate, ratio,
+            base_run["generator_time"] or 0, new_run["generator_time"] or 0))
+        sys.stdout.flush()
+
+    product = 1.0
+    for ratio in ratios:
+        product *= ratio
+    print("\nGeometric mean of expansion rate ratios: {:.3f}".format(
+        product ** (1.0 / len(ratios))))
+
+
+if __name__ == "__main__":
+    main()
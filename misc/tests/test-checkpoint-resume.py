@@ -0,0 +1,147 @@
+#! /usr/bin/env python
+
+"""
+Check that a search that is interrupted with SIGTERM and resumed from the
+checkpoint it writes expands the same states and finds the same plan as
+an uninterrupted search, and that the checkpoint cannot be resumed with a
+different evaluator.
+"""
+
+from __future__ import print_function
+
+import argparse
+import os
+import re
+import shutil
+import signal
+import subprocess
+import sys
+import tempfile
+
+DIR = os.path.dirname(os.path.abspath(__file__))
+REPO = os.path.dirname(os.path.dirname(DIR))
+BENCHMARKS_DIR = os.path.join(REPO, "misc", "tests", "benchmarks")
+FAST_DOWNWARD = os.path.join(REPO, "fast-downward.py")
+
+sys.path.insert(0, REPO)
+from driver import returncodes
+
+# FF evaluations are slow on this task, so the search is still running
+# when it receives SIGTERM after its first progress line. (The first
+# "New best heuristic value" line is printed by the initialization.)
+TASK = os.path.join(BENCHMARKS_DIR, "satellite", "p25-HC-pfile5.pddl")
+CONFIG = "eager_greedy([{}()], backward_analysis=false)"
+
+PATTERNS = [
+    ("plan cost", re.compile(r"^Plan cost: (\d+)$", re.M)),
+    ("expansions", re.compile(r"^Expanded (\d+) state\(s\)\.$", re.M)),
+    ("evaluations", re.compile(r"^Evaluated (\d+) state\(s\)\.$", re.M)),
+]
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument(
+        "--build", default="release32",
+        help="build of the planner to test (default: %(default)s)")
+    return parser.parse_args()
+
+
+def search_command(build, heuristic, *options):
+    planner = os.path.join(REPO, "builds", build, "bin", "downward")
+    return [planner, "--search", CONFIG.format(heuristic),
+            "--internal-plan-file", "sas_plan"] + list(options)
+
+
+def run_search(cmd, cwd):
+    print("\nRun {}:".format(cmd))
+    sys.stdout.flush()
+    with open(os.path.join(cwd, "output.sas")) as sas_file:
+        process = subprocess.Popen(
+            cmd, cwd=cwd, stdin=sas_file, stdout=subprocess.PIPE)
+        output = process.communicate()[0].decode("utf-8")
+    return process.returncode, output
+
+
+def get_values(cmd, output):
+    values = {}
+    for name, pattern in PATTERNS:
+        match = pattern.search(output)
+        if not match:
+            sys.exit("Error: output of {} lacks the {}".format(cmd, name))
+        values[name] = int(match.group(1))
+    return values
+
+
+def interrupt_search(cmd, cwd):
+    print("\nRun and interrupt {}:".format(cmd))
+    sys.stdout.flush()
+    with open(os.path.join(cwd, "output.sas")) as sas_file:
+        process = subprocess.Popen(
+            cmd, cwd=cwd, stdin=sas_file, stdout=subprocess.PIPE)
+        lines = []
+        num_progress_lines = 0
+        for line in iter(process.stdout.readline, b""):
+            line = line.decode("utf-8")
+            lines.append(line)
+            if line.startswith("New best heuristic value"):
+                num_progress_lines += 1
+                if num_progress_lines == 2:
+                    process.send_signal(signal.SIGTERM)
+                    break
+        lines.extend(line.decode("utf-8") for line in process.stdout)
+        process.wait()
+    output = "".join(lines)
+    if "Wrote checkpoint #1" not in output:
+        print(output)
+        sys.exit("Error: the search wrote no checkpoint after SIGTERM")
+    if process.returncode != -signal.SIGTERM:
+        sys.exit("Error: the interrupted search exited with {}".format(
+            process.returncode))
+
+
+def main():
+    args = parse_args()
+    # See test-exitcodes.py for why we only build on POSIX systems.
+    if os.name == "posix":
+        subprocess.check_call(["./build.py", args.build], cwd=REPO)
+
+    tmp_dir = tempfile.mkdtemp()
+    try:
+        subprocess.check_call(
+            [sys.executable, FAST_DOWNWARD, "--build", args.build,
+             "--translate", TASK], cwd=tmp_dir)
+
+        cmd = search_command(args.build, "ff")
+        exitcode, output = run_search(cmd, tmp_dir)
+        if exitcode != returncodes.SUCCESS:
+            sys.exit("Error: {} exited with {}".format(cmd, exitcode))
+        uninterrupted = get_values(cmd, output)
+
+        interrupt_search(
+            search_command(args.build, "ff", "--checkpoint-file", "checkpoint"),
+            tmp_dir)
+
+        cmd = search_command(args.build, "add", "--resume", "checkpoint")
+        exitcode, _ = run_search(cmd, tmp_dir)
+        if exitcode != returncodes.SEARCH_INPUT_ERROR:
+            sys.exit("Error: resuming with another evaluator exited with "
+                     "{} instead of {}".format(
+                         exitcode, returncodes.SEARCH_INPUT_ERROR))
+
+        cmd = search_command(args.build, "ff", "--resume", "checkpoint")
+        exitcode, output = run_search(cmd, tmp_dir)
+        if exitcode != returncodes.SUCCESS:
+            sys.exit("Error: {} exited with {}".format(cmd, exitcode))
+        resumed = get_values(cmd, output)
+    finally:
+        shutil.rmtree(tmp_dir)
+
+    if resumed != uninterrupted:
+        sys.exit("Error: {} after resuming, {} without interruption".format(
+            resumed, uninterrupted))
+
+    print("\nNo errors detected.")
+
+
+main()
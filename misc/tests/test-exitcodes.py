@@ -38,6 +38,9 @@ TRANSLATE_TESTS = [
 
 SEARCH_TASKS = {
     "strips": "miconic/s1-0.pddl",
+    # Expanding a state generates several successors, which are evaluated
+    # as a batch.
+    "gripper": "gripper/prob01.pddl",
     "axioms": "philosophers/p01-phil2.pddl",
     "cond-eff": "miconic-simpleadl/s1-0.pddl",
     "large": "satellite/p25-HC-pfile5.pddl",
@@ -70,6 +73,11 @@ SEARCH_TESTS = [
     ("strips", [], "astar(lmcount(lm_hm(), admissible=true))",
         defaultdict(lambda: returncodes.SUCCESS)),
     ("strips", [], MERGE_AND_SHRINK, defaultdict(lambda: returncodes.SUCCESS)),
+    ("gripper", [], "astar(lmcut(), backward_analysis=false, evaluation_threads=2)",
+        defaultdict(lambda: returncodes.SUCCESS)),
+    # The goal count heuristic cannot be copied for other threads.
+    ("gripper", [], "astar(goalcount(), backward_analysis=false, evaluation_threads=2)",
+        defaultdict(lambda: returncodes.SEARCH_UNSUPPORTED)),
     ("axioms", [], "astar(add())", defaultdict(lambda: returncodes.SUCCESS)),
     ("axioms", [], "astar(hm())",
         defaultdict(lambda: returncodes.SEARCH_UNSOLVED_INCOMPLETE)),
@@ -0,0 +1,96 @@
+#! /usr/bin/env python
+
+"""
+Check that eager search expands the same states with and without
+merge_creating_operators if backward analysis is disabled. Merging only
+applies to search with backward analysis, so in particular it must not
+suppress the re-insertion of states that are reached on a cheaper path
+(reopen_closed=true).
+"""
+
+from __future__ import print_function
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+DIR = os.path.dirname(os.path.abspath(__file__))
+REPO = os.path.dirname(os.path.dirname(DIR))
+BENCHMARKS_DIR = os.path.join(REPO, "misc", "tests", "benchmarks")
+FAST_DOWNWARD = os.path.join(REPO, "fast-downward.py")
+
+TASKS = [os.path.join(BENCHMARKS_DIR, path) for path in [
+    "gripper/prob01.pddl",
+    "miconic/s1-0.pddl",
+]]
+
+CONFIGS = [
+    "eager(single(sum([g(), add()])), reopen_closed=true, "
+    "backward_analysis=false, merge_creating_operators={merge})",
+    "eager(tiebreaking([sum([g(), ff()]), ff()]), reopen_closed=true, "
+    "backward_analysis=false, merge_creating_operators={merge})",
+]
+
+PATTERNS = [
+    ("plan cost", re.compile(r"^Plan cost: (\d+)$", re.M)),
+    ("expansions", re.compile(r"^Expanded (\d+) state\(s\)\.$", re.M)),
+    ("reopened", re.compile(r"^Reopened (\d+) state\(s\)\.$", re.M)),
+]
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument(
+        "--build", default="release32",
+        help="build of the planner to test (default: %(default)s)")
+    return parser.parse_args()
+
+
+def run_search(build, task, config):
+    cmd = [sys.executable, FAST_DOWNWARD, "--build", build, task,
+           "--search", config]
+    print("\nRun {}:".format(cmd))
+    sys.stdout.flush()
+    output = subprocess.check_output(cmd).decode("utf-8")
+    values = {}
+    for name, pattern in PATTERNS:
+        match = pattern.search(output)
+        if not match:
+            sys.exit("Error: output of {} lacks the {}".format(cmd, name))
+        values[name] = int(match.group(1))
+    return values
+
+
+def cleanup():
+    subprocess.check_call([sys.executable, FAST_DOWNWARD, "--cleanup"])
+
+
+def main():
+    args = parse_args()
+    # See test-exitcodes.py for why we only build on POSIX systems.
+    if os.name == "posix":
+        subprocess.check_call(["./build.py", args.build], cwd=REPO)
+
+    failures = []
+    for task in TASKS:
+        for config in CONFIGS:
+            results = [
+                run_search(args.build, task, config.format(merge=merge))
+                for merge in ["false", "true"]]
+            cleanup()
+            if results[0] != results[1]:
+                failures.append((task, config, results))
+
+    if failures:
+        print("\nFailures:")
+        for task, config, (without_merging, with_merging) in failures:
+            print("{task}, {config}: {without_merging} without merging, "
+                  "{with_merging} with merging".format(**locals()))
+        sys.exit(1)
+
+    print("\nNo errors detected.")
+
+
+main()
@@ -50,6 +50,7 @@ fast_downward_plugin(
 
         abstract_task
         axioms
+        checkpoint
         evaluation_context
         evaluation_result
         evaluator
@@ -79,7 +80,7 @@ fast_downward_plugin(
         task_id
         task_proxy
 
-    DEPENDS CAUSAL_GRAPH INT_HASH_SET INT_PACKER ORDERED_SET SEGMENTED_VECTOR SUBSCRIBER SUCCESSOR_GENERATOR TASK_PROPERTIES
+    DEPENDS CAUSAL_GRAPH DELTA_ARRAY_VECTOR INT_HASH_SET INT_PACKER MEMORY_ARENA ORDERED_SET SEGMENTED_VECTOR SUBSCRIBER SUCCESSOR_GENERATOR SWISS_HASH_SET TASK_PROPERTIES
     CORE_PLUGIN
 )
 
@@ -121,6 +122,7 @@ fast_downward_plugin(
         utils/system
         utils/system_unix
         utils/system_windows
+        utils/thread_pool
         utils/timer
     CORE_PLUGIN
 )
@@ -231,6 +233,32 @@ fast_downward_plugin(
     DEPENDENCY_ONLY
 )
 
+fast_downward_plugin(
+    NAME MEMORY_ARENA
+    HELP "Arenas and allocator for the segments of segmented vectors"
+    SOURCES
+        algorithms/memory_arena
+    DEPENDENCY_ONLY
+)
+
+fast_downward_plugin(
+    NAME DELTA_ARRAY_VECTOR
+    HELP "Vector of arrays stored as differences to earlier arrays"
+    SOURCES
+        algorithms/delta_array_vector
+    DEPENDS SEGMENTED_VECTOR
+    DEPENDENCY_ONLY
+)
+
+fast_downward_plugin(
+    NAME SWISS_HASH_SET
+    HELP "Hash set storing non-negative integers with SIMD group probing"
+    SOURCES
+        algorithms/swiss_hash_set
+    DEPENDS INT_HASH_SET
+    DEPENDENCY_ONLY
+)
+
 fast_downward_plugin(
     NAME SUBSCRIBER
     HELP "Allows object to subscribe to the destructor of other objects"
@@ -349,7 +377,25 @@ fast_downward_plugin(
     HELP "Eager search algorithm"
     SOURCES
         search_engines/eager_search
-    DEPENDS NULL_PRUNING_METHOD ORDERED_SET SUCCESSOR_GENERATOR
+    DEPENDS FWDBWD_COMMON NULL_PRUNING_METHOD ORDERED_SET SUCCESSOR_GENERATOR
+    DEPENDENCY_ONLY
+)
+
+fast_downward_plugin(
+    NAME FWDBWD_COMMON
+    HELP "Operator dependency analysis for forward search with backward analysis"
+    SOURCES
+        search_engines/fwdbwd_common
+    DEPENDS SUCCESSOR_GENERATOR TASK_PROPERTIES
+    DEPENDENCY_ONLY
+)
+
+fast_downward_plugin(
+    NAME FWDBWD_LAZY_SEARCH
+    HELP "Lazy search algorithm with backward analysis"
+    SOURCES
+        search_engines/fwdbwd_lazy_search
+    DEPENDS FWDBWD_COMMON ORDERED_SET SUCCESSOR_GENERATOR
     DEPENDENCY_ONLY
 )
 
@@ -393,6 +439,14 @@ fast_downward_plugin(
     DEPENDS LAZY_SEARCH SEARCH_COMMON
 )
 
+fast_downward_plugin(
+    NAME PLUGIN_FWDBWD_LAZY_GREEDY
+    HELP "Greedy best-first search with backward analysis and deferred evaluation (lazy)"
+    SOURCES
+        search_engines/plugin_fwdbwd_lazy_greedy
+    DEPENDS FWDBWD_LAZY_SEARCH SEARCH_COMMON
+)
+
 fast_downward_plugin(
     NAME PLUGIN_LAZY_WASTAR
     HELP "Weighted A* search with deferred evaluation (lazy)"
@@ -568,6 +622,8 @@ fast_downward_plugin(
         task_utils/successor_generator
         task_utils/successor_generator_factory
         task_utils/successor_generator_internals
+        task_utils/successor_generator_program
+        task_utils/incremental_successor_generator
     DEPENDS TASK_PROPERTIES
     DEPENDENCY_ONLY
 )
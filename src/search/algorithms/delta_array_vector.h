@@ -0,0 +1,216 @@
+#ifndef ALGORITHMS_DELTA_ARRAY_VECTOR_H
+#define ALGORITHMS_DELTA_ARRAY_VECTOR_H
+
+#include "segmented_vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace delta_array_vector {
+/*
+  Vector of arrays of the same length (like SegmentedArrayVector) that
+  stores an array as the elements in which it differs from an earlier
+  array (its "base") if this takes fewer elements than the array itself.
+  This saves memory if arrays are usually similar to a known earlier
+  array, e.g. successor states to their predecessor.
+
+  A delta consists of the distance to the index of its base, a bitmask
+  of the changed positions (one bit per element of the array) and the
+  new values at the changed positions. All other arrays are stored in
+  full in a SegmentedArrayVector. In addition, each array has a Locator,
+  which is either its index among the full arrays or the start of its
+  delta.
+
+  The base of a delta may itself be a delta. To bound the time for
+  decoding an array, an array is stored in full if its base is already
+  max_depth deltas away from a full array.
+
+  Element and Locator must be unsigned integer types, and Element must
+  not be larger than unsigned int.
+*/
+template<class Element, class Allocator = std::allocator<Element>,
+         class Locator = std::uint32_t>
+class DeltaArrayVector {
+    static_assert(std::is_unsigned<Element>::value && std::is_unsigned<Locator>::value,
+                  "DeltaArrayVector needs unsigned elements and locators.");
+    static_assert(sizeof(Element) <= sizeof(unsigned int),
+                  "DeltaArrayVector elements must fit into unsigned int.");
+
+    typedef typename Allocator::template rebind<Element>::other ElementAllocator;
+    typedef typename Allocator::template rebind<Locator>::other LocatorAllocator;
+
+    static const int BITS_PER_ELEMENT = std::numeric_limits<Element>::digits;
+    // Set in the locator of a delta, whose other bits are the start of the delta.
+    static const Locator DELTA_FLAG =
+        Locator(1) << (std::numeric_limits<Locator>::digits - 1);
+
+    const size_t elements_per_array;
+    // Number of elements of the bitmask of a delta.
+    const size_t mask_size;
+    const int max_depth;
+
+    segmented_vector::SegmentedVector<Locator, LocatorAllocator> locators;
+    segmented_vector::SegmentedArrayVector<Element, ElementAllocator> full_arrays;
+    /*
+      Each delta is the distance to the index of its base, followed by
+      mask_size elements of the bitmask and the values of the changed
+      elements (in the order of their positions).
+    */
+    segmented_vector::SegmentedVector<Element, ElementAllocator> deltas;
+    size_t num_deltas;
+
+    // Scratch space for decode.
+    mutable std::vector<size_t> delta_chain;
+
+    static size_t compute_mask_size(size_t elements_per_array) {
+        return (elements_per_array + BITS_PER_ELEMENT - 1) / BITS_PER_ELEMENT;
+    }
+
+    bool is_delta(size_t index) const {
+        return locators[index] & DELTA_FLAG;
+    }
+
+    size_t get_delta_start(size_t index) const {
+        return locators[index] & ~DELTA_FLAG;
+    }
+
+    size_t get_base_index(size_t index) const {
+        return index - deltas[get_delta_start(index)];
+    }
+
+    // Return the number of deltas from index to the next full array.
+    int get_depth(size_t index) const {
+        int depth = 0;
+        while (is_delta(index)) {
+            index = get_base_index(index);
+            ++depth;
+        }
+        return depth;
+    }
+
+public:
+    DeltaArrayVector(size_t elements_per_array, int max_depth,
+                     const Allocator &allocator = Allocator(),
+                     size_t segment_bytes = 8192)
+        : elements_per_array(elements_per_array),
+          mask_size(compute_mask_size(elements_per_array)),
+          max_depth(max_depth),
+          locators(LocatorAllocator(allocator)),
+          full_arrays(elements_per_array, ElementAllocator(allocator), segment_bytes),
+          deltas(ElementAllocator(allocator)),
+          num_deltas(0) {
+        assert(max_depth >= 0);
+    }
+
+    /*
+      Return true if a delta that changes a single element is smaller
+      than an array with the given number of elements. Otherwise, no
+      array is ever stored as a delta and the locators are wasted.
+    */
+    static bool can_save_memory(size_t elements_per_array) {
+        return 2 + compute_mask_size(elements_per_array) < elements_per_array;
+    }
+
+    size_t size() const {
+        return locators.size();
+    }
+
+    size_t get_num_deltas() const {
+        return num_deltas;
+    }
+
+    // Return the memory used by the locators, full arrays and deltas.
+    size_t get_num_bytes() const {
+        return locators.size() * sizeof(Locator) +
+               (full_arrays.size() * elements_per_array + deltas.size()) * sizeof(Element);
+    }
+
+    /*
+      Append array. base_array must be the array stored at base_index
+      (passed by the caller to avoid decoding it again).
+    */
+    void push_back(const Element *array, size_t base_index, const Element *base_array) {
+        assert(base_index < size());
+        size_t num_changes = 0;
+        for (size_t i = 0; i < elements_per_array; ++i) {
+            if (array[i] != base_array[i])
+                ++num_changes;
+        }
+        size_t distance = size() - base_index;
+        size_t delta_start = deltas.size();
+        if (1 + mask_size + num_changes >= elements_per_array ||
+            distance > std::numeric_limits<Element>::max() ||
+            delta_start >= DELTA_FLAG ||
+            get_depth(base_index) >= max_depth) {
+            push_back(array);
+            return;
+        }
+        locators.push_back(Locator(delta_start) | DELTA_FLAG);
+        deltas.push_back(Element(distance));
+        size_t mask_start = deltas.size();
+        deltas.resize(mask_start + mask_size, 0);
+        for (size_t i = 0; i < elements_per_array; ++i) {
+            if (array[i] != base_array[i]) {
+                deltas[mask_start + i / BITS_PER_ELEMENT] |=
+                    Element(1) << (i % BITS_PER_ELEMENT);
+                deltas.push_back(array[i]);
+            }
+        }
+        ++num_deltas;
+    }
+
+    // Append array without a base.
+    void push_back(const Element *array) {
+        assert(full_arrays.size() < DELTA_FLAG);
+        locators.push_back(Locator(full_arrays.size()));
+        full_arrays.push_back(array);
+    }
+
+    void pop_back() {
+        assert(size() > 0);
+        size_t index = size() - 1;
+        if (is_delta(index)) {
+            deltas.resize(get_delta_start(index));
+            --num_deltas;
+        } else {
+            full_arrays.pop_back();
+        }
+        locators.pop_back();
+    }
+
+    // Write the array stored at index to result.
+    void decode(size_t index, Element *result) const {
+        assert(index < size());
+        // Collect the deltas from index back to the next full array.
+        delta_chain.clear();
+        while (is_delta(index)) {
+            delta_chain.push_back(index);
+            index = get_base_index(index);
+        }
+        const Element *full_array = full_arrays[locators[index]];
+        std::copy(full_array, full_array + elements_per_array, result);
+        // Apply the deltas, starting with the oldest one.
+        for (auto it = delta_chain.rbegin(); it != delta_chain.rend(); ++it) {
+            size_t mask_start = get_delta_start(*it) + 1;
+            size_t value_pos = mask_start + mask_size;
+            for (size_t i = 0; i < mask_size; ++i) {
+                unsigned int mask = deltas[mask_start + i];
+                while (mask) {
+                    int bit = __builtin_ctz(mask);
+                    result[i * BITS_PER_ELEMENT + bit] = deltas[value_pos++];
+                    mask &= mask - 1;
+                }
+            }
+        }
+    }
+};
+
+template<class Element, class Allocator, class Locator>
+const Locator DeltaArrayVector<Element, Allocator, Locator>::DELTA_FLAG;
+}
+
+#endif
@@ -7,6 +7,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <iostream>
 #include <limits>
 #include <utility>
@@ -42,8 +43,12 @@ namespace int_hash_set {
   The maximum capacity (i.e., number of buckets) is 2^30 because we
   use a signed integer to store it, we grow the hash set by doubling
   its capacity, and the next larger power of 2 (2^31) is too big for
-  an int. The maximum capacity could be increased by storing the
-  number of buckets in a larger data type.
+  an int.
+
+  If the planner is compiled with USE_64_BIT_STATE_IDS (see the cmake
+  option of the same name), keys, hashes, bucket indices and counts
+  use 64-bit integers instead. This lifts the limits above at the cost
+  of 16 bytes per bucket, and hashers have to return 64-bit hashes.
 
   Note on hash functions:
 
@@ -68,17 +73,28 @@ namespace int_hash_set {
 
 */
 
+#ifdef USE_64_BIT_STATE_IDS
+using KeyType = std::int64_t;
+using HashType = std::uint64_t;
+
+static_assert(sizeof(KeyType) == 8, "KeyType does not use 8 bytes");
+static_assert(sizeof(HashType) == 8, "HashType does not use 8 bytes");
+#else
 using KeyType = int;
 using HashType = unsigned int;
 
 static_assert(sizeof(KeyType) == 4, "KeyType does not use 4 bytes");
 static_assert(sizeof(HashType) == 4, "HashType does not use 4 bytes");
+#endif
+
+// Signed type for bucket indices and numbers of entries.
+using IndexType = KeyType;
 
 template<typename Hasher, typename Equal>
 class IntHashSet {
     // Max distance from the ideal bucket to the actual bucket for each key.
     static const int MAX_DISTANCE = 32;
-    static const unsigned int MAX_BUCKETS = std::numeric_limits<unsigned int>::max();
+    static const HashType MAX_BUCKETS = std::numeric_limits<HashType>::max();
 
     struct Bucket {
         KeyType key;
@@ -104,16 +120,16 @@ class IntHashSet {
     Hasher hasher;
     Equal equal;
     std::vector<Bucket> buckets;
-    int num_entries;
+    IndexType num_entries;
     int num_resizes;
 
-    int capacity() const {
+    IndexType capacity() const {
         return buckets.size();
     }
 
-    void rehash(int new_capacity) {
+    void rehash(IndexType new_capacity) {
         assert(new_capacity >= 1);
-        int num_entries_before = num_entries;
+        IndexType num_entries_before = num_entries;
         std::vector<Bucket> old_buckets = std::move(buckets);
         assert(buckets.empty());
         num_entries = 0;
@@ -129,7 +145,7 @@ class IntHashSet {
     }
 
     void enlarge() {
-        unsigned int num_buckets = buckets.size();
+        HashType num_buckets = buckets.size();
         // Verify that the number of buckets is a power of 2.
         assert((num_buckets & (num_buckets - 1)) == 0);
         if (num_buckets > MAX_BUCKETS / 2) {
@@ -144,9 +160,9 @@ class IntHashSet {
         rehash(num_buckets * 2);
     }
 
-    int get_bucket(HashType hash) const {
+    IndexType get_bucket(HashType hash) const {
         assert(!buckets.empty());
-        unsigned int num_buckets = buckets.size();
+        HashType num_buckets = buckets.size();
         // Verify that the number of buckets is a power of 2.
         assert((num_buckets & (num_buckets - 1)) == 0);
         /* We want to return hash % num_buckets. The following line does this
@@ -158,7 +174,7 @@ class IntHashSet {
       Return distance from index1 to index2, only moving right and wrapping
       from the last to the first bucket.
     */
-    int get_distance(int index1, int index2) const {
+    IndexType get_distance(IndexType index1, IndexType index2) const {
         assert(utils::in_bounds(index1, buckets));
         assert(utils::in_bounds(index2, buckets));
         if (index2 >= index1) {
@@ -168,7 +184,7 @@ class IntHashSet {
         }
     }
 
-    int find_next_free_bucket_index(int index) const {
+    IndexType find_next_free_bucket_index(IndexType index) const {
         assert(num_entries < capacity());
         assert(utils::in_bounds(index, buckets));
         while (buckets[index].full()) {
@@ -179,9 +195,9 @@ class IntHashSet {
 
     KeyType find_equal_key(KeyType key, HashType hash) const {
         assert(hasher(key) == hash);
-        int ideal_index = get_bucket(hash);
+        IndexType ideal_index = get_bucket(hash);
         for (int i = 0; i < MAX_DISTANCE; ++i) {
-            int index = get_bucket(ideal_index + i);
+            IndexType index = get_bucket(ideal_index + i);
             const Bucket &bucket = buckets[index];
             if (bucket.full() && bucket.hash == hash && equal(bucket.key, key)) {
                 return bucket.key;
@@ -221,10 +237,10 @@ class IntHashSet {
         assert(num_entries < capacity());
 
         // Compute ideal bucket.
-        int ideal_index = get_bucket(hash);
+        IndexType ideal_index = get_bucket(hash);
 
         // Find first free bucket left of the ideal bucket.
-        int free_index = find_next_free_bucket_index(ideal_index);
+        IndexType free_index = find_next_free_bucket_index(ideal_index);
 
         /*
           While the free bucket is too far from the ideal bucket, move the free
@@ -235,15 +251,15 @@ class IntHashSet {
         */
         while (get_distance(ideal_index, free_index) >= MAX_DISTANCE) {
             bool swapped = false;
-            int num_buckets = capacity();
-            int max_offset = std::min(MAX_DISTANCE, num_buckets) - 1;
+            IndexType num_buckets = capacity();
+            int max_offset = std::min<IndexType>(MAX_DISTANCE, num_buckets) - 1;
             for (int offset = max_offset; offset >= 1; --offset) {
                 assert(offset < num_buckets);
-                int candidate_index = free_index + num_buckets - offset;
+                IndexType candidate_index = free_index + num_buckets - offset;
                 assert(candidate_index >= 0);
                 candidate_index = get_bucket(candidate_index);
                 HashType candidate_hash = buckets[candidate_index].hash;
-                int candidate_ideal_index = get_bucket(candidate_hash);
+                IndexType candidate_ideal_index = get_bucket(candidate_hash);
                 if (get_distance(candidate_ideal_index, free_index) < MAX_DISTANCE) {
                     // Candidate can be swapped.
                     std::swap(buckets[candidate_index], buckets[free_index]);
@@ -275,7 +291,7 @@ public:
           num_resizes(0) {
     }
 
-    int size() const {
+    IndexType size() const {
         return num_entries;
     }
 
@@ -291,10 +307,31 @@ public:
         return insert(key, hasher(key));
     }
 
+    /*
+      Like insert(key), but for a key whose hash has already been
+      computed. The hash must be equal to hasher(key).
+    */
+    std::pair<KeyType, bool> insert_with_hash(KeyType key, HashType hash) {
+        assert(key >= 0);
+        return insert(key, hash);
+    }
+
+    /*
+      Hint that a key with the given hash will be inserted soon, so that
+      its ideal bucket can be loaded into the cache in the meantime.
+    */
+    void prefetch(HashType hash) const {
+#ifdef __GNUC__
+        __builtin_prefetch(&buckets[get_bucket(hash)]);
+#else
+        utils::unused_variable(hash);
+#endif
+    }
+
     void dump() const {
-        int num_buckets = capacity();
+        IndexType num_buckets = capacity();
         std::cout << "[";
-        for (int i = 0; i < num_buckets; ++i) {
+        for (IndexType i = 0; i < num_buckets; ++i) {
             const Bucket &bucket = buckets[i];
             if (bucket.full()) {
                 std::cout << bucket.key;
@@ -310,7 +347,7 @@ public:
 
     void print_statistics() const {
         assert(!buckets.empty());
-        int num_buckets = capacity();
+        IndexType num_buckets = capacity();
         assert(num_buckets != 0);
         std::cout << "Int hash set load factor: " << num_entries << "/"
                   << num_buckets << " = "
@@ -324,7 +361,7 @@ template<typename Hasher, typename Equal>
 const int IntHashSet<Hasher, Equal>::MAX_DISTANCE;
 
 template<typename Hasher, typename Equal>
-const unsigned int IntHashSet<Hasher, Equal>::MAX_BUCKETS;
+const HashType IntHashSet<Hasher, Equal>::MAX_BUCKETS;
 }
 
 #endif
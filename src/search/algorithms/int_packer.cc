@@ -1,6 +1,7 @@
 #include "int_packer.h"
 
 #include <cassert>
+#include <memory>
 
 using namespace std;
 
@@ -62,12 +63,106 @@ public:
         Bin &bin = buffer[bin_index];
         bin = (bin & clear_mask) | (value << shift);
     }
+
+    int get_bin_index() const {
+        return bin_index;
+    }
+
+    Bin get_clear_mask() const {
+        return clear_mask;
+    }
+
+    Bin get_value_bits(int value) const {
+        assert(value >= 0 && value < range);
+        return Bin(value) << shift;
+    }
+
+    VariableLayout get_layout() const {
+        return {bin_index, shift, read_mask};
+    }
+};
+
+/*
+  Tracks for each variable how many change sets contain it (its change
+  frequency) and, while a bin is being packed, how many change sets
+  contain both the variable and a variable already in the bin (its
+  affinity to the bin).
+*/
+class IntPacker::ChangeSetInfo {
+    const vector<vector<int>> &change_sets;
+    vector<vector<int>> var_to_change_sets;
+    vector<int> affinity;
+    // Index of the last bin for which a change set was counted.
+    vector<int> change_set_to_bin;
+    vector<int> vars_with_affinity;
+
+    bool is_better(int var, int other_var) const {
+        if (affinity[var] != affinity[other_var])
+            return affinity[var] > affinity[other_var];
+        return var_to_change_sets[var].size() >
+               var_to_change_sets[other_var].size();
+    }
+public:
+    ChangeSetInfo(int num_vars, const vector<vector<int>> &change_sets)
+        : change_sets(change_sets),
+          var_to_change_sets(num_vars),
+          affinity(num_vars, 0),
+          change_set_to_bin(change_sets.size(), -1) {
+        for (size_t set_id = 0; set_id < change_sets.size(); ++set_id) {
+            for (int var : change_sets[set_id]) {
+                assert(var >= 0 && var < num_vars);
+                var_to_change_sets[var].push_back(set_id);
+            }
+        }
+    }
+
+    void start_bin() {
+        for (int var : vars_with_affinity)
+            affinity[var] = 0;
+        vars_with_affinity.clear();
+    }
+
+    void add_var(int var, int bin_index) {
+        for (int set_id : var_to_change_sets[var]) {
+            if (change_set_to_bin[set_id] == bin_index)
+                continue;
+            change_set_to_bin[set_id] = bin_index;
+            for (int other_var : change_sets[set_id]) {
+                if (affinity[other_var] == 0)
+                    vars_with_affinity.push_back(other_var);
+                ++affinity[other_var];
+            }
+        }
+    }
+
+    /*
+      Remove and return the variable with the highest affinity to the
+      current bin, breaking ties in favor of higher change frequency
+      and then in favor of variables closer to the end of vars.
+    */
+    int pop_best_var(vector<int> &vars) const {
+        assert(!vars.empty());
+        int best_pos = vars.size() - 1;
+        for (int pos = best_pos - 1; pos >= 0; --pos) {
+            if (is_better(vars[pos], vars[best_pos]))
+                best_pos = pos;
+        }
+        int var = vars[best_pos];
+        vars.erase(vars.begin() + best_pos);
+        return var;
+    }
 };
 
 
 IntPacker::IntPacker(const vector<int> &ranges)
     : num_bins(0) {
-    pack_bins(ranges);
+    pack_bins(ranges, vector<vector<int>>());
+}
+
+IntPacker::IntPacker(const vector<int> &ranges,
+                     const vector<vector<int>> &change_sets)
+    : num_bins(0) {
+    pack_bins(ranges, change_sets);
 }
 
 IntPacker::~IntPacker() {
@@ -81,7 +176,24 @@ void IntPacker::set(Bin *buffer, int var, int value) const {
     var_infos[var].set(buffer, value);
 }
 
-void IntPacker::pack_bins(const vector<int> &ranges) {
+int IntPacker::get_bin_index(int var) const {
+    return var_infos[var].get_bin_index();
+}
+
+IntPacker::Bin IntPacker::get_clear_mask(int var) const {
+    return var_infos[var].get_clear_mask();
+}
+
+IntPacker::Bin IntPacker::get_value_bits(int var, int value) const {
+    return var_infos[var].get_value_bits(value);
+}
+
+IntPacker::VariableLayout IntPacker::get_variable_layout(int var) const {
+    return var_infos[var].get_layout();
+}
+
+void IntPacker::pack_bins(const vector<int> &ranges,
+                          const vector<vector<int>> &change_sets) {
     assert(var_infos.empty());
 
     int num_vars = ranges.size();
@@ -99,21 +211,29 @@ void IntPacker::pack_bins(const vector<int> &ranges) {
         bits_to_vars[bits].push_back(var);
     }
 
+    unique_ptr<ChangeSetInfo> change_set_info;
+    if (!change_sets.empty())
+        change_set_info.reset(new ChangeSetInfo(num_vars, change_sets));
+
     int packed_vars = 0;
     while (packed_vars != num_vars)
-        packed_vars += pack_one_bin(ranges, bits_to_vars);
+        packed_vars += pack_one_bin(ranges, bits_to_vars, change_set_info.get());
 }
 
 int IntPacker::pack_one_bin(const vector<int> &ranges,
-                            vector<vector<int>> &bits_to_vars) {
+                            vector<vector<int>> &bits_to_vars,
+                            ChangeSetInfo *change_set_info) {
     // Returns the number of variables added to the bin. We pack each
     // bin with a greedy strategy, always adding the largest variable
-    // that still fits.
+    // that still fits. With change sets, ties between variables of the
+    // same size are broken by the change set information.
 
     ++num_bins;
     int bin_index = num_bins - 1;
     int used_bits = 0;
     int num_vars_in_bin = 0;
+    if (change_set_info)
+        change_set_info->start_bin();
 
     while (true) {
         // Determine size of largest variable that still fits into the bin.
@@ -130,8 +250,14 @@ int IntPacker::pack_one_bin(const vector<int> &ranges,
         // We can pack another variable of size bits into the current bin.
         // Remove the variable from bits_to_vars and add it to the bin.
         vector<int> &best_fit_vars = bits_to_vars[bits];
-        int var = best_fit_vars.back();
-        best_fit_vars.pop_back();
+        int var;
+        if (change_set_info) {
+            var = change_set_info->pop_best_var(best_fit_vars);
+            change_set_info->add_var(var, bin_index);
+        } else {
+            var = best_fit_vars.back();
+            best_fit_vars.pop_back();
+        }
 
         var_infos[var] = VariableInfo(ranges[var], bin_index, used_bits);
         used_bits += bits;
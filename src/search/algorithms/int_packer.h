@@ -16,17 +16,28 @@
   Uses a greedy bin-packing strategy to pack the variables, which
   should be close to optimal in most cases. (See code comments for
   details.)
+
+  Optionally, the packer can be given sets of variables that usually
+  change together (e.g., the effect variables of each operator). It
+  then breaks ties in the greedy strategy such that variables from the
+  same sets end up in the same bins and frequently changing variables
+  end up in the first bins. This reduces the number of bins that are
+  touched when a set of variables changes. The number of bins is the
+  same as without change sets.
 */
 namespace int_packer {
 class IntPacker {
     class VariableInfo;
+    class ChangeSetInfo;
 
     std::vector<VariableInfo> var_infos;
     int num_bins;
 
     int pack_one_bin(const std::vector<int> &ranges,
-                     std::vector<std::vector<int>> &bits_to_vars);
-    void pack_bins(const std::vector<int> &ranges);
+                     std::vector<std::vector<int>> &bits_to_vars,
+                     ChangeSetInfo *change_set_info);
+    void pack_bins(const std::vector<int> &ranges,
+                   const std::vector<std::vector<int>> &change_sets);
 public:
     typedef unsigned int Bin;
 
@@ -37,11 +48,43 @@ public:
       a variable can take up at most 31 bits if int is 32-bit.
     */
     explicit IntPacker(const std::vector<int> &ranges);
+    /*
+      Like the constructor above, but co-locate variables that occur
+      together in change_sets. Each change set lists distinct variables.
+    */
+    IntPacker(const std::vector<int> &ranges,
+              const std::vector<std::vector<int>> &change_sets);
     ~IntPacker();
 
     int get(const Bin *buffer, int var) const;
     void set(Bin *buffer, int var, int value) const;
 
+    /*
+      Low-level access for code that precompiles assignments: set(buffer,
+      var, value) is equivalent to
+        bin = (bin & get_clear_mask(var)) | get_value_bits(var, value)
+      for bin = buffer[get_bin_index(var)].
+    */
+    int get_bin_index(int var) const;
+    Bin get_clear_mask(int var) const;
+    Bin get_value_bits(int var, int value) const;
+
+    /*
+      Position of a variable in the buffer. Code that reads values in a
+      tight loop can store the layouts of all variables and inline the
+      access: layout.get(buffer) is equivalent to get(buffer, var).
+    */
+    struct VariableLayout {
+        int bin_index;
+        int shift;
+        Bin read_mask;
+
+        int get(const Bin *buffer) const {
+            return (buffer[bin_index] & read_mask) >> shift;
+        }
+    };
+    VariableLayout get_variable_layout(int var) const;
+
     int get_num_bins() const {return num_bins;}
 };
 }
@@ -0,0 +1,226 @@
+#include "memory_arena.h"
+
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using utils::ExitCode;
+
+namespace memory_arena {
+// Size of the chunks by which the file and the mapping grow.
+static const size_t CHUNK_BYTES = size_t(64) << 20;
+// Alignment of all allocations (one cache line).
+static const size_t ALIGNMENT = 64;
+// Size and alignment of the regions of HugePageArena.
+static const size_t HUGE_PAGE_BYTES = size_t(2) << 20;
+
+static size_t align(size_t num_bytes, size_t alignment = ALIGNMENT) {
+    return (num_bytes + alignment - 1) / alignment * alignment;
+}
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+MappedFileArena::MappedFileArena(size_t resident_budget)
+    : num_hot_chunks(max(resident_budget / CHUNK_BYTES, size_t(1))),
+      file_descriptor(-1),
+      file_size(0),
+      used_bytes_in_last_chunk(0),
+      num_allocated_bytes(0),
+      num_releases(0) {
+    const char *tmp_dir = getenv("TMPDIR");
+    string path = string(tmp_dir ? tmp_dir : "/tmp") + "/downward-states-XXXXXX";
+    vector<char> path_buffer(path.begin(), path.end());
+    path_buffer.push_back('\0');
+    file_descriptor = mkstemp(path_buffer.data());
+    if (file_descriptor == -1) {
+        cerr << "Could not create file for the state pool: "
+             << path << endl;
+        utils::exit_with(ExitCode::SEARCH_CRITICAL_ERROR);
+    }
+    // The file is only accessed through file_descriptor.
+    unlink(path_buffer.data());
+}
+
+MappedFileArena::~MappedFileArena() {
+    for (const Chunk &chunk : chunks)
+        munmap(chunk.start, chunk.size);
+    close(file_descriptor);
+}
+
+void MappedFileArena::add_chunk(size_t min_size) {
+    size_t size = max(CHUNK_BYTES, align(min_size));
+    if (ftruncate(file_descriptor, file_size + size) != 0) {
+        cerr << "Could not grow the file of the state pool." << endl;
+        utils::exit_with(ExitCode::SEARCH_OUT_OF_MEMORY);
+    }
+    void *start = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                       file_descriptor, file_size);
+    if (start == MAP_FAILED) {
+        cerr << "Could not map the file of the state pool." << endl;
+        utils::exit_with(ExitCode::SEARCH_OUT_OF_MEMORY);
+    }
+    file_size += size;
+    chunks.push_back({static_cast<char *>(start), size});
+    used_bytes_in_last_chunk = 0;
+    release_cold_chunks();
+}
+
+void MappedFileArena::release_cold_chunks() {
+    /*
+      Schedule writing back all chunks but the hot ones and drop their
+      pages from the process. For a shared file mapping, MADV_DONTNEED
+      does not lose data: dirty pages stay in the page cache, from
+      where the kernel writes them to the file and evicts them under
+      memory pressure. We repeat this for all cold chunks whenever a
+      chunk is added because cold chunks become resident again when
+      they are accessed.
+    */
+    if (chunks.size() <= num_hot_chunks)
+        return;
+    size_t num_cold_chunks = chunks.size() - num_hot_chunks;
+    for (size_t i = 0; i < num_cold_chunks; ++i) {
+        const Chunk &chunk = chunks[i];
+        msync(chunk.start, chunk.size, MS_ASYNC);
+        madvise(chunk.start, chunk.size, MADV_DONTNEED);
+    }
+    ++num_releases;
+}
+
+void *MappedFileArena::allocate(size_t num_bytes) {
+    num_bytes = align(num_bytes);
+    if (chunks.empty() ||
+        used_bytes_in_last_chunk + num_bytes > chunks.back().size) {
+        add_chunk(num_bytes);
+    }
+    void *result = chunks.back().start + used_bytes_in_last_chunk;
+    used_bytes_in_last_chunk += num_bytes;
+    num_allocated_bytes += num_bytes;
+    return result;
+}
+#else
+MappedFileArena::MappedFileArena(size_t)
+    : num_hot_chunks(0),
+      file_descriptor(-1),
+      file_size(0),
+      used_bytes_in_last_chunk(0),
+      num_allocated_bytes(0),
+      num_releases(0) {
+    cerr << "Memory-mapped state pools are not supported on this "
+         << "operating system." << endl;
+    utils::exit_with(ExitCode::SEARCH_UNSUPPORTED);
+}
+
+MappedFileArena::~MappedFileArena() {
+}
+
+void MappedFileArena::add_chunk(size_t) {
+}
+
+void MappedFileArena::release_cold_chunks() {
+}
+
+void *MappedFileArena::allocate(size_t) {
+    return nullptr;
+}
+#endif
+
+void MappedFileArena::deallocate(void *, size_t) {
+    // Memory is released when the arena is destroyed.
+}
+
+void MappedFileArena::print_statistics() const {
+    cout << "State pool file size: " << file_size << " bytes ("
+         << num_allocated_bytes << " bytes allocated, "
+         << num_releases << " releases of cold chunks)" << endl;
+}
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+HugePageArena::HugePageArena()
+    : used_bytes_in_last_region(0),
+      num_allocated_bytes(0) {
+}
+
+HugePageArena::~HugePageArena() {
+    for (const Region &region : regions)
+        munmap(region.start, region.size);
+}
+
+void HugePageArena::add_region(size_t min_size) {
+    size_t size = align(min_size, HUGE_PAGE_BYTES);
+    /*
+      mmap only guarantees page alignment, so we map an extra huge page
+      and unmap the unaligned parts at both ends.
+    */
+    size_t mapped_size = size + HUGE_PAGE_BYTES;
+    void *mapped = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapped == MAP_FAILED) {
+        cerr << "Could not allocate memory for the state pool." << endl;
+        utils::exit_with(ExitCode::SEARCH_OUT_OF_MEMORY);
+    }
+    char *mapped_start = static_cast<char *>(mapped);
+    char *start = reinterpret_cast<char *>(
+        align(reinterpret_cast<size_t>(mapped_start), HUGE_PAGE_BYTES));
+    size_t head = start - mapped_start;
+    if (head > 0)
+        munmap(mapped_start, head);
+    size_t tail = mapped_size - head - size;
+    if (tail > 0)
+        munmap(start + size, tail);
+#ifdef MADV_HUGEPAGE
+    // Only a hint: without transparent huge pages we get normal pages.
+    madvise(start, size, MADV_HUGEPAGE);
+#endif
+    regions.push_back({start, size});
+    used_bytes_in_last_region = 0;
+}
+
+void *HugePageArena::allocate(size_t num_bytes) {
+    num_bytes = align(num_bytes);
+    if (regions.empty() ||
+        used_bytes_in_last_region + num_bytes > regions.back().size) {
+        add_region(num_bytes);
+    }
+    void *result = regions.back().start + used_bytes_in_last_region;
+    used_bytes_in_last_region += num_bytes;
+    num_allocated_bytes += num_bytes;
+    return result;
+}
+#else
+HugePageArena::HugePageArena()
+    : used_bytes_in_last_region(0),
+      num_allocated_bytes(0) {
+    cerr << "Huge-page state pools are not supported on this "
+         << "operating system." << endl;
+    utils::exit_with(ExitCode::SEARCH_UNSUPPORTED);
+}
+
+HugePageArena::~HugePageArena() {
+}
+
+void HugePageArena::add_region(size_t) {
+}
+
+void *HugePageArena::allocate(size_t) {
+    return nullptr;
+}
+#endif
+
+void HugePageArena::deallocate(void *, size_t) {
+    // Memory is released when the arena is destroyed.
+}
+
+void HugePageArena::print_statistics() const {
+    cout << "State pool huge-page regions: " << regions.size()
+         << " (" << num_allocated_bytes << " bytes allocated)" << endl;
+}
+}
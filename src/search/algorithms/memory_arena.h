@@ -0,0 +1,166 @@
+#ifndef ALGORITHMS_MEMORY_ARENA_H
+#define ALGORITHMS_MEMORY_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+/*
+  Memory arenas provide the memory for the segments of SegmentedVector
+  and SegmentedArrayVector (through ArenaAllocator). These containers
+  only release their segments when they are destroyed, so arenas hand
+  out memory with a simple bump pointer and release everything at once
+  when the arena itself is destroyed.
+
+  MappedFileArena allocates from a memory-mapped temporary file. Dirty
+  pages of a shared file mapping can be written back and evicted by the
+  kernel at any time, so the search is no longer limited by the amount
+  of RAM, only by the size of the disk. To keep the resident set small,
+  the arena asks the kernel to drop the pages of all but the most
+  recently allocated chunks from the process (see release_cold_chunks).
+  Accessing such a page again transparently loads it from the page
+  cache or the file.
+
+  HugePageArena allocates from anonymous 2 MB-aligned regions and asks
+  the kernel to back them with transparent huge pages. Many small
+  segments then share one TLB entry.
+*/
+
+namespace memory_arena {
+class MemoryArena {
+public:
+    virtual ~MemoryArena() = default;
+
+    virtual void *allocate(std::size_t num_bytes) = 0;
+    virtual void deallocate(void *ptr, std::size_t num_bytes) = 0;
+    virtual void print_statistics() const = 0;
+};
+
+
+class MappedFileArena : public MemoryArena {
+    struct Chunk {
+        char *start;
+        std::size_t size;
+    };
+
+    // Number of most recently allocated chunks that stay resident.
+    const std::size_t num_hot_chunks;
+    int file_descriptor;
+    std::size_t file_size;
+    std::vector<Chunk> chunks;
+    std::size_t used_bytes_in_last_chunk;
+    std::size_t num_allocated_bytes;
+    int num_releases;
+
+    void add_chunk(std::size_t min_size);
+    void release_cold_chunks();
+public:
+    /*
+      The file is created in the directory given by the TMPDIR
+      environment variable (default: /tmp) and removed from the file
+      system right away. The directory should be on a local disk (not a
+      tmpfs). resident_budget is the amount of allocated memory (in
+      bytes) that is kept resident.
+    */
+    explicit MappedFileArena(std::size_t resident_budget);
+    virtual ~MappedFileArena() override;
+
+    virtual void *allocate(std::size_t num_bytes) override;
+    virtual void deallocate(void *ptr, std::size_t num_bytes) override;
+    virtual void print_statistics() const override;
+};
+
+
+class HugePageArena : public MemoryArena {
+    struct Region {
+        char *start;
+        std::size_t size;
+    };
+
+    std::vector<Region> regions;
+    std::size_t used_bytes_in_last_region;
+    std::size_t num_allocated_bytes;
+
+    void add_region(std::size_t min_size);
+public:
+    HugePageArena();
+    virtual ~HugePageArena() override;
+
+    virtual void *allocate(std::size_t num_bytes) override;
+    virtual void deallocate(void *ptr, std::size_t num_bytes) override;
+    virtual void print_statistics() const override;
+};
+
+
+/*
+  Allocator that uses the given arena or, if there is none, the global
+  operator new. All copies share ownership of the arena, so the arena
+  lives as long as any container that allocated from it.
+*/
+template<class T>
+class ArenaAllocator {
+    template<class U>
+    friend class ArenaAllocator;
+
+    std::shared_ptr<MemoryArena> arena;
+public:
+    typedef T value_type;
+    typedef T *pointer;
+    typedef const T *const_pointer;
+    typedef T &reference;
+    typedef const T &const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    template<class U>
+    struct rebind {
+        typedef ArenaAllocator<U> other;
+    };
+
+    explicit ArenaAllocator(const std::shared_ptr<MemoryArena> &arena = nullptr)
+        : arena(arena) {
+    }
+
+    template<class U>
+    ArenaAllocator(const ArenaAllocator<U> &other)
+        : arena(other.arena) {
+    }
+
+    T *allocate(std::size_t n) {
+        if (arena)
+            return static_cast<T *>(arena->allocate(n * sizeof(T)));
+        return static_cast<T *>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T *ptr, std::size_t n) {
+        if (arena)
+            arena->deallocate(ptr, n * sizeof(T));
+        else
+            ::operator delete(ptr);
+    }
+
+    template<class U, typename ... Args>
+    void construct(U *ptr, Args && ... args) {
+        ::new(static_cast<void *>(ptr))U(std::forward<Args>(args) ...);
+    }
+
+    template<class U>
+    void destroy(U *ptr) {
+        ptr->~U();
+    }
+
+    template<class U>
+    bool operator==(const ArenaAllocator<U> &other) const {
+        return arena == other.arena;
+    }
+
+    template<class U>
+    bool operator!=(const ArenaAllocator<U> &other) const {
+        return arena != other.arena;
+    }
+};
+}
+
+#endif
@@ -3,6 +3,7 @@
 
 #include "../utils/collections.h"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <queue>
@@ -10,9 +11,11 @@
 #include <vector>
 
 /*
-  We define three priority queue classes here: HeapQueue (heap-based),
-  BucketQueue (bucket-based), and AdaptiveQueue (starts out bucket-based,
-  transforms into heap-based if that seems to make sense).
+  We define five priority queue classes here: HeapQueue (heap-based),
+  BucketQueue (bucket-based), RadixQueue (radix heap for monotone key
+  sequences), AdaptiveQueue (starts out bucket-based, transforms into
+  heap-based if that seems to make sense), and MonotoneQueue (bucket-based
+  or radix heap, chosen at construction).
 
   More precisely, an AdaptiveQueue is converted from a BucketQueue to
   a HeapQueue when the number of required buckets exceeds both
@@ -53,15 +56,6 @@ public:
         */
         return this;
     }
-
-    /* The following method is a bit of a hack to influence the
-       conversion strategy to convert to the heap-based queue less
-       aggressively in the incremental LM-cut configurations. A better
-       solution would be to use a priority queue that is generally
-       more performant, or a better conversion strategy, but both of
-       these would require much more experimentation. */
-
-    virtual void add_virtual_pushes(int num_extra_pushes) = 0;
 };
 
 
@@ -118,9 +112,6 @@ public:
         // Since the entries are sorted, we do not need to heapify.
         return result;
     }
-
-    virtual void add_virtual_pushes(int /*num_extra_pushes*/) {
-    }
 };
 
 
@@ -219,9 +210,96 @@ public:
         }
         return this;
     }
+};
+
+
+/*
+  One-level radix heap. It requires that while the queue is not empty,
+  no key smaller than the key of the last popped entry is pushed, which
+  holds for Dijkstra-like explorations with non-negative costs.
+
+  Entries whose key equals the last popped key are stored in bucket 0,
+  all other entries in bucket i > 0, where i - 1 is the highest bit in
+  which their key differs from the last popped key. When bucket 0 runs
+  empty, the lowest non-empty bucket is distributed to lower buckets.
+  Every entry moves to a lower bucket at most 32 times, so the queue
+  performs well for all key ranges, unlike BucketQueue, which needs a
+  bucket for every key.
+*/
+template<typename Value>
+class RadixQueue : public AbstractQueue<Value> {
+    static const int NUM_BUCKETS = 33;
+
+    typedef typename AbstractQueue<Value>::Entry Entry;
+
+    typedef std::vector<Entry> Bucket;
+    Bucket buckets[NUM_BUCKETS];
+    int last_key;
+    int num_entries;
+
+    int get_bucket_no(int key) const {
+        unsigned int diff = static_cast<unsigned int>(key ^ last_key);
+        if (diff == 0)
+            return 0;
+#ifdef __GNUC__
+        return 32 - __builtin_clz(diff);
+#else
+        int bucket_no = 0;
+        while (diff) {
+            diff >>= 1;
+            ++bucket_no;
+        }
+        return bucket_no;
+#endif
+    }
+
+    void distribute_lowest_bucket() {
+        int bucket_no = 1;
+        while (buckets[bucket_no].empty())
+            ++bucket_no;
+        assert(bucket_no < NUM_BUCKETS);
+        Bucket &bucket = buckets[bucket_no];
+        last_key = bucket[0].first;
+        for (const Entry &entry : bucket)
+            last_key = std::min(last_key, entry.first);
+        for (const Entry &entry : bucket)
+            buckets[get_bucket_no(entry.first)].push_back(entry);
+        bucket.clear();
+    }
+public:
+    RadixQueue() : last_key(0), num_entries(0) {
+    }
+
+    virtual ~RadixQueue() {
+    }
+
+    virtual void push(int key, const Value &value) {
+        assert(key >= 0);
+        assert(key >= last_key);
+        ++num_entries;
+        buckets[get_bucket_no(key)].push_back(std::make_pair(key, value));
+    }
+
+    virtual Entry pop() {
+        assert(num_entries > 0);
+        if (buckets[0].empty())
+            distribute_lowest_bucket();
+        Entry result = buckets[0].back();
+        buckets[0].pop_back();
+        if (--num_entries == 0)
+            last_key = 0;
+        return result;
+    }
+
+    virtual bool empty() const {
+        return num_entries == 0;
+    }
 
-    virtual void add_virtual_pushes(int num_extra_pushes) {
-        num_pushes += num_extra_pushes;
+    virtual void clear() {
+        for (Bucket &bucket : buckets)
+            bucket.clear();
+        last_key = 0;
+        num_entries = 0;
     }
 };
 
@@ -262,9 +340,48 @@ public:
     void clear() {
         wrapped_queue->clear();
     }
+};
+
+
+/*
+  MonotoneQueue has the same requirement as RadixQueue. It uses a
+  BucketQueue if the caller knows that the keys stay small, e.g. h^max
+  costs in tasks with unit costs, and a RadixQueue otherwise. Unlike
+  AdaptiveQueue, it never converts between the two, and its methods do
+  not need virtual calls.
+*/
+template<typename Value>
+class MonotoneQueue {
+    const bool bucket_based;
+    BucketQueue<Value> bucket_queue;
+    RadixQueue<Value> radix_queue;
+public:
+    typedef std::pair<int, Value> Entry;
+
+    explicit MonotoneQueue(bool bucket_based)
+        : bucket_based(bucket_based) {
+    }
+
+    void push(int key, const Value &value) {
+        if (bucket_based)
+            bucket_queue.push(key, value);
+        else
+            radix_queue.push(key, value);
+    }
 
-    void add_virtual_pushes(int num_extra_pushes) {
-        wrapped_queue->add_virtual_pushes(num_extra_pushes);
+    Entry pop() {
+        return bucket_based ? bucket_queue.pop() : radix_queue.pop();
+    }
+
+    bool empty() const {
+        return bucket_based ? bucket_queue.empty() : radix_queue.empty();
+    }
+
+    void clear() {
+        if (bucket_based)
+            bucket_queue.clear();
+        else
+            radix_queue.clear();
     }
 };
 }
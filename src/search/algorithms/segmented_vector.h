@@ -34,7 +34,7 @@
   SegmentedArrayVector is a similar class that can be used for compactly
   storing many fixed-size arrays. It's essentially a variant of SegmentedVector
   where the size of the stored data is only known at runtime, not at compile
-  time.
+  time. Its segment size can also be chosen at runtime.
 */
 
 // TODO: Get rid of the code duplication here. How to do it without
@@ -187,12 +187,17 @@ public:
     }
 
 
-    SegmentedArrayVector(size_t elements_per_array_, const ElementAllocator &allocator_)
-        : element_allocator(allocator_),
-          elements_per_array(elements_per_array_),
+    /*
+      segment_bytes is the size of each segment. Larger segments mean
+      fewer allocations, but more memory overallocation.
+    */
+    SegmentedArrayVector(size_t elements_per_array_, const ElementAllocator &allocator_,
+                         size_t segment_bytes = SEGMENT_BYTES)
+        : elements_per_array(elements_per_array_),
           arrays_per_segment(
-              std::max(SEGMENT_BYTES / (elements_per_array * sizeof(Element)), size_t(1))),
+              std::max(segment_bytes / (elements_per_array * sizeof(Element)), size_t(1))),
           elements_per_segment(elements_per_array * arrays_per_segment),
+          element_allocator(allocator_),
           the_size(0) {
     }
 
@@ -0,0 +1,236 @@
+#ifndef ALGORITHMS_SWISS_HASH_SET_H
+#define ALGORITHMS_SWISS_HASH_SET_H
+
+#include "int_hash_set.h"
+
+#include "../utils/language.h"
+#include "../utils/system.h"
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace swiss_hash_set {
+/*
+  Hash set for storing non-negative integer keys, organized like a
+  "Swiss table" (see https://abseil.io/about/design/swisstables).
+
+  It is a drop-in alternative to int_hash_set::IntHashSet with the same
+  key type and insert() interface, but it expects 64-bit hashes.
+
+  Implementation:
+
+  Buckets are grouped into groups of 16. For each bucket, we store the
+  key and a control byte, which is either EMPTY or the lowest 7 bits
+  of the hash of the key. The remaining bits of the hash select the
+  first group to probe, and the following groups are probed in
+  triangular order. Within a group, all 16 control bytes are compared
+  to the 7-bit hash at once (with SSE2 if available), so the expensive
+  equality test is usually only called for the matching key.
+
+  Since keys are never removed, the first group with an empty bucket
+  ends each probe sequence. The hash set grows by doubling its number
+  of groups once 7/8 of the buckets are full. Hashes are not stored,
+  so they are recomputed for all keys when growing.
+
+  Memory usage is 5 bytes per bucket for 32-bit keys (compared to 8
+  bytes for IntHashSet), but the hasher is called again on growth.
+*/
+
+using KeyType = int_hash_set::KeyType;
+using HashType = std::uint64_t;
+
+template<typename Hasher, typename Equal>
+class SwissHashSet {
+    static const int GROUP_SIZE = 16;
+    using ControlByte = std::int8_t;
+    // The highest bit distinguishes empty buckets from full ones.
+    static const ControlByte EMPTY = -128;
+
+    // Bit i is set iff control byte i of the group matches.
+    using GroupMask = std::uint32_t;
+
+    Hasher hasher;
+    Equal equal;
+    std::vector<ControlByte> control_bytes;
+    std::vector<KeyType> keys;
+    std::size_t num_groups;
+    std::size_t num_entries;
+    int num_resizes;
+
+    static ControlByte get_h2(HashType hash) {
+        return static_cast<ControlByte>(hash & 0x7f);
+    }
+
+    std::size_t get_first_group(HashType hash) const {
+        // Verify that the number of groups is a power of 2.
+        assert((num_groups & (num_groups - 1)) == 0);
+        return (hash >> 7) & (num_groups - 1);
+    }
+
+    GroupMask match(std::size_t group, ControlByte value) const {
+        const ControlByte *group_bytes = &control_bytes[group * GROUP_SIZE];
+#ifdef __SSE2__
+        __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i *>(group_bytes));
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(value), ctrl));
+#else
+        GroupMask mask = 0;
+        for (int i = 0; i < GROUP_SIZE; ++i) {
+            if (group_bytes[i] == value)
+                mask |= GroupMask(1) << i;
+        }
+        return mask;
+#endif
+    }
+
+    static int get_lowest_bit(GroupMask mask) {
+        assert(mask != 0);
+#ifdef __GNUC__
+        return __builtin_ctz(mask);
+#else
+        int bit = 0;
+        while (!(mask & 1)) {
+            mask >>= 1;
+            ++bit;
+        }
+        return bit;
+#endif
+    }
+
+    std::size_t capacity() const {
+        return num_groups * GROUP_SIZE;
+    }
+
+    /*
+      Insert a key that is not contained in the hash set yet into the
+      first group with an empty bucket on its probe sequence.
+    */
+    void insert_new_key(KeyType key, HashType hash) {
+        std::size_t group = get_first_group(hash);
+        for (std::size_t i = 1;; ++i) {
+            GroupMask empty = match(group, EMPTY);
+            if (empty) {
+                std::size_t index = group * GROUP_SIZE + get_lowest_bit(empty);
+                control_bytes[index] = get_h2(hash);
+                keys[index] = key;
+                ++num_entries;
+                return;
+            }
+            group = (group + i) & (num_groups - 1);
+        }
+    }
+
+    void rehash(std::size_t new_num_groups) {
+        std::vector<ControlByte> old_control_bytes = std::move(control_bytes);
+        std::vector<KeyType> old_keys = std::move(keys);
+        num_groups = new_num_groups;
+        num_entries = 0;
+        control_bytes.assign(capacity(), EMPTY);
+        keys.resize(capacity());
+        for (std::size_t i = 0; i < old_keys.size(); ++i) {
+            if (old_control_bytes[i] != EMPTY) {
+                insert_new_key(old_keys[i], hasher(old_keys[i]));
+            }
+        }
+        ++num_resizes;
+    }
+
+public:
+    SwissHashSet(const Hasher &hasher, const Equal &equal)
+        : hasher(hasher),
+          equal(equal),
+          control_bytes(GROUP_SIZE, EMPTY),
+          keys(GROUP_SIZE),
+          num_groups(1),
+          num_entries(0),
+          num_resizes(0) {
+    }
+
+    int_hash_set::IndexType size() const {
+        return num_entries;
+    }
+
+    /*
+      Insert a key into the hash set.
+
+      Return a pair whose first item is the given key, or an equivalent key
+      already contained in the hash set. The second item in the pair is a bool
+      indicating whether a new key was inserted into the hash set.
+    */
+    std::pair<KeyType, bool> insert(KeyType key) {
+        return insert_with_hash(key, hasher(key));
+    }
+
+    /*
+      Like insert(key), but for a key whose hash has already been
+      computed. The hash must be equal to hasher(key).
+    */
+    std::pair<KeyType, bool> insert_with_hash(KeyType key, HashType hash) {
+        assert(key >= 0);
+        assert(hasher(key) == hash);
+        ControlByte h2 = get_h2(hash);
+        std::size_t group = get_first_group(hash);
+        for (std::size_t i = 1;; ++i) {
+            for (GroupMask candidates = match(group, h2); candidates;
+                 candidates &= candidates - 1) {
+                KeyType candidate = keys[group * GROUP_SIZE + get_lowest_bit(candidates)];
+                if (equal(candidate, key)) {
+                    return std::make_pair(candidate, false);
+                }
+            }
+            if (match(group, EMPTY)) {
+                break;
+            }
+            group = (group + i) & (num_groups - 1);
+        }
+
+        if ((num_entries + 1) * 8 > capacity() * 7) {
+            if (num_groups * 2 < num_groups) {
+                std::cerr << "SwissHashSet surpassed maximum capacity. Aborting."
+                          << std::endl;
+                utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+            }
+            rehash(num_groups * 2);
+        }
+        insert_new_key(key, hash);
+        return std::make_pair(key, true);
+    }
+
+    /*
+      Hint that a key with the given hash will be inserted soon, so that
+      the control bytes and keys of its first group can be loaded into
+      the cache in the meantime.
+    */
+    void prefetch(HashType hash) const {
+#ifdef __GNUC__
+        std::size_t index = get_first_group(hash) * GROUP_SIZE;
+        __builtin_prefetch(&control_bytes[index]);
+        __builtin_prefetch(&keys[index]);
+#else
+        utils::unused_variable(hash);
+#endif
+    }
+
+    void print_statistics() const {
+        std::cout << "Swiss hash set load factor: " << num_entries << "/"
+                  << capacity() << " = "
+                  << static_cast<double>(num_entries) / capacity()
+                  << std::endl;
+        std::cout << "Swiss hash set resizes: " << num_resizes << std::endl;
+    }
+};
+
+template<typename Hasher, typename Equal>
+const int SwissHashSet<Hasher, Equal>::GROUP_SIZE;
+
+template<typename Hasher, typename Equal>
+const typename SwissHashSet<Hasher, Equal>::ControlByte SwissHashSet<Hasher, Equal>::EMPTY;
+}
+
+#endif
@@ -0,0 +1,189 @@
+#include "checkpoint.h"
+
+#include "utils/system.h"
+#include "utils/timer.h"
+
+#include <cassert>
+#include <csignal>
+#include <cstdio>
+#include <iostream>
+#include <limits>
+
+using namespace std;
+using utils::ExitCode;
+
+namespace checkpoint {
+static volatile sig_atomic_t termination_requested = 0;
+
+static void request_termination(int) {
+    termination_requested = 1;
+}
+
+
+Writer::Writer(const string &filename)
+    : filename(filename),
+      temporary_filename(filename + ".tmp"),
+      stream(temporary_filename, ios::binary | ios::trunc) {
+    if (!stream) {
+        cerr << "Could not open checkpoint file " << temporary_filename
+             << " for writing." << endl;
+        utils::exit_with(ExitCode::SEARCH_CRITICAL_ERROR);
+    }
+}
+
+void Writer::write(const string &value) {
+    write(value.size());
+    stream.write(value.data(), value.size());
+}
+
+void Writer::write(const pair<StateID, OperatorID> &edge) {
+    write(edge.first);
+    write(edge.second);
+}
+
+void Writer::write(const fwdbwd::FwdbwdNode &node) {
+    write(node.get_state());
+    write(node.get_operator());
+    int stack_node_id = -1;
+    if (node.get_stack_pointer()) {
+        auto it = stack_node_ids.find(node.get_stack_pointer());
+        assert(it != stack_node_ids.end());
+        stack_node_id = it->second;
+    }
+    write(stack_node_id);
+    write(node.get_g());
+    write(node.get_stack_estimate());
+}
+
+void Writer::add_stack_node(const OpStackNode *node) {
+    int id = stack_node_ids.size();
+    stack_node_ids[node] = id;
+}
+
+void Writer::commit() {
+    stream.close();
+    if (!stream || rename(temporary_filename.c_str(), filename.c_str()) != 0) {
+        cerr << "Could not write checkpoint file " << filename << "." << endl;
+        utils::exit_with(ExitCode::SEARCH_CRITICAL_ERROR);
+    }
+}
+
+
+Reader::Reader(const string &filename)
+    : filename(filename),
+      stream(filename, ios::binary) {
+    if (!stream) {
+        cerr << "Could not open checkpoint file " << filename << "." << endl;
+        utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+    }
+}
+
+void Reader::read_bytes(char *buffer, size_t num_bytes) {
+    stream.read(buffer, num_bytes);
+    if (!stream)
+        fail("unexpected end of file");
+}
+
+void Reader::add_stack_node(OpStackNode *node) {
+    stack_nodes.push_back(node);
+}
+
+void Reader::fail(const string &message) const {
+    cerr << "Cannot resume from checkpoint file " << filename << ": "
+         << message << endl;
+    utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+}
+
+template<>
+string Reader::read<string>() {
+    size_t size = read<size_t>();
+    // Strings in checkpoints are short, so a large size indicates another file type.
+    if (size > (1 << 20))
+        fail("not a checkpoint file");
+    string value(size, '\0');
+    read_bytes(&value[0], value.size());
+    return value;
+}
+
+template<>
+pair<StateID, OperatorID> Reader::read<pair<StateID, OperatorID>>() {
+    StateID state_id = read<StateID>();
+    OperatorID op_id = read<OperatorID>();
+    return make_pair(state_id, op_id);
+}
+
+template<>
+fwdbwd::FwdbwdNode Reader::read<fwdbwd::FwdbwdNode>() {
+    StateID state_id = read<StateID>();
+    OperatorID op_id = read<OperatorID>();
+    int stack_node_id = read<int>();
+    int g = read<int>();
+    int stack_estimate = read<int>();
+    OpStackNode *stack_node = nullptr;
+    if (stack_node_id != -1) {
+        if (stack_node_id < 0 || stack_node_id >= static_cast<int>(stack_nodes.size()))
+            fail("invalid operator stack");
+        stack_node = stack_nodes[stack_node_id];
+    }
+    return fwdbwd::FwdbwdNode(state_id, op_id, stack_node, g, stack_estimate);
+}
+
+
+CheckpointManager::CheckpointManager()
+    : checkpoint_interval(numeric_limits<double>::infinity()),
+      last_checkpoint_time(0),
+      num_checkpoints(0) {
+}
+
+void CheckpointManager::set_checkpoint_filename(const string &checkpoint_filename_) {
+    checkpoint_filename = checkpoint_filename_;
+}
+
+void CheckpointManager::set_checkpoint_interval(double checkpoint_interval_) {
+    checkpoint_interval = checkpoint_interval_;
+}
+
+void CheckpointManager::set_resume_filename(const string &resume_filename_) {
+    resume_filename = resume_filename_;
+}
+
+void CheckpointManager::start() {
+    if (!writes_checkpoints())
+        return;
+    last_checkpoint_time = utils::g_timer();
+    /*
+      Replace the handler of utils::register_event_handlers, which exits
+      right away. The search writes the checkpoint after the current
+      step and then calls terminate().
+    */
+    signal(SIGTERM, request_termination);
+}
+
+bool CheckpointManager::is_checkpoint_due() const {
+    if (!writes_checkpoints())
+        return false;
+    if (termination_requested)
+        return true;
+    return checkpoint_interval != numeric_limits<double>::infinity() &&
+           utils::g_timer() - last_checkpoint_time >= checkpoint_interval;
+}
+
+bool CheckpointManager::is_termination_requested() const {
+    return termination_requested;
+}
+
+void CheckpointManager::notify_checkpoint_written() {
+    ++num_checkpoints;
+    last_checkpoint_time = utils::g_timer();
+    cout << "Wrote checkpoint #" << num_checkpoints << " to "
+         << checkpoint_filename << " [t=" << utils::g_timer << "]" << endl;
+}
+
+void CheckpointManager::terminate() const {
+    cout << "caught signal " << SIGTERM << " -- exiting after checkpoint" << endl;
+    signal(SIGTERM, SIG_DFL);
+    raise(SIGTERM);
+    // Only reached if the default action does not terminate the process.
+    utils::exit_after_receiving_signal(ExitCode::SEARCH_UNSOLVED_INCOMPLETE);
+}
+}
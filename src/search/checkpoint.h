@@ -0,0 +1,175 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "operator_id.h"
+
+#include "utils/language.h"
+
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class OpStackNode;
+
+/*
+  Checkpoints save the data of a running search to a binary file, from
+  which a later planner call on the same task with the same search
+  configuration can resume the search.
+
+  A checkpoint contains (in this order) a header identifying the task
+  and the search configuration, the states of the state registry, the
+  search space, the search statistics, the per-state caches of the
+  evaluators and finally the data of the search engine, in particular its open list (see
+  SearchEngine::save_checkpoint). Values are stored in the native byte
+  order and size, so checkpoints can only be read by the same build of
+  the planner on the same kind of machine.
+*/
+namespace checkpoint {
+/*
+  Writes a checkpoint to a temporary file, which replaces the file with
+  the given name only when commit() is called. An interrupted write
+  thus leaves the previous checkpoint intact.
+*/
+class Writer {
+    std::string filename;
+    std::string temporary_filename;
+    std::ofstream stream;
+    // Stack nodes of searches with backward analysis are written as IDs.
+    std::unordered_map<const OpStackNode *, int> stack_node_ids;
+public:
+    explicit Writer(const std::string &filename);
+
+    template<typename T>
+    void write(const T &value) {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "Only trivially copyable values can be written directly.");
+        stream.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    template<typename T>
+    void write_array(const T *values, std::size_t num_values) {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "Only trivially copyable values can be written directly.");
+        stream.write(reinterpret_cast<const char *>(values), num_values * sizeof(T));
+    }
+
+    template<typename T>
+    void write_vector(const std::vector<T> &values) {
+        write(values.size());
+        for (const T &value : values)
+            write(value);
+    }
+
+    void write(const std::string &value);
+    void write(const std::pair<StateID, OperatorID> &edge);
+    void write(const fwdbwd::FwdbwdNode &node);
+
+    // Stack nodes must be added before entries that refer to them are written.
+    void add_stack_node(const OpStackNode *node);
+
+    void commit();
+};
+
+
+class Reader {
+    std::string filename;
+    std::ifstream stream;
+    std::vector<OpStackNode *> stack_nodes;
+
+    void read_bytes(char *buffer, std::size_t num_bytes);
+public:
+    explicit Reader(const std::string &filename);
+
+    template<typename T>
+    T read() {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "Only trivially copyable values can be read directly.");
+        // T need not be default constructible (e.g., StateID).
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type buffer;
+        read_bytes(reinterpret_cast<char *>(&buffer), sizeof(T));
+        return *reinterpret_cast<T *>(&buffer);
+    }
+
+    template<typename T>
+    void read_array(T *values, std::size_t num_values) {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "Only trivially copyable values can be read directly.");
+        read_bytes(reinterpret_cast<char *>(values), num_values * sizeof(T));
+    }
+
+    template<typename T>
+    std::vector<T> read_vector() {
+        std::size_t size = read<std::size_t>();
+        std::vector<T> values;
+        values.reserve(size);
+        for (std::size_t i = 0; i < size; ++i)
+            values.push_back(read<T>());
+        return values;
+    }
+
+    void add_stack_node(OpStackNode *node);
+
+    // Report a checkpoint that does not fit the current planner call and exit.
+    NO_RETURN void fail(const std::string &message) const;
+};
+
+template<>
+std::string Reader::read<std::string>();
+
+template<>
+fwdbwd::FwdbwdNode Reader::read<fwdbwd::FwdbwdNode>();
+
+template<>
+std::pair<StateID, OperatorID> Reader::read<std::pair<StateID, OperatorID>>();
+
+
+/*
+  Decides when the search writes a checkpoint and whether it resumes
+  from one. Like the PlanManager, it is configured from the command line
+  (--checkpoint-file, --checkpoint-interval and --resume) because file
+  names must not be converted to lower case by the option parser.
+*/
+class CheckpointManager {
+    std::string checkpoint_filename;
+    double checkpoint_interval;
+    std::string resume_filename;
+    double last_checkpoint_time;
+    int num_checkpoints;
+public:
+    CheckpointManager();
+
+    void set_checkpoint_filename(const std::string &checkpoint_filename);
+    void set_checkpoint_interval(double checkpoint_interval);
+    void set_resume_filename(const std::string &resume_filename);
+
+    bool writes_checkpoints() const {
+        return !checkpoint_filename.empty();
+    }
+    bool is_resuming() const {
+        return !resume_filename.empty();
+    }
+    const std::string &get_checkpoint_filename() const {
+        return checkpoint_filename;
+    }
+    const std::string &get_resume_filename() const {
+        return resume_filename;
+    }
+
+    /*
+      Install the SIGTERM handler that requests a final checkpoint. Only
+      has an effect if checkpoints are written.
+    */
+    void start();
+    // Return true if the interval has passed or SIGTERM was received.
+    bool is_checkpoint_due() const;
+    bool is_termination_requested() const;
+    void notify_checkpoint_written();
+    // Raise the SIGTERM that was caught by the handler installed in start().
+    NO_RETURN void terminate() const;
+};
+}
+
+#endif
@@ -31,19 +31,49 @@ EvaluationContext::EvaluationContext(
     : EvaluationContext(EvaluatorCache(state), INVALID, false, statistics, calculate_preferred) {
 }
 
+void EvaluationContext::count_evaluation(
+    Evaluator *evaluator, const EvaluationResult &result) {
+    if (statistics &&
+        evaluator->is_used_for_counting_evaluations() &&
+        result.get_count_evaluation()) {
+        statistics->inc_evaluations();
+    }
+}
+
 const EvaluationResult &EvaluationContext::get_result(Evaluator *evaluator) {
     EvaluationResult &result = cache[evaluator];
     if (result.is_uninitialized()) {
         result = evaluator->compute_result(*this);
-        if (statistics &&
-            evaluator->is_used_for_counting_evaluations() &&
-            result.get_count_evaluation()) {
-            statistics->inc_evaluations();
-        }
+        count_evaluation(evaluator, result);
     }
     return result;
 }
 
+void EvaluationContext::evaluate_batch(
+    Evaluator *evaluator, const vector<EvaluationContext *> &eval_contexts,
+    utils::ThreadPool *thread_pool) {
+    vector<EvaluationContext *> missing_contexts;
+    for (EvaluationContext *eval_context : eval_contexts) {
+        if (eval_context->cache[evaluator].is_uninitialized())
+            missing_contexts.push_back(eval_context);
+    }
+    if (missing_contexts.size() <= 1) {
+        for (EvaluationContext *eval_context : missing_contexts)
+            eval_context->get_result(evaluator);
+        return;
+    }
+    vector<EvaluationResult> results;
+    evaluator->compute_results(missing_contexts, results, thread_pool);
+    assert(results.size() == missing_contexts.size());
+    for (size_t i = 0; i < missing_contexts.size(); ++i) {
+        EvaluationContext *eval_context = missing_contexts[i];
+        EvaluationResult &result = eval_context->cache[evaluator];
+        assert(result.is_uninitialized());
+        result = move(results[i]);
+        eval_context->count_evaluation(evaluator, result);
+    }
+}
+
 const EvaluatorCache &EvaluationContext::get_cache() const {
     return cache;
 }
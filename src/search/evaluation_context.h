@@ -6,11 +6,16 @@
 #include "operator_id.h"
 
 #include <unordered_map>
+#include <vector>
 
 class Evaluator;
 class GlobalState;
 class SearchStatistics;
 
+namespace utils {
+class ThreadPool;
+}
+
 /*
   TODO: Now that we have an explicit EvaluationResult class, it's
   perhaps not such a great idea to duplicate all its access methods
@@ -49,6 +54,8 @@ class EvaluationContext {
 
     static const int INVALID = -1;
 
+    void count_evaluation(Evaluator *eval, const EvaluationResult &result);
+
 public:
     /*
       Copy existing heuristic cache and use it to look up heuristic values.
@@ -85,6 +92,15 @@ public:
     ~EvaluationContext() = default;
 
     const EvaluationResult &get_result(Evaluator *eval);
+    /*
+      Compute the results of eval for all given contexts that do not
+      contain them yet with a single call of Evaluator::compute_results
+      and cache them in the contexts. The thread pool (may be null) is
+      passed on to compute_results.
+    */
+    static void evaluate_batch(
+        Evaluator *eval, const std::vector<EvaluationContext *> &eval_contexts,
+        utils::ThreadPool *thread_pool);
     const EvaluatorCache &get_cache() const;
     const GlobalState &get_state() const;
     int get_g_value() const;
@@ -1,13 +1,28 @@
 #include "evaluator.h"
 
+#include "evaluation_context.h"
 #include "plugin.h"
 
 #include "utils/system.h"
 
+#include <algorithm>
 #include <cassert>
 
 using namespace std;
 
+static int num_evaluator_slots = 0;
+static vector<int> free_evaluator_slots;
+
+static int allocate_evaluator_slot() {
+    if (free_evaluator_slots.empty())
+        return num_evaluator_slots++;
+    // Hand out the smallest free slot to keep the used slots small.
+    auto it = min_element(free_evaluator_slots.begin(), free_evaluator_slots.end());
+    int slot = *it;
+    *it = free_evaluator_slots.back();
+    free_evaluator_slots.pop_back();
+    return slot;
+}
 
 Evaluator::Evaluator(const string &description,
                      bool use_for_reporting_minima,
@@ -16,13 +31,27 @@ Evaluator::Evaluator(const string &description,
     : description(description),
       use_for_reporting_minima(use_for_reporting_minima),
       use_for_boosting(use_for_boosting),
-      use_for_counting_evaluations(use_for_counting_evaluations) {
+      use_for_counting_evaluations(use_for_counting_evaluations),
+      slot(allocate_evaluator_slot()) {
+}
+
+Evaluator::~Evaluator() {
+    free_evaluator_slots.push_back(slot);
 }
 
 bool Evaluator::dead_ends_are_reliable() const {
     return true;
 }
 
+void Evaluator::compute_results(
+    const vector<EvaluationContext *> &eval_contexts,
+    vector<EvaluationResult> &results, utils::ThreadPool *) {
+    results.clear();
+    results.reserve(eval_contexts.size());
+    for (EvaluationContext *eval_context : eval_contexts)
+        results.push_back(compute_result(*eval_context));
+}
+
 void Evaluator::report_value_for_initial_state(const EvaluationResult &result) const {
     assert(use_for_reporting_minima);
     cout << "Initial heuristic value for " << description << ": ";
@@ -67,6 +96,15 @@ int Evaluator::get_cached_estimate(const GlobalState &) const {
     ABORT("Called get_cached_estimate when estimate is not cached.");
 }
 
+void Evaluator::get_checkpointed_evaluators(vector<Evaluator *> &) {
+}
+
+void Evaluator::save_checkpoint(checkpoint::Writer &, const StateRegistry &) const {
+}
+
+void Evaluator::load_checkpoint(checkpoint::Reader &, const StateRegistry &) {
+}
+
 static PluginTypePlugin<Evaluator> _type_plugin(
     "Evaluator",
     "An evaluator specification is either a newly created evaluator "
@@ -4,15 +4,32 @@
 #include "evaluation_result.h"
 
 #include <set>
+#include <vector>
 
 class EvaluationContext;
 class GlobalState;
+class StateRegistry;
+
+namespace checkpoint {
+class Reader;
+class Writer;
+}
+
+namespace utils {
+class ThreadPool;
+}
 
 class Evaluator {
     const std::string description;
     const bool use_for_reporting_minima;
     const bool use_for_boosting;
     const bool use_for_counting_evaluations;
+    /*
+      Index of this evaluator among all existing evaluators. Slots of
+      destroyed evaluators are reused, so the slots stay dense and can
+      be used to index evaluation results (see EvaluatorCache).
+    */
+    const int slot;
 
 public:
     Evaluator(
@@ -20,7 +37,8 @@ public:
         bool use_for_reporting_minima = false,
         bool use_for_boosting = false,
         bool use_for_counting_evaluations = false);
-    virtual ~Evaluator() = default;
+    Evaluator(const Evaluator &) = delete;
+    virtual ~Evaluator();
 
     /*
       dead_ends_are_reliable should return true if the evaluator is
@@ -76,6 +94,27 @@ public:
     virtual EvaluationResult compute_result(
         EvaluationContext &eval_context) = 0;
 
+    /*
+      compute_results should compute the results for several evaluation
+      contexts at once and set results[i] to the result for
+      eval_contexts[i]. Like compute_result, it should not add the
+      results to the evaluation contexts; this is done by
+      EvaluationContext::evaluate_batch, which should be the only caller.
+
+      The default implementation calls compute_result for each context.
+      Evaluators that depend on other evaluators should evaluate these
+      with EvaluationContext::evaluate_batch first, so that batches reach
+      evaluators that can share work between states.
+
+      If thread_pool is given, implementations may use its threads to
+      compute the results concurrently. The results must not depend on
+      the number of threads.
+    */
+    virtual void compute_results(
+        const std::vector<EvaluationContext *> &eval_contexts,
+        std::vector<EvaluationResult> &results,
+        utils::ThreadPool *thread_pool);
+
     void report_value_for_initial_state(const EvaluationResult &result) const;
     void report_new_minimum_value(const EvaluationResult &result) const;
 
@@ -83,6 +122,9 @@ public:
     bool is_used_for_reporting_minima() const;
     bool is_used_for_boosting() const;
     bool is_used_for_counting_evaluations() const;
+    int get_slot() const {
+        return slot;
+    }
 
     virtual bool does_cache_estimates() const;
     virtual bool is_estimate_cached(const GlobalState &state) const;
@@ -91,6 +133,23 @@ public:
       the given state is cached, i.e., is_estimate_cached returns true.
     */
     virtual int get_cached_estimate(const GlobalState &state) const;
+
+    /*
+      get_checkpointed_evaluators should append all evaluators that this
+      evaluator directly or indirectly depends on and that store
+      per-state information (such as cached estimates), including itself
+      if necessary. Each evaluator must only be appended once.
+
+      Checkpoints (see checkpoint.h) contain the per-state information
+      of these evaluators, which they write in save_checkpoint and
+      restore in load_checkpoint. The default implementations do
+      nothing.
+    */
+    virtual void get_checkpointed_evaluators(std::vector<Evaluator *> &evals);
+    virtual void save_checkpoint(checkpoint::Writer &writer,
+                                 const StateRegistry &registry) const;
+    virtual void load_checkpoint(checkpoint::Reader &reader,
+                                 const StateRegistry &registry);
 };
 
 #endif
@@ -1,14 +1,50 @@
 #include "evaluator_cache.h"
 
+#include <cassert>
+
 using namespace std;
 
 
 EvaluatorCache::EvaluatorCache(const GlobalState &state)
-    : state(state) {
+    : state(state),
+      used_slots(0) {
+}
+
+EvaluatorCache::EvaluatorCache(const EvaluatorCache &other)
+    : state(other.state),
+      used_slots(0),
+      overflow_results(other.overflow_results) {
+    copy_inline_results(other);
+}
+
+EvaluatorCache &EvaluatorCache::operator=(const EvaluatorCache &other) {
+    if (this != &other) {
+        destroy_inline_results();
+        state = other.state;
+        copy_inline_results(other);
+        overflow_results = other.overflow_results;
+    }
+    return *this;
+}
+
+EvaluatorCache::~EvaluatorCache() {
+    destroy_inline_results();
+}
+
+void EvaluatorCache::copy_inline_results(const EvaluatorCache &other) {
+    assert(used_slots == 0);
+    used_slots = other.used_slots;
+    for (SlotMask mask = used_slots; mask; mask &= mask - 1) {
+        int slot = get_lowest_bit(mask);
+        evaluators[slot] = other.evaluators[slot];
+        new (get_results() + slot) EvaluationResult(other.get_results()[slot]);
+    }
 }
 
-EvaluationResult &EvaluatorCache::operator[](Evaluator *eval) {
-    return eval_results[eval];
+void EvaluatorCache::destroy_inline_results() {
+    for (SlotMask mask = used_slots; mask; mask &= mask - 1)
+        get_results()[get_lowest_bit(mask)].~EvaluationResult();
+    used_slots = 0;
 }
 
 const GlobalState &EvaluatorCache::get_state() const {
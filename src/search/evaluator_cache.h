@@ -2,32 +2,87 @@
 #define EVALUATOR_CACHE_H
 
 #include "evaluation_result.h"
+#include "evaluator.h"
 #include "global_state.h"
 
+#include <cstdint>
+#include <new>
 #include <unordered_map>
 
-class Evaluator;
-
-using EvaluationResults = std::unordered_map<Evaluator *, EvaluationResult>;
-
 /*
   Store a state and evaluation results for this state.
+
+  Results are stored in inline storage indexed by the slot of the
+  evaluator (see Evaluator::get_slot), so that creating, copying and
+  querying a cache neither allocates memory nor hashes. A bit mask marks
+  the slots in use. Only these slots hold constructed results, so that
+  the cost of creating, copying and destroying a cache only depends on
+  the number of evaluators actually used. Evaluators with a slot beyond
+  the inline storage, which only exist if there are many evaluators at
+  the same time, are stored in a hash map.
 */
 class EvaluatorCache {
-    EvaluationResults eval_results;
+    static const int NUM_INLINE_SLOTS = 32;
+    using SlotMask = uint32_t;
+
     GlobalState state;
+    SlotMask used_slots;
+    // Entry i of evaluators and result_storage is only valid if bit i of used_slots is set.
+    Evaluator *evaluators[NUM_INLINE_SLOTS];
+    alignas(EvaluationResult) unsigned char
+    result_storage[NUM_INLINE_SLOTS * sizeof(EvaluationResult)];
+    std::unordered_map<Evaluator *, EvaluationResult> overflow_results;
+
+    EvaluationResult *get_results() {
+        return reinterpret_cast<EvaluationResult *>(result_storage);
+    }
+    const EvaluationResult *get_results() const {
+        return reinterpret_cast<const EvaluationResult *>(result_storage);
+    }
+    static int get_lowest_bit(SlotMask mask) {
+#ifdef __GNUC__
+        return __builtin_ctz(mask);
+#else
+        int bit = 0;
+        while (!(mask & 1)) {
+            mask >>= 1;
+            ++bit;
+        }
+        return bit;
+#endif
+    }
+    void copy_inline_results(const EvaluatorCache &other);
+    void destroy_inline_results();
 
 public:
     explicit EvaluatorCache(const GlobalState &state);
-    ~EvaluatorCache() = default;
+    EvaluatorCache(const EvaluatorCache &other);
+    EvaluatorCache &operator=(const EvaluatorCache &other);
+    ~EvaluatorCache();
 
-    EvaluationResult &operator[](Evaluator *eval);
+    EvaluationResult &operator[](Evaluator *eval) {
+        int slot = eval->get_slot();
+        if (slot >= NUM_INLINE_SLOTS)
+            return overflow_results[eval];
+        EvaluationResult *result = get_results() + slot;
+        SlotMask bit = SlotMask(1) << slot;
+        if (!(used_slots & bit)) {
+            used_slots |= bit;
+            evaluators[slot] = eval;
+            new (result) EvaluationResult();
+        }
+        return *result;
+    }
 
     const GlobalState &get_state() const;
 
     template<class Callback>
     void for_each_evaluator_result(const Callback &callback) const {
-        for (const auto &element : eval_results) {
+        for (SlotMask mask = used_slots; mask; mask &= mask - 1) {
+            int slot = get_lowest_bit(mask);
+            callback(evaluators[slot], get_results()[slot]);
+        }
+        for (const auto &element : overflow_results) {
             const Evaluator *eval = element.first;
             const EvaluationResult &result = element.second;
             callback(eval, result);
@@ -3,6 +3,8 @@
 #include "../evaluation_context.h"
 #include "../evaluation_result.h"
 
+#include <algorithm>
+
 using namespace std;
 
 namespace combining_evaluator {
@@ -45,9 +47,38 @@ EvaluationResult CombiningEvaluator::compute_result(
     return result;
 }
 
+void CombiningEvaluator::compute_results(
+    const vector<EvaluationContext *> &eval_contexts,
+    vector<EvaluationResult> &results, utils::ThreadPool *thread_pool) {
+    /*
+      Evaluate the subevaluators in batches. Like compute_result, only
+      evaluate a subevaluator in contexts where all previous
+      subevaluators are finite.
+    */
+    vector<EvaluationContext *> remaining_contexts(eval_contexts);
+    for (const shared_ptr<Evaluator> &subevaluator : subevaluators) {
+        EvaluationContext::evaluate_batch(
+            subevaluator.get(), remaining_contexts, thread_pool);
+        remaining_contexts.erase(
+            remove_if(remaining_contexts.begin(), remaining_contexts.end(),
+                      [&subevaluator](EvaluationContext *eval_context) {
+                          return eval_context->is_evaluator_value_infinite(
+                              subevaluator.get());
+                      }),
+            remaining_contexts.end());
+    }
+    Evaluator::compute_results(eval_contexts, results, thread_pool);
+}
+
 void CombiningEvaluator::get_path_dependent_evaluators(
     set<Evaluator *> &evals) {
     for (auto &subevaluator : subevaluators)
         subevaluator->get_path_dependent_evaluators(evals);
 }
+
+void CombiningEvaluator::get_checkpointed_evaluators(
+    vector<Evaluator *> &evals) {
+    for (auto &subevaluator : subevaluators)
+        subevaluator->get_checkpointed_evaluators(evals);
+}
 }
@@ -39,9 +39,15 @@ public:
     virtual bool dead_ends_are_reliable() const override;
     virtual EvaluationResult compute_result(
         EvaluationContext &eval_context) override;
+    virtual void compute_results(
+        const std::vector<EvaluationContext *> &eval_contexts,
+        std::vector<EvaluationResult> &results,
+        utils::ThreadPool *thread_pool) override;
 
     virtual void get_path_dependent_evaluators(
         std::set<Evaluator *> &evals) override;
+    virtual void get_checkpointed_evaluators(
+        std::vector<Evaluator *> &evals) override;
 };
 }
 
@@ -40,10 +40,21 @@ EvaluationResult WeightedEvaluator::compute_result(
     return result;
 }
 
+void WeightedEvaluator::compute_results(
+    const vector<EvaluationContext *> &eval_contexts,
+    vector<EvaluationResult> &results, utils::ThreadPool *thread_pool) {
+    EvaluationContext::evaluate_batch(evaluator.get(), eval_contexts, thread_pool);
+    Evaluator::compute_results(eval_contexts, results, thread_pool);
+}
+
 void WeightedEvaluator::get_path_dependent_evaluators(set<Evaluator *> &evals) {
     evaluator->get_path_dependent_evaluators(evals);
 }
 
+void WeightedEvaluator::get_checkpointed_evaluators(vector<Evaluator *> &evals) {
+    evaluator->get_checkpointed_evaluators(evals);
+}
+
 static shared_ptr<Evaluator> _parse(OptionParser &parser) {
     parser.document_synopsis(
         "Weighted evaluator",
@@ -8,16 +8,53 @@
 #include <algorithm>
 #include <iostream>
 #include <cassert>
+#include <new>
 using namespace std;
 
 
+DecodedStateBuffer *DecodedStateBuffer::get_header(const PackedStateBin *data) {
+    return reinterpret_cast<DecodedStateBuffer *>(
+        const_cast<PackedStateBin *>(data)) - 1;
+}
+
+PackedStateBin *DecodedStateBuffer::create(int num_bins) {
+    static_assert(sizeof(DecodedStateBuffer) % alignof(PackedStateBin) == 0,
+                  "State data after the header would be misaligned.");
+    void *memory = ::operator new(
+        sizeof(DecodedStateBuffer) + num_bins * sizeof(PackedStateBin));
+    DecodedStateBuffer *header = new (memory) DecodedStateBuffer;
+    header->num_references = 1;
+    return reinterpret_cast<PackedStateBin *>(header + 1);
+}
+
+void DecodedStateBuffer::add_reference(const PackedStateBin *data) {
+    ++get_header(data)->num_references;
+}
+
+void DecodedStateBuffer::remove_reference(const PackedStateBin *data) {
+    DecodedStateBuffer *header = get_header(data);
+    if (--header->num_references == 0) {
+        header->~DecodedStateBuffer();
+        ::operator delete(header);
+    }
+}
+
+int DecodedStateBuffer::get_num_references(const PackedStateBin *data) {
+    return get_header(data)->num_references;
+}
+
+
 GlobalState::GlobalState(
-    const PackedStateBin *buffer, const StateRegistry &registry, StateID id)
+    const PackedStateBin *buffer, const StateRegistry &registry, StateID id,
+    bool is_decoded)
     : buffer(buffer),
       registry(&registry),
-      id(id) {
+      id(id),
+      is_decoded(is_decoded) {
     assert(buffer);
     assert(id != StateID::no_state);
+    if (is_decoded)
+        DecodedStateBuffer::add_reference(buffer);
 }
 
 int GlobalState::operator[](int var) const {
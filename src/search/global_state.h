@@ -5,11 +5,36 @@
 
 #include "algorithms/int_packer.h"
 
+#include <atomic>
+
 class State;
 class StateRegistry;
 
+namespace successor_generator {
+class SuccessorGenerator;
+}
+
 using PackedStateBin = int_packer::IntPacker::Bin;
 
+/*
+  Buffer into which a StateRegistry that compresses states decodes a
+  state (see StateRegistry::lookup_state). The buffer is shared by the
+  GlobalStates of the state and the cache of the registry, and it is
+  deleted with its last reference. The state data follows a header
+  with the reference count.
+*/
+class DecodedStateBuffer {
+    std::atomic<int> num_references;
+
+    static DecodedStateBuffer *get_header(const PackedStateBin *data);
+public:
+    // Return the data of a new buffer with one reference.
+    static PackedStateBin *create(int num_bins);
+    static void add_reference(const PackedStateBin *data);
+    static void remove_reference(const PackedStateBin *data);
+    static int get_num_references(const PackedStateBin *data);
+};
+
 // For documentation on classes relevant to storing and working with registered
 // states see the file state_registry.h.
 class GlobalState {
@@ -19,6 +44,7 @@ class GlobalState {
     template<typename>
     friend class PerStateArray;
     friend class PerStateBitset;
+    friend class successor_generator::SuccessorGenerator;
 
     // Values for vars are maintained in a packed state and accessed on demand.
     const PackedStateBin *buffer;
@@ -26,10 +52,13 @@ class GlobalState {
     // registry isn't a reference because we want to support operator=
     const StateRegistry *registry;
     StateID id;
+    // True if buffer is a DecodedStateBuffer that this state holds a reference to.
+    bool is_decoded;
 
     // Only used by the state registry.
     GlobalState(
-        const PackedStateBin *buffer, const StateRegistry &registry, StateID id);
+        const PackedStateBin *buffer, const StateRegistry &registry, StateID id,
+        bool is_decoded = false);
 
     const PackedStateBin *get_packed_buffer() const {
         return buffer;
@@ -39,7 +68,52 @@ class GlobalState {
         return *registry;
     }
 public:
-    ~GlobalState() = default;
+    GlobalState(const GlobalState &other)
+        : buffer(other.buffer),
+          registry(other.registry),
+          id(other.id),
+          is_decoded(other.is_decoded) {
+        if (is_decoded)
+            DecodedStateBuffer::add_reference(buffer);
+    }
+
+    GlobalState(GlobalState &&other)
+        : buffer(other.buffer),
+          registry(other.registry),
+          id(other.id),
+          is_decoded(other.is_decoded) {
+        other.is_decoded = false;
+    }
+
+    GlobalState &operator=(const GlobalState &other) {
+        if (other.is_decoded)
+            DecodedStateBuffer::add_reference(other.buffer);
+        if (is_decoded)
+            DecodedStateBuffer::remove_reference(buffer);
+        buffer = other.buffer;
+        registry = other.registry;
+        id = other.id;
+        is_decoded = other.is_decoded;
+        return *this;
+    }
+
+    GlobalState &operator=(GlobalState &&other) {
+        if (this != &other) {
+            if (is_decoded)
+                DecodedStateBuffer::remove_reference(buffer);
+            buffer = other.buffer;
+            registry = other.registry;
+            id = other.id;
+            is_decoded = other.is_decoded;
+            other.is_decoded = false;
+        }
+        return *this;
+    }
+
+    ~GlobalState() {
+        if (is_decoded)
+            DecodedStateBuffer::remove_reference(buffer);
+    }
 
     StateID get_id() const {
         return id;
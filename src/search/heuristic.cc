@@ -8,7 +8,10 @@
 #include "task_utils/task_properties.h"
 #include "tasks/cost_adapted_task.h"
 #include "tasks/root_task.h"
+#include "utils/system.h"
+#include "utils/thread_pool.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <limits>
@@ -23,6 +26,16 @@ Heuristic::Heuristic(const Options &opts)
       task_proxy(*task) {
 }
 
+Heuristic::Heuristic(const Heuristic &other)
+    : Evaluator(other.get_description(), other.is_used_for_reporting_minima(),
+                other.is_used_for_boosting(),
+                other.is_used_for_counting_evaluations()),
+      heuristic_cache(HEntry(NO_VALUE, true)),
+      cache_evaluator_values(other.cache_evaluator_values),
+      task(other.task),
+      task_proxy(*task) {
+}
+
 Heuristic::~Heuristic() {
 }
 
@@ -96,6 +109,116 @@ EvaluationResult Heuristic::compute_result(EvaluationContext &eval_context) {
     return result;
 }
 
+void Heuristic::compute_heuristics(
+    const vector<GlobalState> &states, vector<int> &values) {
+    values.clear();
+    values.reserve(states.size());
+    for (const GlobalState &state : states) {
+        values.push_back(compute_heuristic(state));
+        // Nobody asked for them.
+        preferred_operators.clear();
+    }
+}
+
+shared_ptr<Heuristic> Heuristic::create_thread_local_copy() const {
+    return nullptr;
+}
+
+void Heuristic::create_thread_local_heuristics(int num_copies) {
+    if (static_cast<int>(thread_local_heuristics.size()) >= num_copies)
+        return;
+    cout << "Creating " << num_copies << " thread-local copies of "
+         << get_description() << endl;
+    while (static_cast<int>(thread_local_heuristics.size()) < num_copies) {
+        shared_ptr<Heuristic> copy = create_thread_local_copy();
+        if (!copy) {
+            cerr << get_description() << " does not support evaluation "
+                 << "on several threads." << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+        }
+        thread_local_heuristics.push_back(copy);
+    }
+}
+
+void Heuristic::compute_heuristics_in_parallel(
+    const vector<GlobalState> &states, vector<int> &values,
+    utils::ThreadPool &thread_pool) {
+    int num_states = states.size();
+    int chunk_size = get_batch_chunk_size();
+    int num_chunks = (num_states + chunk_size - 1) / chunk_size;
+    values.assign(num_states, NO_VALUE);
+    thread_pool.for_each(
+        num_chunks,
+        [&](int thread_index, int chunk) {
+            Heuristic *heuristic = thread_index == 0 ?
+                this : thread_local_heuristics[thread_index - 1].get();
+            int begin = chunk * chunk_size;
+            int end = min(begin + chunk_size, num_states);
+            vector<GlobalState> chunk_states(
+                states.begin() + begin, states.begin() + end);
+            vector<int> chunk_values;
+            heuristic->compute_heuristics(chunk_states, chunk_values);
+            assert(static_cast<int>(chunk_values.size()) == end - begin);
+            copy(chunk_values.begin(), chunk_values.end(), values.begin() + begin);
+        });
+}
+
+void Heuristic::compute_results(
+    const vector<EvaluationContext *> &eval_contexts,
+    vector<EvaluationResult> &results, utils::ThreadPool *thread_pool) {
+    bool parallel = thread_pool && thread_pool->get_num_threads() > 1;
+    /*
+      Create the copies with the first batch, so that heuristics that
+      cannot be copied are reported right away.
+    */
+    if (parallel)
+        create_thread_local_heuristics(thread_pool->get_num_threads() - 1);
+    results.clear();
+    results.resize(eval_contexts.size());
+    vector<GlobalState> states;
+    vector<int> state_indices;
+    for (size_t i = 0; i < eval_contexts.size(); ++i) {
+        EvaluationContext &eval_context = *eval_contexts[i];
+        const GlobalState &state = eval_context.get_state();
+        if (eval_context.get_calculate_preferred()) {
+            results[i] = compute_result(eval_context);
+        } else if (cache_evaluator_values &&
+                   heuristic_cache[state].h != NO_VALUE &&
+                   !heuristic_cache[state].dirty) {
+            int heuristic = heuristic_cache[state].h;
+            if (heuristic == DEAD_END)
+                heuristic = EvaluationResult::INFTY;
+            results[i].set_evaluator_value(heuristic);
+            results[i].set_count_evaluation(false);
+        } else {
+            states.push_back(state);
+            state_indices.push_back(i);
+        }
+    }
+    if (states.empty())
+        return;
+
+    vector<int> values;
+    if (parallel && static_cast<int>(states.size()) > get_batch_chunk_size()) {
+        compute_heuristics_in_parallel(states, values, *thread_pool);
+    } else {
+        compute_heuristics(states, values);
+    }
+    assert(values.size() == states.size());
+    assert(preferred_operators.empty());
+    for (size_t j = 0; j < states.size(); ++j) {
+        int heuristic = values[j];
+        assert(heuristic == DEAD_END || heuristic >= 0);
+        if (cache_evaluator_values)
+            heuristic_cache[states[j]] = HEntry(heuristic, false);
+        if (heuristic == DEAD_END)
+            heuristic = EvaluationResult::INFTY;
+        EvaluationResult &result = results[state_indices[j]];
+        result.set_evaluator_value(heuristic);
+        result.set_count_evaluation(true);
+    }
+}
+
 bool Heuristic::does_cache_estimates() const {
     return cache_evaluator_values;
 }
@@ -108,3 +231,18 @@ int Heuristic::get_cached_estimate(const GlobalState &state) const {
     assert(is_estimate_cached(state));
     return heuristic_cache[state].h;
 }
+
+void Heuristic::get_checkpointed_evaluators(vector<Evaluator *> &evals) {
+    if (cache_evaluator_values && find(evals.begin(), evals.end(), this) == evals.end())
+        evals.push_back(this);
+}
+
+void Heuristic::save_checkpoint(
+    checkpoint::Writer &writer, const StateRegistry &registry) const {
+    heuristic_cache.save(writer, registry);
+}
+
+void Heuristic::load_checkpoint(
+    checkpoint::Reader &reader, const StateRegistry &registry) {
+    heuristic_cache.load(reader, registry);
+}
@@ -44,6 +44,18 @@ class Heuristic : public Evaluator {
     */
     ordered_set::OrderedSet<OperatorID> preferred_operators;
 
+    /*
+      Copies of this heuristic for parallel evaluation, one for every
+      thread of the pool except the calling thread, which uses the
+      heuristic itself (see create_thread_local_copy).
+    */
+    std::vector<std::shared_ptr<Heuristic>> thread_local_heuristics;
+
+    void create_thread_local_heuristics(int num_copies);
+    void compute_heuristics_in_parallel(
+        const std::vector<GlobalState> &states, std::vector<int> &values,
+        utils::ThreadPool &thread_pool);
+
 protected:
     /*
       Cache for saving h values
@@ -64,6 +76,26 @@ protected:
     // TODO: Call with State directly once all heuristics support it.
     virtual int compute_heuristic(const GlobalState &state) = 0;
 
+    /*
+      Set values[i] to the heuristic value of states[i]. This is used
+      by compute_results for all states whose value is not cached and
+      for which no preferred operators are needed, so implementations
+      do not need to mark preferred operators. The default
+      implementation calls compute_heuristic for each state.
+    */
+    virtual void compute_heuristics(
+        const std::vector<GlobalState> &states, std::vector<int> &values);
+
+    /*
+      Parallel evaluation splits the states into chunks of this size and
+      passes each chunk to compute_heuristics of one thread. Chunks do
+      not depend on the number of threads, so heuristics that evaluate
+      several states together get the same batches as without threads.
+    */
+    virtual int get_batch_chunk_size() const {
+        return 1;
+    }
+
     /*
       Usage note: Marking the same operator as preferred multiple times
       is OK -- it will only appear once in the list of preferred
@@ -75,6 +107,22 @@ protected:
        heuristics use the TaskProxy class. */
     State convert_global_state(const GlobalState &global_state) const;
 
+    /*
+      Return a copy of this heuristic that computes the same estimates
+      and can evaluate states with compute_heuristics on another thread
+      while this heuristic is used. The copy should share all data that
+      does not change after construction, such as the relaxed task.
+      Heuristics that return nullptr (the default) cannot be used with
+      several evaluation threads.
+    */
+    virtual std::shared_ptr<Heuristic> create_thread_local_copy() const;
+
+    /*
+      Copy the options of other for create_thread_local_copy. The cached
+      estimates are not copied.
+    */
+    explicit Heuristic(const Heuristic &other);
+
 public:
     explicit Heuristic(const options::Options &opts);
     virtual ~Heuristic() override;
@@ -87,10 +135,21 @@ public:
 
     virtual EvaluationResult compute_result(
         EvaluationContext &eval_context) override;
+    virtual void compute_results(
+        const std::vector<EvaluationContext *> &eval_contexts,
+        std::vector<EvaluationResult> &results,
+        utils::ThreadPool *thread_pool) override;
 
     virtual bool does_cache_estimates() const override;
     virtual bool is_estimate_cached(const GlobalState &state) const override;
     virtual int get_cached_estimate(const GlobalState &state) const override;
+
+    // Checkpoints contain the cached estimates (if estimates are cached).
+    virtual void get_checkpointed_evaluators(std::vector<Evaluator *> &evals) override;
+    virtual void save_checkpoint(checkpoint::Writer &writer,
+                                 const StateRegistry &registry) const override;
+    virtual void load_checkpoint(checkpoint::Reader &reader,
+                                 const StateRegistry &registry) override;
 };
 
 #endif
@@ -6,6 +6,7 @@
 
 #include "../task_utils/task_properties.h"
 
+#include <algorithm>
 #include <cassert>
 #include <vector>
 
@@ -15,13 +16,33 @@ namespace additive_heuristic {
 // construction and destruction
 AdditiveHeuristic::AdditiveHeuristic(const Options &opts)
     : RelaxationHeuristic(opts),
-      did_write_overflow_warning(false) {
+      did_write_overflow_warning(false),
+      num_used_lanes(0) {
     cout << "Initializing additive heuristic..." << endl;
+
+    prop_marked.resize(num_propositions, false);
+    lane_costs.resize(num_propositions * NUM_LANES);
+    lane_supporters.resize(num_propositions * NUM_LANES);
+    lane_queue_keys.resize(num_propositions, -1);
+}
+
+AdditiveHeuristic::AdditiveHeuristic(const AdditiveHeuristic &other)
+    : RelaxationHeuristic(other),
+      did_write_overflow_warning(other.did_write_overflow_warning),
+      num_used_lanes(0),
+      lane_costs(num_propositions * NUM_LANES),
+      lane_supporters(num_propositions * NUM_LANES),
+      lane_queue_keys(num_propositions, -1),
+      prop_marked(num_propositions, false) {
 }
 
 AdditiveHeuristic::~AdditiveHeuristic() {
 }
 
+shared_ptr<Heuristic> AdditiveHeuristic::create_thread_local_copy() const {
+    return shared_ptr<AdditiveHeuristic>(new AdditiveHeuristic(*this));
+}
+
 void AdditiveHeuristic::write_overflow_warning() {
     if (!did_write_overflow_warning) {
         // TODO: Should have a planner-wide warning mechanism to handle
@@ -38,69 +59,60 @@ void AdditiveHeuristic::write_overflow_warning() {
 void AdditiveHeuristic::setup_exploration_queue() {
     queue.clear();
 
-    for (size_t var = 0; var < propositions.size(); ++var) {
-        for (size_t value = 0; value < propositions[var].size(); ++value) {
-            Proposition &prop = propositions[var][value];
-            prop.cost = -1;
-            prop.marked = false;
-        }
-    }
+    fill(prop_costs.begin(), prop_costs.end(), -1);
+    op_unsatisfied_preconditions = op_num_preconditions;
+    op_costs = op_base_costs; // will be increased by precondition costs
 
     // Deal with operators and axioms without preconditions.
-    for (size_t i = 0; i < unary_operators.size(); ++i) {
-        UnaryOperator &op = unary_operators[i];
-        op.unsatisfied_preconditions = op.precondition.size();
-        op.cost = op.base_cost; // will be increased by precondition costs
-
-        if (op.unsatisfied_preconditions == 0)
-            enqueue_if_necessary(op.effect, op.base_cost, &op);
-    }
+    for (OpID op : precondition_free_operators)
+        enqueue_if_necessary(op_effects[op], op_base_costs[op], op);
 }
 
 void AdditiveHeuristic::setup_exploration_queue_state(const State &state) {
     for (FactProxy fact : state) {
-        Proposition *init_prop = get_proposition(fact);
-        enqueue_if_necessary(init_prop, 0, 0);
+        PropID init_prop = get_prop_id(fact);
+        enqueue_if_necessary(init_prop, 0, NO_OP);
     }
 }
 
 void AdditiveHeuristic::relaxed_exploration() {
     int unsolved_goals = goal_propositions.size();
     while (!queue.empty()) {
-        pair<int, Proposition *> top_pair = queue.pop();
+        pair<int, PropID> top_pair = queue.pop();
         int distance = top_pair.first;
-        Proposition *prop = top_pair.second;
-        int prop_cost = prop->cost;
+        PropID prop = top_pair.second;
+        int prop_cost = prop_costs[prop];
         assert(prop_cost >= 0);
         assert(prop_cost <= distance);
         if (prop_cost < distance)
             continue;
-        if (prop->is_goal && --unsolved_goals == 0)
+        // Incremental exploration needs the costs of all propositions.
+        if (is_goal[prop] && --unsolved_goals == 0 && !incremental)
             return;
-        const vector<UnaryOperator *> &triggered_operators =
-            prop->precondition_of;
-        for (size_t i = 0; i < triggered_operators.size(); ++i) {
-            UnaryOperator *unary_op = triggered_operators[i];
-            increase_cost(unary_op->cost, prop_cost);
-            --unary_op->unsatisfied_preconditions;
-            assert(unary_op->unsatisfied_preconditions >= 0);
-            if (unary_op->unsatisfied_preconditions == 0)
-                enqueue_if_necessary(unary_op->effect,
-                                     unary_op->cost, unary_op);
+        int end = precondition_of_start[prop + 1];
+        for (int i = precondition_of_start[prop]; i < end; ++i) {
+            OpID unary_op = precondition_of[i];
+            increase_cost(op_costs[unary_op], prop_cost);
+            int &unsatisfied_preconditions = op_unsatisfied_preconditions[unary_op];
+            --unsatisfied_preconditions;
+            assert(unsatisfied_preconditions >= 0);
+            if (unsatisfied_preconditions == 0)
+                enqueue_if_necessary(op_effects[unary_op],
+                                     op_costs[unary_op], unary_op);
         }
     }
 }
 
 void AdditiveHeuristic::mark_preferred_operators(
-    const State &state, Proposition *goal) {
-    if (!goal->marked) { // Only consider each subgoal once.
-        goal->marked = true;
-        UnaryOperator *unary_op = goal->reached_by;
-        if (unary_op) { // We have not yet chained back to a start node.
-            for (size_t i = 0; i < unary_op->precondition.size(); ++i)
-                mark_preferred_operators(state, unary_op->precondition[i]);
-            int operator_no = unary_op->operator_no;
-            if (unary_op->cost == unary_op->base_cost && operator_no != -1) {
+    const State &state, PropID goal) {
+    if (!prop_marked[goal]) { // Only consider each subgoal once.
+        mark_proposition(goal);
+        OpID unary_op = prop_reached_by[goal];
+        if (unary_op != NO_OP) { // We have not yet chained back to a start node.
+            for (int i = precondition_start[unary_op]; i < precondition_start[unary_op + 1]; ++i)
+                mark_preferred_operators(state, preconditions[i]);
+            int operator_no = op_operator_nos[unary_op];
+            if (op_costs[unary_op] == op_base_costs[unary_op] && operator_no != -1) {
                 // Necessary condition for this being a preferred
                 // operator, which we use as a quick test before the
                 // more expensive applicability test.
@@ -114,14 +126,36 @@ void AdditiveHeuristic::mark_preferred_operators(
     }
 }
 
+void AdditiveHeuristic::unmark_propositions() {
+    for (PropID prop : marked_propositions)
+        prop_marked[prop] = false;
+    marked_propositions.clear();
+}
+
+int AdditiveHeuristic::compute_operator_cost(OpID op) {
+    int cost = op_base_costs[op];
+    for (int i = precondition_start[op]; i < precondition_start[op + 1]; ++i) {
+        int pre_cost = prop_costs[preconditions[i]];
+        if (pre_cost == -1)
+            return -1;
+        increase_cost(cost, pre_cost);
+    }
+    return cost;
+}
+
 int AdditiveHeuristic::compute_add_and_ff(const State &state) {
-    setup_exploration_queue();
-    setup_exploration_queue_state(state);
-    relaxed_exploration();
+    unmark_propositions();
+    if (!incremental || !repair_exploration(state)) {
+        setup_exploration_queue();
+        setup_exploration_queue_state(state);
+        relaxed_exploration();
+        if (incremental)
+            set_explored_state(state);
+    }
 
     int total_cost = 0;
     for (size_t i = 0; i < goal_propositions.size(); ++i) {
-        int prop_cost = goal_propositions[i]->cost;
+        int prop_cost = prop_costs[goal_propositions[i]];
         if (prop_cost == -1)
             return DEAD_END;
         increase_cost(total_cost, prop_cost);
@@ -129,6 +163,86 @@ int AdditiveHeuristic::compute_add_and_ff(const State &state) {
     return total_cost;
 }
 
+void AdditiveHeuristic::apply_unary_operator_in_lanes(OpID op) {
+    int costs[NUM_LANES];
+    int base_cost = op_base_costs[op];
+    for (int lane = 0; lane < NUM_LANES; ++lane)
+        costs[lane] = (lane < num_used_lanes) ? base_cost : LANE_INFINITY;
+    for (int i = precondition_start[op]; i < precondition_start[op + 1]; ++i) {
+        const int *pre_costs = &lane_costs[preconditions[i] * NUM_LANES];
+        for (int lane = 0; lane < NUM_LANES; ++lane)
+            costs[lane] = min(costs[lane] + pre_costs[lane], LANE_INFINITY);
+    }
+
+    bool overflow = false;
+    for (int lane = 0; lane < NUM_LANES; ++lane)
+        overflow |= (costs[lane] > MAX_COST_VALUE && costs[lane] < LANE_INFINITY);
+    if (overflow) {
+        write_overflow_warning();
+        for (int lane = 0; lane < NUM_LANES; ++lane) {
+            if (costs[lane] > MAX_COST_VALUE && costs[lane] < LANE_INFINITY)
+                costs[lane] = MAX_COST_VALUE;
+        }
+    }
+
+    PropID effect = op_effects[op];
+    int *effect_costs = &lane_costs[effect * NUM_LANES];
+    OpID *effect_supporters = &lane_supporters[effect * NUM_LANES];
+    int key = LANE_INFINITY;
+    for (int lane = 0; lane < NUM_LANES; ++lane) {
+        if (costs[lane] < effect_costs[lane]) {
+            effect_costs[lane] = costs[lane];
+            effect_supporters[lane] = op;
+            key = min(key, costs[lane]);
+        }
+    }
+    if (key != LANE_INFINITY)
+        enqueue_lane_proposition(effect, key);
+}
+
+void AdditiveHeuristic::compute_add_in_lanes(
+    const vector<State> &states, vector<int> &h_add_values) {
+    num_used_lanes = states.size();
+    assert(num_used_lanes >= 1 && num_used_lanes <= NUM_LANES);
+    fill(lane_costs.begin(), lane_costs.end(), LANE_INFINITY);
+    lane_queue.clear();
+
+    for (int lane = 0; lane < num_used_lanes; ++lane) {
+        for (FactProxy fact : states[lane]) {
+            PropID prop = get_prop_id(fact);
+            lane_costs[prop * NUM_LANES + lane] = 0;
+            lane_supporters[prop * NUM_LANES + lane] = NO_OP;
+            enqueue_lane_proposition(prop, 0);
+        }
+    }
+    for (OpID op : precondition_free_operators)
+        apply_unary_operator_in_lanes(op);
+
+    while (!lane_queue.empty()) {
+        pair<int, PropID> top_pair = lane_queue.pop();
+        int key = top_pair.first;
+        PropID prop = top_pair.second;
+        if (lane_queue_keys[prop] != key)
+            continue;
+        lane_queue_keys[prop] = -1;
+        for (int i = precondition_of_start[prop]; i < precondition_of_start[prop + 1]; ++i)
+            apply_unary_operator_in_lanes(precondition_of[i]);
+    }
+
+    h_add_values.assign(num_used_lanes, 0);
+    for (int lane = 0; lane < num_used_lanes; ++lane) {
+        int &h_add = h_add_values[lane];
+        for (PropID goal : goal_propositions) {
+            int goal_cost = lane_costs[goal * NUM_LANES + lane];
+            if (goal_cost == LANE_INFINITY) {
+                h_add = DEAD_END;
+                break;
+            }
+            increase_cost(h_add, goal_cost);
+        }
+    }
+}
+
 int AdditiveHeuristic::compute_heuristic(const State &state) {
     int h = compute_add_and_ff(state);
     if (h != DEAD_END) {
@@ -142,6 +256,22 @@ int AdditiveHeuristic::compute_heuristic(const GlobalState &global_state) {
     return compute_heuristic(convert_global_state(global_state));
 }
 
+void AdditiveHeuristic::compute_heuristics(
+    const vector<GlobalState> &states, vector<int> &values) {
+    values.clear();
+    values.reserve(states.size());
+    vector<State> lane_states;
+    vector<int> h_add_values;
+    for (size_t start = 0; start < states.size(); start += NUM_LANES) {
+        size_t end = min(states.size(), start + NUM_LANES);
+        lane_states.clear();
+        for (size_t i = start; i < end; ++i)
+            lane_states.push_back(convert_global_state(states[i]));
+        compute_add_in_lanes(lane_states, h_add_values);
+        values.insert(values.end(), h_add_values.begin(), h_add_values.end());
+    }
+}
+
 void AdditiveHeuristic::compute_heuristic_for_cegar(const State &state) {
     compute_heuristic(state);
 }
@@ -160,7 +290,7 @@ static shared_ptr<Heuristic> _parse(OptionParser &parser) {
     parser.document_property("safe", "yes for tasks without axioms");
     parser.document_property("preferred operators", "yes");
 
-    Heuristic::add_options_to_parser(parser);
+    relaxation_heuristic::RelaxationHeuristic::add_options_to_parser(parser);
     Options opts = parser.parse();
     if (parser.dry_run())
         return nullptr;
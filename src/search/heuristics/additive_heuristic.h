@@ -4,15 +4,17 @@
 #include "relaxation_heuristic.h"
 
 #include "../algorithms/priority_queues.h"
-#include "../utils/collections.h"
 
 #include <cassert>
+#include <memory>
+#include <vector>
 
 class State;
 
 namespace additive_heuristic {
-using relaxation_heuristic::Proposition;
-using relaxation_heuristic::UnaryOperator;
+using relaxation_heuristic::PropID;
+using relaxation_heuristic::OpID;
+using relaxation_heuristic::NO_OP;
 
 class AdditiveHeuristic : public relaxation_heuristic::RelaxationHeuristic {
     /* Costs larger than MAX_COST_VALUE are clamped to max_value. The
@@ -24,22 +26,62 @@ class AdditiveHeuristic : public relaxation_heuristic::RelaxationHeuristic {
      */
     static const int MAX_COST_VALUE = 100000000;
 
-    priority_queues::AdaptiveQueue<Proposition *> queue;
+    /*
+      h^add costs can become large even with unit costs, so the
+      exploration always uses a radix heap.
+    */
+    priority_queues::RadixQueue<PropID> queue;
     bool did_write_overflow_warning;
 
+    /*
+      Batch evaluation (see compute_heuristics) explores up to NUM_LANES
+      states at once, one per "lane". Every proposition has one cost per
+      lane, and the costs of a unary operator are computed for all lanes
+      together in loops over the lanes that the compiler turns into SIMD
+      additions and minimums.
+
+      Since the lanes need different processing orders, they are not
+      explored with Dijkstra's algorithm like in relaxed_exploration
+      but with a label-correcting algorithm: a proposition is
+      (re)processed whenever one of its costs decreases, in the order of
+      the smallest decreased cost. This computes the same h^add costs.
+      The best supporter of a proposition in a lane is the unary
+      operator that last decreased its cost, which can differ from
+      relaxed_exploration if several supporters have the same cost.
+    */
+    // Larger than all finite costs, and the sum of two costs does not overflow.
+    static const int LANE_INFINITY = 1 << 29;
+    int num_used_lanes;
+    // Index prop * NUM_LANES + lane. Supporters are NO_OP for facts of the state.
+    std::vector<int> lane_costs;
+    std::vector<OpID> lane_supporters;
+    // Smallest key with which a proposition is in lane_queue (-1 if it is not).
+    std::vector<int> lane_queue_keys;
+    priority_queues::AdaptiveQueue<PropID> lane_queue;
+
+    void enqueue_lane_proposition(PropID prop, int key) {
+        int &queue_key = lane_queue_keys[prop];
+        if (queue_key == -1 || key < queue_key) {
+            queue_key = key;
+            lane_queue.push(key, prop);
+        }
+    }
+    void apply_unary_operator_in_lanes(OpID op);
+
     void setup_exploration_queue();
     void setup_exploration_queue_state(const State &state);
     void relaxed_exploration();
-    void mark_preferred_operators(const State &state, Proposition *goal);
+    void mark_preferred_operators(const State &state, PropID goal);
 
-    void enqueue_if_necessary(Proposition *prop, int cost, UnaryOperator *op) {
+    void enqueue_if_necessary(PropID prop, int cost, OpID op) {
         assert(cost >= 0);
-        if (prop->cost == -1 || prop->cost > cost) {
-            prop->cost = cost;
-            prop->reached_by = op;
+        int &prop_cost = prop_costs[prop];
+        if (prop_cost == -1 || prop_cost > cost) {
+            prop_cost = cost;
+            prop_reached_by[prop] = op;
             queue.push(cost, prop);
         }
-        assert(prop->cost != -1 && prop->cost <= cost);
+        assert(prop_cost != -1 && prop_cost <= cost);
     }
 
     void increase_cost(int &cost, int amount) {
@@ -56,10 +98,45 @@ class AdditiveHeuristic : public relaxation_heuristic::RelaxationHeuristic {
 
     int compute_heuristic(const State &state);
 protected:
+    std::vector<char> prop_marked;
+    // Propositions with prop_marked set, so that the marks can be cleared cheaply.
+    std::vector<PropID> marked_propositions;
+
+    void mark_proposition(PropID prop) {
+        assert(!prop_marked[prop]);
+        prop_marked[prop] = true;
+        marked_propositions.push_back(prop);
+    }
+    void unmark_propositions();
+
     virtual int compute_heuristic(const GlobalState &global_state);
+    virtual int compute_operator_cost(OpID op) override;
 
     // Common part of h^add and h^ff computation.
     int compute_add_and_ff(const State &state);
+
+    static const int NUM_LANES = 8;
+    /*
+      Common part of the batch computation of h^add and h^FF: explore
+      states (at most NUM_LANES) in lanes and set h_add_values[i] to the
+      h^add value of states[i].
+    */
+    void compute_add_in_lanes(
+        const std::vector<State> &states, std::vector<int> &h_add_values);
+    // Best supporter of prop in lane (NO_OP for facts of the state).
+    OpID get_lane_supporter(PropID prop, int lane) const {
+        return lane_supporters[prop * NUM_LANES + lane];
+    }
+
+    virtual void compute_heuristics(
+        const std::vector<GlobalState> &states, std::vector<int> &values) override;
+    virtual int get_batch_chunk_size() const override {
+        return NUM_LANES;
+    }
+
+    // The copy shares the relaxed task with other.
+    explicit AdditiveHeuristic(const AdditiveHeuristic &other);
+    virtual std::shared_ptr<Heuristic> create_thread_local_copy() const override;
 public:
     explicit AdditiveHeuristic(const options::Options &opts);
     ~AdditiveHeuristic();
@@ -73,9 +150,7 @@ public:
     void compute_heuristic_for_cegar(const State &state);
 
     int get_cost_for_cegar(int var, int value) const {
-        assert(utils::in_bounds(var, propositions));
-        assert(utils::in_bounds(value, propositions[var]));
-        return propositions[var][value].cost;
+        return prop_costs[get_prop_id(var, value)];
     }
 };
 }
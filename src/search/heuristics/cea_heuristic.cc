@@ -133,7 +133,7 @@ LocalProblem *ContextEnhancedAdditiveHeuristic::build_problem_for_variable(
     int var_no) const {
     LocalProblem *problem = new LocalProblem;
 
-    DomainTransitionGraph *dtg = transition_graphs[var_no];
+    DomainTransitionGraph *dtg = (*transition_graphs)[var_no];
 
     problem->context_variables = &dtg->local_to_global_child;
 
@@ -416,8 +416,26 @@ ContextEnhancedAdditiveHeuristic::ContextEnhancedAdditiveHeuristic(
     cout << "Initializing context-enhanced additive heuristic..." << endl;
 
     DTGFactory factory(task_proxy, true, [](int, int) {return false;});
-    transition_graphs = factory.build_dtgs();
+    transition_graphs = shared_ptr<vector<DomainTransitionGraph *>>(
+        new vector<DomainTransitionGraph *>(factory.build_dtgs()),
+        [](vector<DomainTransitionGraph *> *dtgs) {
+            for (DomainTransitionGraph *dtg : *dtgs)
+                delete dtg;
+            delete dtgs;
+        });
+
+    initialize_local_problems();
+}
+
+ContextEnhancedAdditiveHeuristic::ContextEnhancedAdditiveHeuristic(
+    const ContextEnhancedAdditiveHeuristic &other)
+    : Heuristic(other),
+      transition_graphs(other.transition_graphs),
+      min_action_cost(other.min_action_cost) {
+    initialize_local_problems();
+}
 
+void ContextEnhancedAdditiveHeuristic::initialize_local_problems() {
     goal_problem = build_problem_for_goal();
     goal_node = &goal_problem->nodes[1];
 
@@ -436,8 +454,11 @@ ContextEnhancedAdditiveHeuristic::~ContextEnhancedAdditiveHeuristic() {
 
     for (LocalProblem *problem : local_problems)
         delete problem;
-    for (DomainTransitionGraph *dtg : transition_graphs)
-        delete dtg;
+}
+
+shared_ptr<Heuristic> ContextEnhancedAdditiveHeuristic::create_thread_local_copy() const {
+    return shared_ptr<ContextEnhancedAdditiveHeuristic>(
+        new ContextEnhancedAdditiveHeuristic(*this));
 }
 
 bool ContextEnhancedAdditiveHeuristic::dead_ends_are_reliable() const {
@@ -7,6 +7,7 @@
 
 #include "../algorithms/priority_queues.h"
 
+#include <memory>
 #include <vector>
 
 class State;
@@ -17,7 +18,9 @@ struct LocalProblemNode;
 struct LocalTransition;
 
 class ContextEnhancedAdditiveHeuristic : public Heuristic {
-    std::vector<domain_transition_graph::DomainTransitionGraph *> transition_graphs;
+    // The DTGs do not change, so thread-local copies share them.
+    std::shared_ptr<const std::vector<domain_transition_graph::DomainTransitionGraph *>>
+    transition_graphs;
     std::vector<LocalProblem *> local_problems;
     std::vector<std::vector<LocalProblem *>> local_problem_index;
     LocalProblem *goal_problem;
@@ -29,6 +32,8 @@ class ContextEnhancedAdditiveHeuristic : public Heuristic {
     LocalProblem *get_local_problem(int var_no, int value);
     LocalProblem *build_problem_for_variable(int var_no) const;
     LocalProblem *build_problem_for_goal() const;
+    // The local problems are built lazily, except for the goal problem.
+    void initialize_local_problems();
 
     int get_priority(LocalProblemNode *node) const;
     void initialize_heap();
@@ -49,6 +54,10 @@ class ContextEnhancedAdditiveHeuristic : public Heuristic {
     // recursing to the same node again.
 protected:
     virtual int compute_heuristic(const GlobalState &global_state);
+
+    explicit ContextEnhancedAdditiveHeuristic(
+        const ContextEnhancedAdditiveHeuristic &other);
+    virtual std::shared_ptr<Heuristic> create_thread_local_copy() const override;
 public:
     explicit ContextEnhancedAdditiveHeuristic(const options::Options &opts);
     ~ContextEnhancedAdditiveHeuristic();
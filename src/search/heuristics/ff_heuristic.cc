@@ -1,11 +1,15 @@
 #include "ff_heuristic.h"
 
+#include "../evaluation_context.h"
+#include "../evaluation_result.h"
 #include "../global_state.h"
 #include "../option_parser.h"
 #include "../plugin.h"
 
 #include "../task_utils/task_properties.h"
+#include "../tasks/root_task.h"
 
+#include <algorithm>
 #include <cassert>
 
 using namespace std;
@@ -14,35 +18,58 @@ namespace ff_heuristic {
 // construction and destruction
 FFHeuristic::FFHeuristic(const Options &opts)
     : AdditiveHeuristic(opts),
-      relaxed_plan(task_proxy.get_operators().size(), false) {
+      relaxed_plan(task_proxy.get_operators().size(), false),
+      cache_preferred_operators(opts.get<bool>("cache_preferred_operators")),
+      preferred_operator_cache(-1),
+      is_current_preferred_operator(
+          cache_preferred_operators ? task_proxy.get_operators().size() : 0, false) {
     cout << "Initializing FF heuristic..." << endl;
 }
 
+FFHeuristic::FFHeuristic(const FFHeuristic &other)
+    : AdditiveHeuristic(other),
+      relaxed_plan(other.relaxed_plan.size(), false),
+      cache_preferred_operators(other.cache_preferred_operators),
+      preferred_operator_cache(-1),
+      is_current_preferred_operator(
+          other.is_current_preferred_operator.size(), false) {
+}
+
 FFHeuristic::~FFHeuristic() {
 }
 
+shared_ptr<Heuristic> FFHeuristic::create_thread_local_copy() const {
+    return shared_ptr<FFHeuristic>(new FFHeuristic(*this));
+}
+
 void FFHeuristic::mark_preferred_operators_and_relaxed_plan(
-    const State &state, Proposition *goal) {
-    if (!goal->marked) { // Only consider each subgoal once.
-        goal->marked = true;
-        UnaryOperator *unary_op = goal->reached_by;
-        if (unary_op) { // We have not yet chained back to a start node.
-            for (size_t i = 0; i < unary_op->precondition.size(); ++i)
+    const State &state, PropID goal) {
+    if (!prop_marked[goal]) { // Only consider each subgoal once.
+        mark_proposition(goal);
+        OpID unary_op = prop_reached_by[goal];
+        if (unary_op != NO_OP) { // We have not yet chained back to a start node.
+            for (int i = precondition_start[unary_op]; i < precondition_start[unary_op + 1]; ++i)
                 mark_preferred_operators_and_relaxed_plan(
-                    state, unary_op->precondition[i]);
-            int operator_no = unary_op->operator_no;
+                    state, preconditions[i]);
+            int operator_no = op_operator_nos[unary_op];
             if (operator_no != -1) {
                 // This is not an axiom.
                 relaxed_plan[operator_no] = true;
 
-                if (unary_op->cost == unary_op->base_cost) {
+                if (op_costs[unary_op] == op_base_costs[unary_op]) {
                     // This test is implied by the next but cheaper,
                     // so we perform it to save work.
                     // If we had no 0-cost operators and axioms to worry
                     // about, it would also imply applicability.
                     OperatorProxy op = task_proxy.get_operators()[operator_no];
-                    if (task_properties::is_applicable(op, state))
+                    if (task_properties::is_applicable(op, state)) {
                         set_preferred(op);
+                        if (cache_preferred_operators &&
+                            !is_current_preferred_operator[operator_no]) {
+                            is_current_preferred_operator[operator_no] = true;
+                            current_preferred_operators.push_back(operator_no);
+                        }
+                    }
                 }
             }
         }
@@ -52,8 +79,11 @@ void FFHeuristic::mark_preferred_operators_and_relaxed_plan(
 int FFHeuristic::compute_heuristic(const GlobalState &global_state) {
     State state = convert_global_state(global_state);
     int h_add = compute_add_and_ff(state);
-    if (h_add == DEAD_END)
+    if (h_add == DEAD_END) {
+        if (cache_preferred_operators)
+            cache_result(global_state, DEAD_END);
         return h_add;
+    }
 
     // Collecting the relaxed plan also sets the preferred operators.
     for (size_t i = 0; i < goal_propositions.size(); ++i)
@@ -66,9 +96,100 @@ int FFHeuristic::compute_heuristic(const GlobalState &global_state) {
             h_ff += task_proxy.get_operators()[op_no].get_cost();
         }
     }
+    if (cache_preferred_operators)
+        cache_result(global_state, h_ff);
     return h_ff;
 }
 
+void FFHeuristic::cache_result(const GlobalState &global_state, int h) {
+    preferred_operator_cache[global_state] = preferred_operator_pool.size();
+    preferred_operator_pool.push_back(h);
+    preferred_operator_pool.push_back(current_preferred_operators.size());
+    OperatorsProxy operators = task_proxy.get_operators();
+    for (int op_no : current_preferred_operators) {
+        OperatorID op_id = operators[op_no].get_ancestor_operator_id(
+            tasks::g_root_task.get());
+        preferred_operator_pool.push_back(op_id.get_index());
+        is_current_preferred_operator[op_no] = false;
+    }
+    current_preferred_operators.clear();
+}
+
+EvaluationResult FFHeuristic::compute_result(EvaluationContext &eval_context) {
+    if (!cache_preferred_operators)
+        return Heuristic::compute_result(eval_context);
+    int pool_index = preferred_operator_cache[eval_context.get_state()];
+    if (pool_index == -1)
+        return Heuristic::compute_result(eval_context);
+
+    EvaluationResult result;
+    int h = preferred_operator_pool[pool_index];
+    if (h == DEAD_END) {
+        result.set_evaluator_value(EvaluationResult::INFTY);
+    } else {
+        result.set_evaluator_value(h);
+        int num_preferred = preferred_operator_pool[pool_index + 1];
+        vector<OperatorID> preferred_operators;
+        preferred_operators.reserve(num_preferred);
+        for (int i = 0; i < num_preferred; ++i)
+            preferred_operators.emplace_back(preferred_operator_pool[pool_index + 2 + i]);
+        result.set_preferred_operators(move(preferred_operators));
+    }
+    result.set_count_evaluation(false);
+    return result;
+}
+
+void FFHeuristic::mark_relaxed_plan_in_lane(PropID goal, int lane) {
+    if (!prop_marked[goal]) {
+        mark_proposition(goal);
+        OpID unary_op = get_lane_supporter(goal, lane);
+        if (unary_op != NO_OP) {
+            for (int i = precondition_start[unary_op]; i < precondition_start[unary_op + 1]; ++i)
+                mark_relaxed_plan_in_lane(preconditions[i], lane);
+            int operator_no = op_operator_nos[unary_op];
+            if (operator_no != -1 && !relaxed_plan[operator_no]) {
+                relaxed_plan[operator_no] = true;
+                relaxed_plan_operators.push_back(operator_no);
+            }
+        }
+    }
+}
+
+void FFHeuristic::compute_heuristics(
+    const vector<GlobalState> &states, vector<int> &values) {
+    values.clear();
+    values.reserve(states.size());
+    // The marks of the last call of compute_heuristic are still set.
+    unmark_propositions();
+
+    OperatorsProxy operators = task_proxy.get_operators();
+    vector<State> lane_states;
+    vector<int> h_add_values;
+    for (size_t start = 0; start < states.size(); start += NUM_LANES) {
+        size_t end = min(states.size(), start + NUM_LANES);
+        lane_states.clear();
+        for (size_t i = start; i < end; ++i)
+            lane_states.push_back(convert_global_state(states[i]));
+        compute_add_in_lanes(lane_states, h_add_values);
+
+        for (size_t lane = 0; lane < lane_states.size(); ++lane) {
+            if (h_add_values[lane] == DEAD_END) {
+                values.push_back(DEAD_END);
+                continue;
+            }
+            for (PropID goal : goal_propositions)
+                mark_relaxed_plan_in_lane(goal, lane);
+            int h_ff = 0;
+            for (int op_no : relaxed_plan_operators) {
+                relaxed_plan[op_no] = false;
+                h_ff += operators[op_no].get_cost();
+            }
+            relaxed_plan_operators.clear();
+            unmark_propositions();
+            values.push_back(h_ff);
+        }
+    }
+}
 
 static shared_ptr<Heuristic> _parse(OptionParser &parser) {
     parser.document_synopsis("FF heuristic", "");
@@ -84,7 +205,19 @@ static shared_ptr<Heuristic> _parse(OptionParser &parser) {
     parser.document_property("safe", "yes for tasks without axioms");
     parser.document_property("preferred operators", "yes");
 
-    Heuristic::add_options_to_parser(parser);
+    relaxation_heuristic::RelaxationHeuristic::add_options_to_parser(parser);
+    parser.add_option<bool>(
+        "cache_preferred_operators",
+        "store the h value and preferred operators of every evaluated "
+        "state, so that evaluating the state again yields its preferred "
+        "operators without recomputing the relaxed plan. Without this "
+        "option, such evaluations take h from the heuristic cache and "
+        "report no preferred operators. In this planner, this happens "
+        "when lazy search reopens a state and when lazy search with "
+        "backward analysis reaches a state again. The stored results are "
+        "never freed, so memory grows with every evaluated state, "
+        "whether or not the search uses preferred operators.",
+        "false");
     Options opts = parser.parse();
     if (parser.dry_run())
         return nullptr;
@@ -3,11 +3,15 @@
 
 #include "additive_heuristic.h"
 
+#include "../per_state_information.h"
+
+#include <memory>
 #include <vector>
 
 namespace ff_heuristic {
-using Proposition = relaxation_heuristic::Proposition;
-using UnaryOperator = relaxation_heuristic::UnaryOperator;
+using relaxation_heuristic::PropID;
+using relaxation_heuristic::OpID;
+using relaxation_heuristic::NO_OP;
 
 /*
   TODO: In a better world, this should not derive from
@@ -22,13 +26,46 @@ class FFHeuristic : public additive_heuristic::AdditiveHeuristic {
     // as a bit vector.
     typedef std::vector<bool> RelaxedPlan;
     RelaxedPlan relaxed_plan;
+    // Used by batch evaluation to clean up after each lane.
+    std::vector<int> relaxed_plan_operators;
+
+    /*
+      With cache_preferred_operators, the result of every state evaluated
+      by compute_heuristic is appended to preferred_operator_pool: the h
+      value, the number of preferred operators and their operator IDs.
+      Later evaluations of the state are answered from the pool, with
+      preferred operators even if the h value alone would have been
+      taken from the heuristic cache. We cannot tell whether the search
+      uses the preferred operators of an evaluation (lazy search reads
+      them without setting calculate_preferred in the evaluation
+      context), so all results are stored. Entries are never removed.
+    */
+    const bool cache_preferred_operators;
+    // Start of the result of the state in preferred_operator_pool (-1 if not evaluated).
+    PerStateInformation<int> preferred_operator_cache;
+    std::vector<int> preferred_operator_pool;
+    // Operator numbers of the preferred operators of the current evaluation.
+    std::vector<int> current_preferred_operators;
+    std::vector<bool> is_current_preferred_operator;
+
     void mark_preferred_operators_and_relaxed_plan(
-        const State &state, Proposition *goal);
+        const State &state, PropID goal);
+    void mark_relaxed_plan_in_lane(PropID goal, int lane);
+    void cache_result(const GlobalState &global_state, int h);
 protected:
     virtual int compute_heuristic(const GlobalState &global_state);
+    virtual void compute_heuristics(
+        const std::vector<GlobalState> &states, std::vector<int> &values) override;
+
+    // The copy shares the relaxed task with other.
+    explicit FFHeuristic(const FFHeuristic &other);
+    virtual std::shared_ptr<Heuristic> create_thread_local_copy() const override;
 public:
     FFHeuristic(const options::Options &opts);
     ~FFHeuristic();
+
+    virtual EvaluationResult compute_result(
+        EvaluationContext &eval_context) override;
 };
 }
 
@@ -20,9 +20,19 @@ LandmarkCutHeuristic::LandmarkCutHeuristic(const Options &opts)
     cout << "Initializing landmark cut heuristic..." << endl;
 }
 
+LandmarkCutHeuristic::LandmarkCutHeuristic(const LandmarkCutHeuristic &other)
+    : Heuristic(other),
+      landmark_generator(utils::make_unique_ptr<LandmarkCutLandmarks>(
+                             *other.landmark_generator)) {
+}
+
 LandmarkCutHeuristic::~LandmarkCutHeuristic() {
 }
 
+shared_ptr<Heuristic> LandmarkCutHeuristic::create_thread_local_copy() const {
+    return shared_ptr<LandmarkCutHeuristic>(new LandmarkCutHeuristic(*this));
+}
+
 int LandmarkCutHeuristic::compute_heuristic(const GlobalState &global_state) {
     State state = convert_global_state(global_state);
     return compute_heuristic(state);
@@ -19,6 +19,10 @@ class LandmarkCutHeuristic : public Heuristic {
 
     virtual int compute_heuristic(const GlobalState &global_state) override;
     int compute_heuristic(const State &state);
+protected:
+    // The copy shares the relaxed task with other.
+    explicit LandmarkCutHeuristic(const LandmarkCutHeuristic &other);
+    virtual std::shared_ptr<Heuristic> create_thread_local_copy() const override;
 public:
     explicit LandmarkCutHeuristic(const options::Options &opts);
     virtual ~LandmarkCutHeuristic() override;
@@ -9,24 +9,104 @@
 using namespace std;
 
 namespace lm_cut_heuristic {
+namespace {
+/*
+  Invert the propositions of the operators (in compressed sparse row
+  format) into the operators of the propositions, sorted by ID.
+*/
+void build_index(const vector<int> &props, const vector<int> &op_start,
+                 int num_props, vector<int> &prop_start, vector<int> &ops) {
+    prop_start.assign(num_props + 1, 0);
+    for (int prop : props)
+        ++prop_start[prop + 1];
+    for (int prop = 0; prop < num_props; ++prop)
+        prop_start[prop + 1] += prop_start[prop];
+    ops.resize(props.size());
+    vector<int> next(prop_start.begin(), prop_start.end() - 1);
+    int num_ops = op_start.size() - 1;
+    for (int op = 0; op < num_ops; ++op)
+        for (int i = op_start[op]; i < op_start[op + 1]; ++i)
+            ops[next[props[i]]++] = op;
+}
+}
+
 // construction and destruction
-LandmarkCutLandmarks::LandmarkCutLandmarks(const TaskProxy &task_proxy) {
+LandmarkCutLandmarks::LandmarkCutLandmarks(const TaskProxy &task_proxy)
+    : relaxed_task(build_relaxed_task(task_proxy)),
+      proposition_costs(relaxed_task->num_propositions),
+      operator_costs(relaxed_task->num_operators),
+      priority_queue(relaxed_task->max_operator_cost <= 1) {
+    initialize_exploration_data();
+}
+
+LandmarkCutLandmarks::LandmarkCutLandmarks(const LandmarkCutLandmarks &other)
+    : relaxed_task(other.relaxed_task),
+      proposition_costs(relaxed_task->num_propositions),
+      operator_costs(relaxed_task->num_operators),
+      priority_queue(relaxed_task->max_operator_cost <= 1) {
+    initialize_exploration_data();
+}
+
+LandmarkCutLandmarks::~LandmarkCutLandmarks() {
+}
+
+void LandmarkCutLandmarks::initialize_exploration_data() {
+    const RelaxedTask &task = *relaxed_task;
+    for (int prop = 0; prop < task.num_propositions; ++prop) {
+        PropositionCosts &prop_costs = proposition_costs[prop];
+        prop_costs.precondition_of_begin = task.precondition_of_start[prop];
+        prop_costs.precondition_of_end = task.precondition_of_start[prop + 1];
+    }
+    for (int op = 0; op < task.num_operators; ++op) {
+        OperatorCosts &op_costs = operator_costs[op];
+        op_costs.effects_begin = task.effect_start[op];
+        op_costs.effects_end = task.effect_start[op + 1];
+    }
+}
+
+shared_ptr<const RelaxedTask> LandmarkCutLandmarks::build_relaxed_task(
+    const TaskProxy &task_proxy) {
     task_properties::verify_no_axioms(task_proxy);
     task_properties::verify_no_conditional_effects(task_proxy);
 
+    shared_ptr<RelaxedTask> task = make_shared<RelaxedTask>();
+    task->max_operator_cost = task_properties::get_max_operator_cost(task_proxy);
+
     // Build propositions.
-    num_propositions = 2; // artificial goal and artificial precondition
-    VariablesProxy variables = task_proxy.get_variables();
-    propositions.resize(variables.size());
-    for (FactProxy fact : variables.get_facts()) {
-        int var_id = fact.get_variable().get_id();
-        propositions[var_id].push_back(RelaxedProposition());
-        ++num_propositions;
+    int num_facts = 0;
+    for (VariableProxy var : task_proxy.get_variables()) {
+        task->proposition_offsets.push_back(num_facts);
+        num_facts += var.get_domain_size();
     }
+    task->artificial_precondition = num_facts;
+    task->artificial_goal = num_facts + 1;
+    task->num_propositions = num_facts + 2;
+    auto get_prop = [&](const FactProxy &fact) {
+        return task->proposition_offsets[fact.get_variable().get_id()] +
+               fact.get_value();
+    };
+    task->precondition_start.push_back(0);
+    task->effect_start.push_back(0);
+    auto add_relaxed_operator = [&](int op_id, int base_cost) {
+        if (static_cast<int>(task->preconditions.size()) ==
+            task->precondition_start.back())
+            task->preconditions.push_back(task->artificial_precondition);
+        task->precondition_start.push_back(task->preconditions.size());
+        task->effect_start.push_back(task->effects.size());
+        task->original_op_ids.push_back(op_id);
+        task->base_costs.push_back(base_cost);
+    };
 
     // Build relaxed operators for operators and axioms.
-    for (OperatorProxy op : task_proxy.get_operators())
-        build_relaxed_operator(op);
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        for (FactProxy pre : op.get_preconditions()) {
+            task->preconditions.push_back(get_prop(pre));
+        }
+        for (EffectProxy eff : op.get_effects()) {
+            task->effects.push_back(get_prop(eff.get_fact()));
+        }
+        add_relaxed_operator(op.get_id(), op.get_cost());
+    }
 
     // Simplify relaxed operators.
     // simplify();
@@ -35,75 +115,46 @@ LandmarkCutLandmarks::LandmarkCutLandmarks(const TaskProxy &task_proxy) {
        unary operators hurts. */
 
     // Build artificial goal proposition and operator.
-    vector<RelaxedProposition *> goal_op_pre, goal_op_eff;
     for (FactProxy goal : task_proxy.get_goals()) {
-        goal_op_pre.push_back(get_proposition(goal));
+        task->preconditions.push_back(get_prop(goal));
     }
-    goal_op_eff.push_back(&artificial_goal);
+    task->effects.push_back(task->artificial_goal);
     /* Use the invalid operator ID -1 so accessing
        the artificial operator will generate an error. */
-    add_relaxed_operator(move(goal_op_pre), move(goal_op_eff), -1, 0);
+    add_relaxed_operator(-1, 0);
+    task->num_operators = task->original_op_ids.size();
 
     // Cross-reference relaxed operators.
-    for (RelaxedOperator &op : relaxed_operators) {
-        for (RelaxedProposition *pre : op.preconditions)
-            pre->precondition_of.push_back(&op);
-        for (RelaxedProposition *eff : op.effects)
-            eff->effect_of.push_back(&op);
-    }
-}
-
-LandmarkCutLandmarks::~LandmarkCutLandmarks() {
-}
-
-void LandmarkCutLandmarks::build_relaxed_operator(const OperatorProxy &op) {
-    vector<RelaxedProposition *> precondition;
-    vector<RelaxedProposition *> effects;
-    for (FactProxy pre : op.get_preconditions()) {
-        precondition.push_back(get_proposition(pre));
-    }
-    for (EffectProxy eff : op.get_effects()) {
-        effects.push_back(get_proposition(eff.get_fact()));
-    }
-    add_relaxed_operator(
-        move(precondition), move(effects), op.get_id(), op.get_cost());
+    build_index(task->preconditions, task->precondition_start,
+                task->num_propositions, task->precondition_of_start,
+                task->precondition_of);
+    build_index(task->effects, task->effect_start,
+                task->num_propositions, task->effect_of_start,
+                task->effect_of);
+    return task;
 }
 
-void LandmarkCutLandmarks::add_relaxed_operator(
-    vector<RelaxedProposition *> &&precondition,
-    vector<RelaxedProposition *> &&effects,
-    int op_id, int base_cost) {
-    RelaxedOperator relaxed_op(
-        move(precondition), move(effects), op_id, base_cost);
-    if (relaxed_op.preconditions.empty())
-        relaxed_op.preconditions.push_back(&artificial_precondition);
-    relaxed_operators.push_back(relaxed_op);
-}
-
-RelaxedProposition *LandmarkCutLandmarks::get_proposition(
-    const FactProxy &fact) {
+int LandmarkCutLandmarks::get_proposition(const FactProxy &fact) const {
     int var_id = fact.get_variable().get_id();
     int val = fact.get_value();
-    return &propositions[var_id][val];
+    return relaxed_task->proposition_offsets[var_id] + val;
 }
 
 // heuristic computation
 void LandmarkCutLandmarks::setup_exploration_queue() {
     priority_queue.clear();
 
-    for (auto &var_props : propositions) {
-        for (RelaxedProposition &prop : var_props) {
-            prop.status = UNREACHED;
-        }
+    for (PropositionCosts &prop_costs : proposition_costs) {
+        prop_costs.status = UNREACHED;
     }
 
-    artificial_goal.status = UNREACHED;
-    artificial_precondition.status = UNREACHED;
-
-    for (RelaxedOperator &op : relaxed_operators) {
-        op.unsatisfied_preconditions = op.preconditions.size();
-        op.h_max_supporter = 0;
-        op.h_max_supporter_cost = numeric_limits<int>::max();
+    const vector<int> &precondition_start = relaxed_task->precondition_start;
+    for (int op = 0; op < relaxed_task->num_operators; ++op) {
+        OperatorCosts &op_costs = operator_costs[op];
+        op_costs.unsatisfied_preconditions =
+            precondition_start[op + 1] - precondition_start[op];
+        op_costs.h_max_supporter = NO_PROPOSITION;
+        op_costs.h_max_supporter_cost = numeric_limits<int>::max();
     }
 }
 
@@ -111,74 +162,81 @@ void LandmarkCutLandmarks::setup_exploration_queue_state(const State &state) {
     for (FactProxy init_fact : state) {
         enqueue_if_necessary(get_proposition(init_fact), 0);
     }
-    enqueue_if_necessary(&artificial_precondition, 0);
+    enqueue_if_necessary(relaxed_task->artificial_precondition, 0);
 }
 
 void LandmarkCutLandmarks::first_exploration(const State &state) {
     assert(priority_queue.empty());
     setup_exploration_queue();
     setup_exploration_queue_state(state);
+    // See second_exploration for why we use pointers into the arrays.
+    const int *precondition_of = relaxed_task->precondition_of.data();
+    const int *effects = relaxed_task->effects.data();
+    OperatorCosts *ops = operator_costs.data();
     while (!priority_queue.empty()) {
-        pair<int, RelaxedProposition *> top_pair = priority_queue.pop();
+        pair<int, int> top_pair = priority_queue.pop();
         int popped_cost = top_pair.first;
-        RelaxedProposition *prop = top_pair.second;
-        int prop_cost = prop->h_max_cost;
+        int prop = top_pair.second;
+        const PropositionCosts &prop_costs = proposition_costs[prop];
+        int prop_cost = prop_costs.h_max_cost;
         assert(prop_cost <= popped_cost);
         if (prop_cost < popped_cost)
             continue;
-        const vector<RelaxedOperator *> &triggered_operators =
-            prop->precondition_of;
-        for (RelaxedOperator *relaxed_op : triggered_operators) {
-            --relaxed_op->unsatisfied_preconditions;
-            assert(relaxed_op->unsatisfied_preconditions >= 0);
-            if (relaxed_op->unsatisfied_preconditions == 0) {
-                relaxed_op->h_max_supporter = prop;
-                relaxed_op->h_max_supporter_cost = prop_cost;
-                int target_cost = prop_cost + relaxed_op->cost;
-                for (RelaxedProposition *effect : relaxed_op->effects) {
-                    enqueue_if_necessary(effect, target_cost);
+        int end = prop_costs.precondition_of_end;
+        for (int i = prop_costs.precondition_of_begin; i < end; ++i) {
+            OperatorCosts &op_costs = ops[precondition_of[i]];
+            --op_costs.unsatisfied_preconditions;
+            assert(op_costs.unsatisfied_preconditions >= 0);
+            if (op_costs.unsatisfied_preconditions == 0) {
+                op_costs.h_max_supporter = prop;
+                op_costs.h_max_supporter_cost = prop_cost;
+                int target_cost = prop_cost + op_costs.cost;
+                int effects_end = op_costs.effects_end;
+                for (int j = op_costs.effects_begin; j < effects_end; ++j) {
+                    enqueue_if_necessary(effects[j], target_cost);
                 }
             }
         }
     }
 }
 
-void LandmarkCutLandmarks::first_exploration_incremental(
-    vector<RelaxedOperator *> &cut) {
+void LandmarkCutLandmarks::first_exploration_incremental(vector<int> &cut) {
     assert(priority_queue.empty());
-    /* We pretend that this queue has had as many pushes already as we
-       have propositions to avoid switching from bucket-based to
-       heap-based too aggressively. This should prevent ever switching
-       to heap-based in problems where action costs are at most 1.
-    */
-    priority_queue.add_virtual_pushes(num_propositions);
-    for (RelaxedOperator *relaxed_op : cut) {
-        int cost = relaxed_op->h_max_supporter_cost + relaxed_op->cost;
-        for (RelaxedProposition *effect : relaxed_op->effects)
-            enqueue_if_necessary(effect, cost);
+    // See second_exploration for why we use pointers into the arrays.
+    const int *precondition_of = relaxed_task->precondition_of.data();
+    const int *effects = relaxed_task->effects.data();
+    OperatorCosts *ops = operator_costs.data();
+    for (int relaxed_op : cut) {
+        const OperatorCosts &op_costs = ops[relaxed_op];
+        int cost = op_costs.h_max_supporter_cost + op_costs.cost;
+        for (int j = op_costs.effects_begin; j < op_costs.effects_end; ++j)
+            enqueue_if_necessary(effects[j], cost);
     }
     while (!priority_queue.empty()) {
-        pair<int, RelaxedProposition *> top_pair = priority_queue.pop();
+        pair<int, int> top_pair = priority_queue.pop();
         int popped_cost = top_pair.first;
-        RelaxedProposition *prop = top_pair.second;
-        int prop_cost = prop->h_max_cost;
+        int prop = top_pair.second;
+        const PropositionCosts &prop_costs = proposition_costs[prop];
+        int prop_cost = prop_costs.h_max_cost;
         assert(prop_cost <= popped_cost);
         if (prop_cost < popped_cost)
             continue;
-        const vector<RelaxedOperator *> &triggered_operators =
-            prop->precondition_of;
-        for (RelaxedOperator *relaxed_op : triggered_operators) {
-            if (relaxed_op->h_max_supporter == prop) {
-                int old_supp_cost = relaxed_op->h_max_supporter_cost;
+        int end = prop_costs.precondition_of_end;
+        for (int i = prop_costs.precondition_of_begin; i < end; ++i) {
+            int relaxed_op = precondition_of[i];
+            OperatorCosts &op_costs = ops[relaxed_op];
+            if (op_costs.h_max_supporter == prop) {
+                int old_supp_cost = op_costs.h_max_supporter_cost;
                 if (old_supp_cost > prop_cost) {
-                    relaxed_op->update_h_max_supporter();
-                    int new_supp_cost = relaxed_op->h_max_supporter_cost;
+                    update_h_max_supporter(relaxed_op);
+                    int new_supp_cost = op_costs.h_max_supporter_cost;
                     if (new_supp_cost != old_supp_cost) {
                         // This operator has become cheaper.
                         assert(new_supp_cost < old_supp_cost);
-                        int target_cost = new_supp_cost + relaxed_op->cost;
-                        for (RelaxedProposition *effect : relaxed_op->effects)
-                            enqueue_if_necessary(effect, target_cost);
+                        int target_cost = new_supp_cost + op_costs.cost;
+                        int effects_end = op_costs.effects_end;
+                        for (int j = op_costs.effects_begin; j < effects_end; ++j)
+                            enqueue_if_necessary(effects[j], target_cost);
                     }
                 }
             }
@@ -187,41 +245,57 @@ void LandmarkCutLandmarks::first_exploration_incremental(
 }
 
 void LandmarkCutLandmarks::second_exploration(
-    const State &state, vector<RelaxedProposition *> &second_exploration_queue,
-    vector<RelaxedOperator *> &cut) {
+    const State &state, vector<int> &second_exploration_queue,
+    vector<int> &cut) {
     assert(second_exploration_queue.empty());
     assert(cut.empty());
 
-    artificial_precondition.status = BEFORE_GOAL_ZONE;
-    second_exploration_queue.push_back(&artificial_precondition);
+    const RelaxedTask &task = *relaxed_task;
+    int artificial_precondition = task.artificial_precondition;
+    proposition_costs[artificial_precondition].status = BEFORE_GOAL_ZONE;
+    second_exploration_queue.push_back(artificial_precondition);
 
     for (FactProxy init_fact : state) {
-        RelaxedProposition *init_prop = get_proposition(init_fact);
-        init_prop->status = BEFORE_GOAL_ZONE;
+        int init_prop = get_proposition(init_fact);
+        proposition_costs[init_prop].status = BEFORE_GOAL_ZONE;
         second_exploration_queue.push_back(init_prop);
     }
 
+    /*
+      The pointers stay valid during the loop and, unlike the vectors,
+      need not be reloaded after each push_back.
+    */
+    const int *precondition_of = task.precondition_of.data();
+    const int *effects = task.effects.data();
+    PropositionCosts *props = proposition_costs.data();
+    const OperatorCosts *ops = operator_costs.data();
     while (!second_exploration_queue.empty()) {
-        RelaxedProposition *prop = second_exploration_queue.back();
+        int prop = second_exploration_queue.back();
         second_exploration_queue.pop_back();
-        const vector<RelaxedOperator *> &triggered_operators =
-            prop->precondition_of;
-        for (RelaxedOperator *relaxed_op : triggered_operators) {
-            if (relaxed_op->h_max_supporter == prop) {
+        const PropositionCosts &prop_costs = props[prop];
+        int end = prop_costs.precondition_of_end;
+        for (int i = prop_costs.precondition_of_begin; i < end; ++i) {
+            int relaxed_op = precondition_of[i];
+            const OperatorCosts &op_costs = ops[relaxed_op];
+            if (op_costs.h_max_supporter == prop) {
+                int effects_begin = op_costs.effects_begin;
+                int effects_end = op_costs.effects_end;
                 bool reached_goal_zone = false;
-                for (RelaxedProposition *effect : relaxed_op->effects) {
-                    if (effect->status == GOAL_ZONE) {
-                        assert(relaxed_op->cost > 0);
+                for (int j = effects_begin; j < effects_end; ++j) {
+                    if (props[effects[j]].status == GOAL_ZONE) {
+                        assert(op_costs.cost > 0);
                         reached_goal_zone = true;
                         cut.push_back(relaxed_op);
                         break;
                     }
                 }
                 if (!reached_goal_zone) {
-                    for (RelaxedProposition *effect : relaxed_op->effects) {
-                        if (effect->status != BEFORE_GOAL_ZONE) {
-                            assert(effect->status == REACHED);
-                            effect->status = BEFORE_GOAL_ZONE;
+                    for (int j = effects_begin; j < effects_end; ++j) {
+                        int effect = effects[j];
+                        PropositionStatus &status = props[effect].status;
+                        if (status != BEFORE_GOAL_ZONE) {
+                            assert(status == REACHED);
+                            status = BEFORE_GOAL_ZONE;
                             second_exploration_queue.push_back(effect);
                         }
                     }
@@ -231,16 +305,20 @@ void LandmarkCutLandmarks::second_exploration(
     }
 }
 
-void LandmarkCutLandmarks::mark_goal_plateau(RelaxedProposition *subgoal) {
-    // NOTE: subgoal can be null if we got here via recursion through
-    // a zero-cost action that is relaxed unreachable. (This can only
-    // happen in domains which have zero-cost actions to start with.)
+void LandmarkCutLandmarks::mark_goal_plateau(int subgoal) {
+    // NOTE: subgoal can be NO_PROPOSITION if we got here via recursion
+    // through a zero-cost action that is relaxed unreachable. (This can
+    // only happen in domains which have zero-cost actions to start with.)
     // For example, this happens in pegsol-strips #01.
-    if (subgoal && subgoal->status != GOAL_ZONE) {
-        subgoal->status = GOAL_ZONE;
-        for (RelaxedOperator *achiever : subgoal->effect_of)
-            if (achiever->cost == 0)
-                mark_goal_plateau(achiever->h_max_supporter);
+    if (subgoal != NO_PROPOSITION &&
+        proposition_costs[subgoal].status != GOAL_ZONE) {
+        proposition_costs[subgoal].status = GOAL_ZONE;
+        const RelaxedTask &task = *relaxed_task;
+        for (int i = task.effect_of_start[subgoal]; i < task.effect_of_start[subgoal + 1]; ++i) {
+            int achiever = task.effect_of[i];
+            if (operator_costs[achiever].cost == 0)
+                mark_goal_plateau(operator_costs[achiever].h_max_supporter);
+        }
     }
 }
 
@@ -249,24 +327,31 @@ void LandmarkCutLandmarks::validate_h_max() const {
     // Using conditional compilation to avoid complaints about unused
     // variables when using NDEBUG. This whole code does nothing useful
     // when assertions are switched off anyway.
-    for (const RelaxedOperator &op : relaxed_operators) {
-        if (op.unsatisfied_preconditions) {
+    const RelaxedTask &task = *relaxed_task;
+    for (int op = 0; op < task.num_operators; ++op) {
+        const OperatorCosts &op_costs = operator_costs[op];
+        int preconditions_begin = task.precondition_start[op];
+        int preconditions_end = task.precondition_start[op + 1];
+        if (op_costs.unsatisfied_preconditions) {
             bool reachable = true;
-            for (RelaxedProposition *pre : op.preconditions) {
-                if (pre->status == UNREACHED) {
+            for (int i = preconditions_begin; i < preconditions_end; ++i) {
+                int pre = task.preconditions[i];
+                if (proposition_costs[pre].status == UNREACHED) {
                     reachable = false;
                     break;
                 }
             }
             assert(!reachable);
-            assert(!op.h_max_supporter);
+            assert(op_costs.h_max_supporter == NO_PROPOSITION);
         } else {
-            assert(op.h_max_supporter);
-            int h_max_cost = op.h_max_supporter_cost;
-            assert(h_max_cost == op.h_max_supporter->h_max_cost);
-            for (RelaxedProposition *pre : op.preconditions) {
-                assert(pre->status != UNREACHED);
-                assert(pre->h_max_cost <= h_max_cost);
+            assert(op_costs.h_max_supporter != NO_PROPOSITION);
+            int h_max_cost = op_costs.h_max_supporter_cost;
+            assert(h_max_cost ==
+                   proposition_costs[op_costs.h_max_supporter].h_max_cost);
+            for (int i = preconditions_begin; i < preconditions_end; ++i) {
+                int pre = task.preconditions[i];
+                assert(proposition_costs[pre].status != UNREACHED);
+                assert(proposition_costs[pre].h_max_cost <= h_max_cost);
             }
         }
     }
@@ -276,41 +361,43 @@ void LandmarkCutLandmarks::validate_h_max() const {
 bool LandmarkCutLandmarks::compute_landmarks(
     State state, CostCallback cost_callback,
     LandmarkCallback landmark_callback) {
-    for (RelaxedOperator &op : relaxed_operators) {
-        op.cost = op.base_cost;
+    for (int op = 0; op < relaxed_task->num_operators; ++op) {
+        operator_costs[op].cost = relaxed_task->base_costs[op];
     }
     // The following three variables could be declared inside the loop
     // ("second_exploration_queue" even inside second_exploration),
     // but having them here saves reallocations and hence provides a
     // measurable speed boost.
-    vector<RelaxedOperator *> cut;
+    vector<int> cut;
     Landmark landmark;
-    vector<RelaxedProposition *> second_exploration_queue;
+    vector<int> second_exploration_queue;
     first_exploration(state);
     // validate_h_max();  // too expensive to use even in regular debug mode
+    const PropositionCosts &artificial_goal =
+        proposition_costs[relaxed_task->artificial_goal];
     if (artificial_goal.status == UNREACHED)
         return true;
 
     int num_iterations = 0;
     while (artificial_goal.h_max_cost != 0) {
         ++num_iterations;
-        mark_goal_plateau(&artificial_goal);
+        mark_goal_plateau(relaxed_task->artificial_goal);
         assert(cut.empty());
         second_exploration(state, second_exploration_queue, cut);
         assert(!cut.empty());
         int cut_cost = numeric_limits<int>::max();
-        for (RelaxedOperator *op : cut)
-            cut_cost = min(cut_cost, op->cost);
-        for (RelaxedOperator *op : cut)
-            op->cost -= cut_cost;
+        for (int op : cut)
+            cut_cost = min(cut_cost, operator_costs[op].cost);
+        for (int op : cut)
+            operator_costs[op].cost -= cut_cost;
 
         if (cost_callback) {
             cost_callback(cut_cost);
         }
         if (landmark_callback) {
             landmark.clear();
-            for (RelaxedOperator *op : cut) {
-                landmark.push_back(op->original_op_id);
+            for (int op : cut) {
+                landmark.push_back(relaxed_task->original_op_ids[op]);
             }
             landmark_callback(landmark, cut_cost);
         }
@@ -323,16 +410,13 @@ bool LandmarkCutLandmarks::compute_landmarks(
           Note: This could perhaps be made more efficient, for example by
           using a round-dependent counter for GOAL_ZONE and BEFORE_GOAL_ZONE,
           or something based on total_cost, so that we don't need a per-round
-          reinitialization.
+          reinitialization. (This also resets the artificial goal and
+          precondition, which are always reached here.)
         */
-        for (auto &var_props : propositions) {
-            for (RelaxedProposition &prop : var_props) {
-                if (prop.status == GOAL_ZONE || prop.status == BEFORE_GOAL_ZONE)
-                    prop.status = REACHED;
-            }
+        for (PropositionCosts &prop_costs : proposition_costs) {
+            if (prop_costs.status == GOAL_ZONE || prop_costs.status == BEFORE_GOAL_ZONE)
+                prop_costs.status = REACHED;
         }
-        artificial_goal.status = REACHED;
-        artificial_precondition.status = REACHED;
     }
     return false;
 }
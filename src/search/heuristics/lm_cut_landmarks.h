@@ -12,7 +12,9 @@
 
 namespace lm_cut_heuristic {
 // TODO: Fix duplication with the other relaxation heuristics.
-struct RelaxedProposition;
+
+// Relaxed propositions and operators are identified by their index.
+const int NO_PROPOSITION = -1;
 
 enum PropositionStatus {
     UNREACHED = 0,
@@ -21,64 +23,97 @@ enum PropositionStatus {
     BEFORE_GOAL_ZONE = 3
 };
 
-struct RelaxedOperator {
-    int original_op_id;
-    std::vector<RelaxedProposition *> preconditions;
-    std::vector<RelaxedProposition *> effects;
-    int base_cost; // 0 for axioms, 1 for regular operators
+/*
+  The relaxed task does not change after construction, so copies of
+  LandmarkCutLandmarks share it. Each fact has a proposition (the facts
+  of var start at proposition_offsets[var]), followed by the artificial
+  precondition of operators without preconditions and the artificial
+  goal, which is the effect of an artificial operator with the goals as
+  preconditions.
+
+  Relaxed operators and propositions are stored as arrays indexed by
+  their IDs. The lists of operators and propositions are stored in
+  compressed sparse row format: the entries for i are those in
+  [start[i], start[i + 1]).
+*/
+struct RelaxedTask {
+    std::vector<int> proposition_offsets;
+    int num_propositions;
+    std::vector<int> precondition_of_start;
+    std::vector<int> precondition_of;
+    std::vector<int> effect_of_start;
+    std::vector<int> effect_of;
+
+    int num_operators;
+    std::vector<int> precondition_start;
+    std::vector<int> preconditions;
+    std::vector<int> effect_start;
+    std::vector<int> effects;
+    // -1 for the artificial goal operator
+    std::vector<int> original_op_ids;
+    std::vector<int> base_costs;
+
+    int artificial_precondition;
+    int artificial_goal;
+    int max_operator_cost;
+};
 
+/*
+  Exploration data of a relaxed operator. It repeats the range of its
+  effects in RelaxedTask::effects, so that the explorations find them
+  without accessing another array.
+*/
+struct OperatorCosts {
     int cost;
     int unsatisfied_preconditions;
     int h_max_supporter_cost; // h_max_cost of h_max_supporter
-    RelaxedProposition *h_max_supporter;
-    RelaxedOperator(std::vector<RelaxedProposition *> &&pre,
-                    std::vector<RelaxedProposition *> &&eff,
-                    int op_id, int base)
-        : original_op_id(op_id), preconditions(pre), effects(eff), base_cost(base) {
-    }
-
-    inline void update_h_max_supporter();
+    int h_max_supporter;
+    int effects_begin;
+    int effects_end;
 };
 
-struct RelaxedProposition {
-    std::vector<RelaxedOperator *> precondition_of;
-    std::vector<RelaxedOperator *> effect_of;
-
+/*
+  Exploration data of a relaxed proposition. It repeats the range of the
+  operators that have it as precondition in RelaxedTask::precondition_of.
+*/
+struct PropositionCosts {
     PropositionStatus status;
     int h_max_cost;
+    int precondition_of_begin;
+    int precondition_of_end;
 };
 
 class LandmarkCutLandmarks {
-    std::vector<RelaxedOperator> relaxed_operators;
-    std::vector<std::vector<RelaxedProposition>> propositions;
-    RelaxedProposition artificial_precondition;
-    RelaxedProposition artificial_goal;
-    int num_propositions;
-    priority_queues::AdaptiveQueue<RelaxedProposition *> priority_queue;
-
-    void build_relaxed_operator(const OperatorProxy &op);
-    void add_relaxed_operator(std::vector<RelaxedProposition *> &&precondition,
-                              std::vector<RelaxedProposition *> &&effects,
-                              int op_id, int base_cost);
-    RelaxedProposition *get_proposition(const FactProxy &fact);
+    std::shared_ptr<const RelaxedTask> relaxed_task;
+    std::vector<PropositionCosts> proposition_costs;
+    std::vector<OperatorCosts> operator_costs;
+    // Bucket-based with unit costs, since h^max costs are then small.
+    priority_queues::MonotoneQueue<int> priority_queue;
+
+    static std::shared_ptr<const RelaxedTask> build_relaxed_task(
+        const TaskProxy &task_proxy);
+    int get_proposition(const FactProxy &fact) const;
+    void initialize_exploration_data();
     void setup_exploration_queue();
     void setup_exploration_queue_state(const State &state);
     void first_exploration(const State &state);
-    void first_exploration_incremental(std::vector<RelaxedOperator *> &cut);
+    void first_exploration_incremental(std::vector<int> &cut);
     void second_exploration(const State &state,
-                            std::vector<RelaxedProposition *> &second_exploration_queue,
-                            std::vector<RelaxedOperator *> &cut);
+                            std::vector<int> &second_exploration_queue,
+                            std::vector<int> &cut);
 
-    void enqueue_if_necessary(RelaxedProposition *prop, int cost) {
+    void enqueue_if_necessary(int prop, int cost) {
         assert(cost >= 0);
-        if (prop->status == UNREACHED || prop->h_max_cost > cost) {
-            prop->status = REACHED;
-            prop->h_max_cost = cost;
+        PropositionCosts &prop_costs = proposition_costs[prop];
+        if (prop_costs.status == UNREACHED || prop_costs.h_max_cost > cost) {
+            prop_costs.status = REACHED;
+            prop_costs.h_max_cost = cost;
             priority_queue.push(cost, prop);
         }
     }
 
-    void mark_goal_plateau(RelaxedProposition *subgoal);
+    inline void update_h_max_supporter(int op);
+    void mark_goal_plateau(int subgoal);
     void validate_h_max() const;
 public:
     using Landmark = std::vector<int>;
@@ -86,6 +121,8 @@ public:
     using LandmarkCallback = std::function<void (const Landmark &, int)>;
 
     LandmarkCutLandmarks(const TaskProxy &task_proxy);
+    // The copy shares the relaxed task with other.
+    LandmarkCutLandmarks(const LandmarkCutLandmarks &other);
     virtual ~LandmarkCutLandmarks();
 
     /*
@@ -105,12 +142,18 @@ public:
                            LandmarkCallback landmark_callback);
 };
 
-inline void RelaxedOperator::update_h_max_supporter() {
-    assert(!unsatisfied_preconditions);
-    for (size_t i = 0; i < preconditions.size(); ++i)
-        if (preconditions[i]->h_max_cost > h_max_supporter->h_max_cost)
-            h_max_supporter = preconditions[i];
-    h_max_supporter_cost = h_max_supporter->h_max_cost;
+inline void LandmarkCutLandmarks::update_h_max_supporter(int op) {
+    OperatorCosts &op_costs = operator_costs[op];
+    assert(!op_costs.unsatisfied_preconditions);
+    int supporter = op_costs.h_max_supporter;
+    const RelaxedTask &task = *relaxed_task;
+    for (int i = task.precondition_start[op]; i < task.precondition_start[op + 1]; ++i) {
+        int pre = task.preconditions[i];
+        if (proposition_costs[pre].h_max_cost > proposition_costs[supporter].h_max_cost)
+            supporter = pre;
+    }
+    op_costs.h_max_supporter = supporter;
+    op_costs.h_max_supporter_cost = proposition_costs[supporter].h_max_cost;
 }
 }
 
@@ -4,6 +4,9 @@
 #include "../option_parser.h"
 #include "../plugin.h"
 
+#include "../task_utils/task_properties.h"
+
+#include <algorithm>
 #include <cassert>
 #include <vector>
 using namespace std;
@@ -23,61 +26,66 @@ namespace max_heuristic {
 
 // construction and destruction
 HSPMaxHeuristic::HSPMaxHeuristic(const Options &opts)
-    : RelaxationHeuristic(opts) {
+    : RelaxationHeuristic(opts),
+      queue(task_properties::get_max_operator_cost(task_proxy) <= 1) {
     cout << "Initializing HSP max heuristic..." << endl;
 }
 
+HSPMaxHeuristic::HSPMaxHeuristic(const HSPMaxHeuristic &other)
+    : RelaxationHeuristic(other),
+      queue(task_properties::get_max_operator_cost(task_proxy) <= 1) {
+}
+
 HSPMaxHeuristic::~HSPMaxHeuristic() {
 }
 
+shared_ptr<Heuristic> HSPMaxHeuristic::create_thread_local_copy() const {
+    return shared_ptr<HSPMaxHeuristic>(new HSPMaxHeuristic(*this));
+}
+
 // heuristic computation
 void HSPMaxHeuristic::setup_exploration_queue() {
     queue.clear();
 
-    for (vector<Proposition> &props_of_var : propositions) {
-        for (Proposition &prop : props_of_var) {
-            prop.cost = -1;
-        }
-    }
+    fill(prop_costs.begin(), prop_costs.end(), -1);
+    op_unsatisfied_preconditions = op_num_preconditions;
+    op_costs = op_base_costs; // will be increased by precondition costs
 
     // Deal with operators and axioms without preconditions.
-    for (UnaryOperator &op : unary_operators) {
-        op.unsatisfied_preconditions = op.precondition.size();
-        op.cost = op.base_cost; // will be increased by precondition costs
-
-        if (op.unsatisfied_preconditions == 0)
-            enqueue_if_necessary(op.effect, op.base_cost);
-    }
+    for (OpID op : precondition_free_operators)
+        enqueue_if_necessary(op_effects[op], op_base_costs[op], op);
 }
 
 void HSPMaxHeuristic::setup_exploration_queue_state(const State &state) {
     for (FactProxy fact : state) {
-        Proposition *init_prop = get_proposition(fact);
-        enqueue_if_necessary(init_prop, 0);
+        PropID init_prop = get_prop_id(fact);
+        enqueue_if_necessary(init_prop, 0, NO_OP);
     }
 }
 
 void HSPMaxHeuristic::relaxed_exploration() {
     int unsolved_goals = goal_propositions.size();
     while (!queue.empty()) {
-        pair<int, Proposition *> top_pair = queue.pop();
+        pair<int, PropID> top_pair = queue.pop();
         int distance = top_pair.first;
-        Proposition *prop = top_pair.second;
-        int prop_cost = prop->cost;
+        PropID prop = top_pair.second;
+        int prop_cost = prop_costs[prop];
         assert(prop_cost <= distance);
         if (prop_cost < distance)
             continue;
-        if (prop->is_goal && --unsolved_goals == 0)
+        // Incremental exploration needs the costs of all propositions.
+        if (is_goal[prop] && --unsolved_goals == 0 && !incremental)
             return;
-        const vector<UnaryOperator *> &triggered_operators =
-            prop->precondition_of;
-        for (UnaryOperator *unary_op : triggered_operators) {
-            --unary_op->unsatisfied_preconditions;
-            unary_op->cost = max(unary_op->cost,
-                                 unary_op->base_cost + prop_cost);
-            assert(unary_op->unsatisfied_preconditions >= 0);
-            if (unary_op->unsatisfied_preconditions == 0)
-                enqueue_if_necessary(unary_op->effect, unary_op->cost);
+        int end = precondition_of_start[prop + 1];
+        for (int i = precondition_of_start[prop]; i < end; ++i) {
+            OpID unary_op = precondition_of[i];
+            int &unsatisfied_preconditions = op_unsatisfied_preconditions[unary_op];
+            --unsatisfied_preconditions;
+            op_costs[unary_op] = max(op_costs[unary_op],
+                                     op_base_costs[unary_op] + prop_cost);
+            assert(unsatisfied_preconditions >= 0);
+            if (unsatisfied_preconditions == 0)
+                enqueue_if_necessary(op_effects[unary_op], op_costs[unary_op], unary_op);
         }
     }
 }
@@ -85,13 +93,17 @@ void HSPMaxHeuristic::relaxed_exploration() {
 int HSPMaxHeuristic::compute_heuristic(const GlobalState &global_state) {
     const State state = convert_global_state(global_state);
 
-    setup_exploration_queue();
-    setup_exploration_queue_state(state);
-    relaxed_exploration();
+    if (!incremental || !repair_exploration(state)) {
+        setup_exploration_queue();
+        setup_exploration_queue_state(state);
+        relaxed_exploration();
+        if (incremental)
+            set_explored_state(state);
+    }
 
     int total_cost = 0;
-    for (Proposition *prop : goal_propositions) {
-        int prop_cost = prop->cost;
+    for (PropID prop : goal_propositions) {
+        int prop_cost = prop_costs[prop];
         if (prop_cost == -1) {
             return DEAD_END;
         }
@@ -101,6 +113,18 @@ int HSPMaxHeuristic::compute_heuristic(const GlobalState &global_state) {
     return total_cost;
 }
 
+int HSPMaxHeuristic::compute_operator_cost(OpID op) {
+    int base_cost = op_base_costs[op];
+    int cost = base_cost;
+    for (int i = precondition_start[op]; i < precondition_start[op + 1]; ++i) {
+        int pre_cost = prop_costs[preconditions[i]];
+        if (pre_cost == -1)
+            return -1;
+        cost = max(cost, base_cost + pre_cost);
+    }
+    return cost;
+}
+
 static shared_ptr<Heuristic> _parse(OptionParser &parser) {
     parser.document_synopsis("Max heuristic", "");
     parser.document_language_support("action costs", "supported");
@@ -115,7 +139,7 @@ static shared_ptr<Heuristic> _parse(OptionParser &parser) {
     parser.document_property("safe", "yes for tasks without axioms");
     parser.document_property("preferred operators", "no");
 
-    Heuristic::add_options_to_parser(parser);
+    relaxation_heuristic::RelaxationHeuristic::add_options_to_parser(parser);
     Options opts = parser.parse();
 
     if (parser.dry_run())
@@ -6,28 +6,41 @@
 #include "../algorithms/priority_queues.h"
 
 #include <cassert>
+#include <memory>
 
 namespace max_heuristic {
-using relaxation_heuristic::Proposition;
-using relaxation_heuristic::UnaryOperator;
+using relaxation_heuristic::PropID;
+using relaxation_heuristic::OpID;
+using relaxation_heuristic::NO_OP;
 
 class HSPMaxHeuristic : public relaxation_heuristic::RelaxationHeuristic {
-    priority_queues::AdaptiveQueue<Proposition *> queue;
+    /*
+      Bucket-based with unit costs, since h^max costs are then bounded
+      by the number of propositions.
+    */
+    priority_queues::MonotoneQueue<PropID> queue;
 
     void setup_exploration_queue();
     void setup_exploration_queue_state(const State &state);
     void relaxed_exploration();
 
-    void enqueue_if_necessary(Proposition *prop, int cost) {
+    void enqueue_if_necessary(PropID prop, int cost, OpID op) {
         assert(cost >= 0);
-        if (prop->cost == -1 || prop->cost > cost) {
-            prop->cost = cost;
+        int &prop_cost = prop_costs[prop];
+        if (prop_cost == -1 || prop_cost > cost) {
+            prop_cost = cost;
+            prop_reached_by[prop] = op;
             queue.push(cost, prop);
         }
-        assert(prop->cost != -1 && prop->cost <= cost);
+        assert(prop_cost != -1 && prop_cost <= cost);
     }
 protected:
     virtual int compute_heuristic(const GlobalState &global_state);
+    virtual int compute_operator_cost(OpID op) override;
+
+    // The copy shares the relaxed task with other.
+    explicit HSPMaxHeuristic(const HSPMaxHeuristic &other);
+    virtual std::shared_ptr<Heuristic> create_thread_local_copy() const override;
 public:
     HSPMaxHeuristic(const options::Options &opts);
     ~HSPMaxHeuristic();
@@ -1,5 +1,7 @@
 #include "relaxation_heuristic.h"
 
+#include "../option_parser.h"
+
 #include "../task_utils/task_properties.h"
 #include "../utils/collections.h"
 #include "../utils/hash.h"
@@ -13,75 +15,25 @@
 using namespace std;
 
 namespace relaxation_heuristic {
-// construction and destruction
-RelaxationHeuristic::RelaxationHeuristic(const options::Options &opts)
-    : Heuristic(opts) {
-    // Build propositions.
-    int prop_id = 0;
-    VariablesProxy variables = task_proxy.get_variables();
-    propositions.resize(variables.size());
-    for (FactProxy fact : variables.get_facts()) {
-        propositions[fact.get_variable().get_id()].push_back(Proposition(prop_id++));
-    }
+namespace {
+// Unary operator before simplification and conversion to arrays.
+struct UnaryOperatorInfo {
+    vector<PropID> preconditions;
+    PropID effect;
+    int operator_no;
+    int base_cost;
 
-    // Build goal propositions.
-    for (FactProxy goal : task_proxy.get_goals()) {
-        Proposition *prop = get_proposition(goal);
-        prop->is_goal = true;
-        goal_propositions.push_back(prop);
+    UnaryOperatorInfo(
+        const vector<PropID> &preconditions, PropID effect, int operator_no,
+        int base_cost)
+        : preconditions(preconditions),
+          effect(effect),
+          operator_no(operator_no),
+          base_cost(base_cost) {
     }
+};
 
-    // Build unary operators for operators and axioms.
-    int op_no = 0;
-    for (OperatorProxy op : task_proxy.get_operators())
-        build_unary_operators(op, op_no++);
-    for (OperatorProxy axiom : task_proxy.get_axioms())
-        build_unary_operators(axiom, -1);
-
-    // Simplify unary operators.
-    simplify();
-
-    // Cross-reference unary operators.
-    for (size_t i = 0; i < unary_operators.size(); ++i) {
-        UnaryOperator *op = &unary_operators[i];
-        for (size_t j = 0; j < op->precondition.size(); ++j)
-            op->precondition[j]->precondition_of.push_back(op);
-    }
-}
-
-RelaxationHeuristic::~RelaxationHeuristic() {
-}
-
-bool RelaxationHeuristic::dead_ends_are_reliable() const {
-    return !task_properties::has_axioms(task_proxy);
-}
-
-Proposition *RelaxationHeuristic::get_proposition(const FactProxy &fact) {
-    int var = fact.get_variable().get_id();
-    int value = fact.get_value();
-    assert(utils::in_bounds(var, propositions));
-    assert(utils::in_bounds(value, propositions[var]));
-    return &propositions[var][value];
-}
-
-void RelaxationHeuristic::build_unary_operators(const OperatorProxy &op, int op_no) {
-    int base_cost = op.get_cost();
-    vector<Proposition *> precondition_props;
-    for (FactProxy precondition : op.get_preconditions()) {
-        precondition_props.push_back(get_proposition(precondition));
-    }
-    for (EffectProxy effect : op.get_effects()) {
-        Proposition *effect_prop = get_proposition(effect.get_fact());
-        EffectConditionsProxy eff_conds = effect.get_conditions();
-        for (FactProxy eff_cond : eff_conds) {
-            precondition_props.push_back(get_proposition(eff_cond));
-        }
-        unary_operators.push_back(UnaryOperator(precondition_props, effect_prop, op_no, base_cost));
-        precondition_props.erase(precondition_props.end() - eff_conds.size(), precondition_props.end());
-    }
-}
-
-void RelaxationHeuristic::simplify() {
+void simplify(vector<UnaryOperatorInfo> &unary_operators) {
     // Remove duplicate or dominated unary operators.
 
     /*
@@ -97,25 +49,22 @@ void RelaxationHeuristic::simplify() {
       never dominates a lower-cost operator.
 
       In the end, the vector of unary operators is sorted by operator_no,
-      effect->id, base_cost and precondition.
+      effect, base_cost and preconditions.
     */
 
 
     cout << "Simplifying " << unary_operators.size() << " unary operators..." << flush;
 
-    using Key = pair<vector<Proposition *>, Proposition *>;
+    using Key = pair<vector<PropID>, PropID>;
     using Map = utils::HashMap<Key, int>;
     Map unary_operator_index;
     unary_operator_index.reserve(unary_operators.size());
 
 
     for (size_t i = 0; i < unary_operators.size(); ++i) {
-        UnaryOperator &op = unary_operators[i];
-        sort(op.precondition.begin(), op.precondition.end(),
-             [] (const Proposition *p1, const Proposition *p2) {
-                 return p1->id < p2->id;
-             });
-        Key key(op.precondition, op.effect);
+        UnaryOperatorInfo &op = unary_operators[i];
+        sort(op.preconditions.begin(), op.preconditions.end());
+        Key key(op.preconditions, op.effect);
         pair<Map::iterator, bool> inserted = unary_operator_index.insert(
             make_pair(key, i));
         if (!inserted.second) {
@@ -131,7 +80,7 @@ void RelaxationHeuristic::simplify() {
         }
     }
 
-    vector<UnaryOperator> old_unary_operators;
+    vector<UnaryOperatorInfo> old_unary_operators;
     old_unary_operators.swap(unary_operators);
 
     for (Map::iterator it = unary_operator_index.begin();
@@ -142,7 +91,7 @@ void RelaxationHeuristic::simplify() {
         if (key.first.size() <= 5) { // HACK! Don't spend too much time here...
             int powerset_size = (1 << key.first.size()) - 1; // -1: only consider proper subsets
             for (int mask = 0; mask < powerset_size; ++mask) {
-                Key dominating_key = make_pair(vector<Proposition *>(), key.second);
+                Key dominating_key = make_pair(vector<PropID>(), key.second);
                 for (size_t i = 0; i < key.first.size(); ++i)
                     if (mask & (1 << i))
                         dominating_key.first.push_back(key.first[i]);
@@ -164,20 +113,305 @@ void RelaxationHeuristic::simplify() {
     }
 
     sort(unary_operators.begin(), unary_operators.end(),
-         [&] (const UnaryOperator &o1, const UnaryOperator &o2) {
+         [&] (const UnaryOperatorInfo &o1, const UnaryOperatorInfo &o2) {
              if (o1.operator_no != o2.operator_no)
                  return o1.operator_no < o2.operator_no;
              if (o1.effect != o2.effect)
-                 return o1.effect->id < o2.effect->id;
+                 return o1.effect < o2.effect;
              if (o1.base_cost != o2.base_cost)
                  return o1.base_cost < o2.base_cost;
-             return lexicographical_compare(o1.precondition.begin(), o1.precondition.end(),
-                                            o2.precondition.begin(), o2.precondition.end(),
-                                            [] (const Proposition *p1, const Proposition *p2) {
-                                                return p1->id < p2->id;
-                                            });
+             return o1.preconditions < o2.preconditions;
          });
 
     cout << " done! [" << unary_operators.size() << " unary operators]" << endl;
 }
+
+/*
+  Store for every key in keys (which are smaller than num_keys) the
+  indices at which it occurs in compressed sparse row format.
+*/
+void build_index(
+    const vector<int> &keys, int num_keys, vector<int> &start, vector<int> &entries) {
+    start.assign(num_keys + 1, 0);
+    for (int key : keys)
+        ++start[key + 1];
+    for (int key = 0; key < num_keys; ++key)
+        start[key + 1] += start[key];
+    entries.resize(keys.size());
+    vector<int> next(start.begin(), start.end() - 1);
+    for (size_t i = 0; i < keys.size(); ++i)
+        entries[next[keys[i]]++] = i;
+}
+}
+
+// construction and destruction
+RelaxedTask::RelaxedTask(const TaskProxy &task_proxy, bool build_achievers) {
+    // Build propositions.
+    num_propositions = 0;
+    VariablesProxy variables = task_proxy.get_variables();
+    proposition_offsets.reserve(variables.size());
+    for (VariableProxy var : variables) {
+        proposition_offsets.push_back(num_propositions);
+        num_propositions += var.get_domain_size();
+    }
+    auto get_prop_id = [&](const FactProxy &fact) {
+        return proposition_offsets[fact.get_variable().get_id()] + fact.get_value();
+    };
+
+    // Build goal propositions.
+    is_goal.resize(num_propositions, false);
+    for (FactProxy goal : task_proxy.get_goals()) {
+        PropID prop = get_prop_id(goal);
+        is_goal[prop] = true;
+        goal_propositions.push_back(prop);
+    }
+
+    // Build unary operators for operators and axioms.
+    vector<UnaryOperatorInfo> unary_operators;
+    auto build_unary_operators = [&](const OperatorProxy &op, int op_no) {
+        int base_cost = op.get_cost();
+        vector<PropID> precondition_props;
+        for (FactProxy precondition : op.get_preconditions()) {
+            precondition_props.push_back(get_prop_id(precondition));
+        }
+        for (EffectProxy effect : op.get_effects()) {
+            PropID effect_prop = get_prop_id(effect.get_fact());
+            EffectConditionsProxy eff_conds = effect.get_conditions();
+            for (FactProxy eff_cond : eff_conds) {
+                precondition_props.push_back(get_prop_id(eff_cond));
+            }
+            unary_operators.emplace_back(precondition_props, effect_prop, op_no, base_cost);
+            precondition_props.erase(precondition_props.end() - eff_conds.size(), precondition_props.end());
+        }
+    };
+    int op_no = 0;
+    for (OperatorProxy op : task_proxy.get_operators())
+        build_unary_operators(op, op_no++);
+    for (OperatorProxy axiom : task_proxy.get_axioms())
+        build_unary_operators(axiom, -1);
+
+    // Simplify unary operators.
+    simplify(unary_operators);
+
+    // Store unary operators in arrays.
+    num_unary_operators = unary_operators.size();
+    precondition_start.reserve(num_unary_operators + 1);
+    op_effects.reserve(num_unary_operators);
+    op_base_costs.reserve(num_unary_operators);
+    op_num_preconditions.reserve(num_unary_operators);
+    op_operator_nos.reserve(num_unary_operators);
+    vector<OpID> precondition_ops;
+    for (OpID op = 0; op < num_unary_operators; ++op) {
+        const UnaryOperatorInfo &info = unary_operators[op];
+        precondition_start.push_back(preconditions.size());
+        preconditions.insert(
+            preconditions.end(), info.preconditions.begin(), info.preconditions.end());
+        precondition_ops.insert(precondition_ops.end(), info.preconditions.size(), op);
+        op_effects.push_back(info.effect);
+        op_base_costs.push_back(info.base_cost);
+        op_num_preconditions.push_back(info.preconditions.size());
+        op_operator_nos.push_back(info.operator_no);
+        if (info.preconditions.empty())
+            precondition_free_operators.push_back(op);
+    }
+    precondition_start.push_back(preconditions.size());
+
+    // Cross-reference unary operators.
+    vector<int> entries;
+    build_index(preconditions, num_propositions, precondition_of_start, entries);
+    precondition_of.reserve(entries.size());
+    for (int entry : entries)
+        precondition_of.push_back(precondition_ops[entry]);
+
+    if (build_achievers)
+        build_index(op_effects, num_propositions, achievers_start, achievers);
+}
+
+RelaxationHeuristic::RelaxationHeuristic(const options::Options &opts)
+    : Heuristic(opts),
+      relaxed_task(make_shared<RelaxedTask>(
+                       task_proxy, opts.get<bool>("incremental", false))),
+      proposition_offsets(relaxed_task->proposition_offsets),
+      achievers_start(relaxed_task->achievers_start),
+      achievers(relaxed_task->achievers),
+      num_propositions(relaxed_task->num_propositions),
+      is_goal(relaxed_task->is_goal),
+      goal_propositions(relaxed_task->goal_propositions),
+      precondition_of_start(relaxed_task->precondition_of_start),
+      precondition_of(relaxed_task->precondition_of),
+      num_unary_operators(relaxed_task->num_unary_operators),
+      precondition_start(relaxed_task->precondition_start),
+      preconditions(relaxed_task->preconditions),
+      op_effects(relaxed_task->op_effects),
+      op_base_costs(relaxed_task->op_base_costs),
+      op_num_preconditions(relaxed_task->op_num_preconditions),
+      op_operator_nos(relaxed_task->op_operator_nos),
+      precondition_free_operators(relaxed_task->precondition_free_operators),
+      incremental(opts.get<bool>("incremental", false)),
+      max_changed_facts(opts.get<int>("max_changed_facts", 0)) {
+    allocate_exploration_data();
+}
+
+RelaxationHeuristic::RelaxationHeuristic(const RelaxationHeuristic &other)
+    : Heuristic(other),
+      relaxed_task(other.relaxed_task),
+      proposition_offsets(relaxed_task->proposition_offsets),
+      achievers_start(relaxed_task->achievers_start),
+      achievers(relaxed_task->achievers),
+      num_propositions(relaxed_task->num_propositions),
+      is_goal(relaxed_task->is_goal),
+      goal_propositions(relaxed_task->goal_propositions),
+      precondition_of_start(relaxed_task->precondition_of_start),
+      precondition_of(relaxed_task->precondition_of),
+      num_unary_operators(relaxed_task->num_unary_operators),
+      precondition_start(relaxed_task->precondition_start),
+      preconditions(relaxed_task->preconditions),
+      op_effects(relaxed_task->op_effects),
+      op_base_costs(relaxed_task->op_base_costs),
+      op_num_preconditions(relaxed_task->op_num_preconditions),
+      op_operator_nos(relaxed_task->op_operator_nos),
+      precondition_free_operators(relaxed_task->precondition_free_operators),
+      incremental(other.incremental),
+      max_changed_facts(other.max_changed_facts) {
+    allocate_exploration_data();
+}
+
+void RelaxationHeuristic::allocate_exploration_data() {
+    prop_costs.resize(num_propositions);
+    prop_reached_by.resize(num_propositions);
+    op_costs.resize(num_unary_operators);
+    op_unsatisfied_preconditions.resize(num_unary_operators);
+}
+
+RelaxationHeuristic::~RelaxationHeuristic() {
+}
+
+bool RelaxationHeuristic::dead_ends_are_reliable() const {
+    return !task_properties::has_axioms(task_proxy);
+}
+
+void RelaxationHeuristic::add_options_to_parser(options::OptionParser &parser) {
+    Heuristic::add_options_to_parser(parser);
+    parser.add_option<bool>(
+        "incremental",
+        "compute the costs of a state by repairing the costs of the "
+        "previously evaluated state where they are affected by the facts "
+        "that differ. This pays off if consecutively evaluated states are "
+        "similar, e.g. siblings in eager search. Preferred operators and "
+        "relaxed plans can differ from a complete exploration if several "
+        "best supporters have the same cost.",
+        "false");
+    parser.add_option<int>(
+        "max_changed_facts",
+        "explore from scratch if more facts than this differ from the "
+        "previously evaluated state (only used with incremental=true)",
+        "8",
+        options::Bounds("0", "infinity"));
+}
+
+PropID RelaxationHeuristic::get_prop_id(const FactProxy &fact) const {
+    int var = fact.get_variable().get_id();
+    int value = fact.get_value();
+    assert(utils::in_bounds(var, proposition_offsets));
+    assert(value >= 0 && value < fact.get_variable().get_domain_size());
+    return get_prop_id(var, value);
+}
+
+void RelaxationHeuristic::set_explored_state(const State &state) {
+    explored_state_values = state.get_values();
+}
+
+bool RelaxationHeuristic::repair_exploration(const State &state) {
+    if (explored_state_values.empty())
+        return false;
+    changed_variables.clear();
+    for (size_t var = 0; var < explored_state_values.size(); ++var) {
+        if (state[var].get_value() != explored_state_values[var]) {
+            changed_variables.push_back(var);
+            if (static_cast<int>(changed_variables.size()) > max_changed_facts)
+                return false;
+        }
+    }
+
+    /*
+      Only the costs of removed facts and of propositions whose best
+      supporter (transitively) depends on them can increase. Forget
+      these costs.
+    */
+    affected_propositions.clear();
+    for (int var : changed_variables) {
+        PropID prop = get_prop_id(var, explored_state_values[var]);
+        assert(prop_costs[prop] == 0 && prop_reached_by[prop] == NO_OP);
+        prop_costs[prop] = -1;
+        affected_propositions.push_back(prop);
+    }
+    for (size_t i = 0; i < affected_propositions.size(); ++i) {
+        PropID prop = affected_propositions[i];
+        for (int j = precondition_of_start[prop]; j < precondition_of_start[prop + 1]; ++j) {
+            OpID op = precondition_of[j];
+            PropID effect = op_effects[op];
+            if (prop_reached_by[effect] == op) {
+                prop_costs[effect] = -1;
+                prop_reached_by[effect] = NO_OP;
+                affected_propositions.push_back(effect);
+            }
+        }
+    }
+
+    // Add the new facts and recompute the forgotten costs from unaffected preconditions.
+    repair_queue.clear();
+    for (int var : changed_variables) {
+        int value = state[var].get_value();
+        PropID prop = get_prop_id(var, value);
+        prop_costs[prop] = 0;
+        prop_reached_by[prop] = NO_OP;
+        repair_queue.push(0, prop);
+        explored_state_values[var] = value;
+    }
+    for (PropID prop : affected_propositions) {
+        int &prop_cost = prop_costs[prop];
+        if (prop_cost != -1)
+            continue;
+        for (int j = achievers_start[prop]; j < achievers_start[prop + 1]; ++j) {
+            OpID op = achievers[j];
+            int cost = compute_operator_cost(op);
+            if (cost != -1 && (prop_cost == -1 || cost < prop_cost)) {
+                op_costs[op] = cost;
+                prop_cost = cost;
+                prop_reached_by[prop] = op;
+            }
+        }
+        if (prop_cost != -1)
+            repair_queue.push(prop_cost, prop);
+    }
+
+    /*
+      Propagate the decreased costs in order of increasing cost. Costs
+      of unaffected propositions can decrease as well, so a proposition
+      may be processed more than once.
+    */
+    while (!repair_queue.empty()) {
+        pair<int, PropID> top_pair = repair_queue.pop();
+        PropID prop = top_pair.second;
+        int prop_cost = prop_costs[prop];
+        if (prop_cost != top_pair.first)
+            continue;
+        for (int j = precondition_of_start[prop]; j < precondition_of_start[prop + 1]; ++j) {
+            OpID op = precondition_of[j];
+            PropID effect = op_effects[op];
+            int &effect_cost = prop_costs[effect];
+            // The cost of op is at least its base cost + prop_cost.
+            if (effect_cost != -1 && effect_cost <= op_base_costs[op] + prop_cost)
+                continue;
+            int cost = compute_operator_cost(op);
+            if (cost != -1 && (effect_cost == -1 || cost < effect_cost)) {
+                op_costs[op] = cost;
+                effect_cost = cost;
+                prop_reached_by[effect] = op;
+                repair_queue.push(cost, effect);
+            }
+        }
+    }
+    return true;
+}
 }
@@ -3,63 +3,149 @@
 
 #include "../heuristic.h"
 
+#include "../algorithms/priority_queues.h"
+
+#include <memory>
 #include <vector>
 
 class FactProxy;
 class GlobalState;
-class OperatorProxy;
+class State;
 
 namespace relaxation_heuristic {
-struct Proposition;
-struct UnaryOperator;
-
-struct UnaryOperator {
-    int operator_no; // -1 for axioms; index into the task's operators otherwise
-    std::vector<Proposition *> precondition;
-    Proposition *effect;
-    int base_cost;
-
-    int unsatisfied_preconditions;
-    int cost; // Used for h^max cost or h^add cost;
-              // includes operator cost (base_cost)
-    UnaryOperator(const std::vector<Proposition *> &pre, Proposition *eff,
-                  int operator_no_, int base)
-        : operator_no(operator_no_), precondition(pre), effect(eff),
-          base_cost(base) {}
-};
+// Propositions and unary operators are identified by their index.
+using PropID = int;
+using OpID = int;
 
-struct Proposition {
-    bool is_goal;
-    int id;
-    std::vector<UnaryOperator *> precondition_of;
-
-    int cost; // Used for h^max cost or h^add cost
-    UnaryOperator *reached_by;
-    bool marked; // used when computing preferred operators for h^add and h^FF
-
-    Proposition(int id_) {
-        id = id_;
-        is_goal = false;
-        cost = -1;
-        reached_by = 0;
-        marked = false;
-    }
+const OpID NO_OP = -1;
+
+/*
+  The relaxed task is stored as a structure of arrays indexed by PropID
+  and OpID, so that the explorations scan dense memory. The preconditions
+  of unary operators and the unary operators that have a proposition as
+  precondition are stored in compressed sparse row format: the entries
+  for i are those in [start[i], start[i + 1]).
+
+  Each fact (var, value) is a proposition, and the facts of a variable
+  have consecutive IDs (see get_prop_id).
+
+  The relaxed task does not change after construction, so thread-local
+  copies of a heuristic share it (see create_thread_local_copy).
+*/
+struct RelaxedTask {
+    std::vector<int> proposition_offsets;
+    int num_propositions;
+    std::vector<char> is_goal;
+    std::vector<PropID> goal_propositions;
+    std::vector<int> precondition_of_start;
+    std::vector<OpID> precondition_of;
+
+    int num_unary_operators;
+    std::vector<int> precondition_start;
+    std::vector<PropID> preconditions;
+    std::vector<PropID> op_effects;
+    std::vector<int> op_base_costs;
+    std::vector<int> op_num_preconditions;
+    // -1 for axioms; index into the task's operators otherwise
+    std::vector<int> op_operator_nos;
+    std::vector<OpID> precondition_free_operators;
+
+    /*
+      The unary operators with the proposition as effect in compressed
+      sparse row format, for repairing explorations (only built for
+      incremental exploration).
+    */
+    std::vector<int> achievers_start;
+    std::vector<OpID> achievers;
+
+    RelaxedTask(const TaskProxy &task_proxy, bool build_achievers);
 };
 
 class RelaxationHeuristic : public Heuristic {
-    void build_unary_operators(const OperatorProxy &op, int op_no);
-    void simplify();
+    std::shared_ptr<const RelaxedTask> relaxed_task;
+    const std::vector<int> &proposition_offsets;
+    const std::vector<int> &achievers_start;
+    const std::vector<OpID> &achievers;
+
+    /*
+      Data for repairing the exploration of the previous state (see
+      repair_exploration).
+    */
+    // Values of the state whose complete exploration is stored (empty if none).
+    std::vector<int> explored_state_values;
+    std::vector<int> changed_variables;
+    std::vector<PropID> affected_propositions;
+    priority_queues::RadixQueue<PropID> repair_queue;
+
+    void allocate_exploration_data();
+
 protected:
-    std::vector<UnaryOperator> unary_operators;
-    std::vector<std::vector<Proposition>> propositions;
-    std::vector<Proposition *> goal_propositions;
+    // The members of the relaxed task (see RelaxedTask).
+    const int num_propositions;
+    const std::vector<char> &is_goal;
+    const std::vector<PropID> &goal_propositions;
+    const std::vector<int> &precondition_of_start;
+    const std::vector<OpID> &precondition_of;
+
+    const int num_unary_operators;
+    const std::vector<int> &precondition_start;
+    const std::vector<PropID> &preconditions;
+    const std::vector<PropID> &op_effects;
+    const std::vector<int> &op_base_costs;
+    const std::vector<int> &op_num_preconditions;
+    const std::vector<int> &op_operator_nos;
+    const std::vector<OpID> &precondition_free_operators;
+
+    /*
+      Exploration data. Costs are h^max or h^add costs (-1 for
+      unreached propositions). Operator costs include the base cost.
+    */
+    std::vector<int> prop_costs;
+    std::vector<OpID> prop_reached_by;
+    std::vector<int> op_costs;
+    std::vector<int> op_unsatisfied_preconditions;
+
+    /*
+      With incremental exploration, the explorations of h^add and h^max
+      do not stop once all goals are reached, so that the costs of all
+      propositions (and their best supporters in prop_reached_by) are
+      known. The exploration of the next state then only repairs the
+      costs affected by the facts that differ between the two states,
+      unless more than max_changed_facts facts differ.
+    */
+    const bool incremental;
+    const int max_changed_facts;
+
+    PropID get_prop_id(int var, int value) const {
+        return proposition_offsets[var] + value;
+    }
+    PropID get_prop_id(const FactProxy &fact) const;
 
-    Proposition *get_proposition(const FactProxy &fact);
     virtual int compute_heuristic(const GlobalState &state) = 0;
+
+    /*
+      Return the cost of op (including its base cost) for the current
+      costs of its preconditions, or -1 if a precondition is unreached.
+    */
+    virtual int compute_operator_cost(OpID op) = 0;
+    // Remember that the current costs are the complete exploration of state.
+    void set_explored_state(const State &state);
+    /*
+      Turn the complete exploration of the previous state into the
+      complete exploration of state. Return false without changing
+      anything if there is no previous exploration or too many facts
+      differ.
+    */
+    bool repair_exploration(const State &state);
+
+    // The copy shares the relaxed task with other.
+    explicit RelaxationHeuristic(const RelaxationHeuristic &other);
 public:
     RelaxationHeuristic(const options::Options &opts);
     virtual ~RelaxationHeuristic();
     virtual bool dead_ends_are_reliable() const;
+
+    static void add_options_to_parser(options::OptionParser &parser);
 };
 }
 
@@ -163,6 +163,25 @@ void LPSolver::load_problem(LPObjectiveSense sense,
     clear_temporary_data();
 }
 
+void LPSolver::load_problem(const LPSolver &other) {
+    assert(!other.has_temporary_constraints_);
+    is_initialized = false;
+    is_solved = false;
+    num_permanent_constraints = other.num_permanent_constraints;
+    const OsiSolverInterface &other_solver = *other.lp_solver;
+    try {
+        lp_solver->setObjSense(other_solver.getObjSense());
+        lp_solver->loadProblem(*other_solver.getMatrixByCol(),
+                               other_solver.getColLower(),
+                               other_solver.getColUpper(),
+                               other_solver.getObjCoefficients(),
+                               other_solver.getRowLower(),
+                               other_solver.getRowUpper());
+    } catch (CoinError &error) {
+        handle_coin_error(error);
+    }
+}
+
 void LPSolver::add_temporary_constraints(const vector<LPConstraint> &constraints) {
     if (!constraints.empty()) {
         clear_temporary_data();
@@ -114,6 +114,11 @@ public:
                   LPObjectiveSense sense,
                   const std::vector<LPVariable> &variables,
                   const std::vector<LPConstraint> &constraints))
+    /*
+      Load the problem of other, which must not have temporary
+      constraints. The solvers may be of different types.
+    */
+    LP_METHOD(void load_problem(const LPSolver &other))
     LP_METHOD(void add_temporary_constraints(const std::vector<LPConstraint> &constraints))
     LP_METHOD(void clear_temporary_constraints())
     LP_METHOD(double get_infinity() const)
@@ -1,12 +1,17 @@
 #ifndef OPEN_LIST_H
 #define OPEN_LIST_H
 
+#include <iostream>
 #include <set>
+#include <string>
 #include <vector>
 
+#include "checkpoint.h"
 #include "evaluation_context.h"
 #include "operator_id.h"
 
+#include "utils/system.h"
+
 class StateID;
 
 
@@ -124,6 +129,41 @@ public:
     virtual bool is_dead_end(EvaluationContext &eval_context) const = 0;
     virtual bool is_reliable_dead_end(
         EvaluationContext &eval_context) const = 0;
+
+    /*
+      Evaluate the evaluators of this open list for several evaluation
+      contexts at once (see EvaluationContext::evaluate_batch), so that
+      is_dead_end and insert only look up cached results for these
+      contexts. The default implementation does nothing, in which case
+      the evaluators are evaluated one context at a time. The thread
+      pool (may be null) is passed on to the evaluators.
+    */
+    virtual void evaluate_batch(
+        const std::vector<EvaluationContext *> &eval_contexts,
+        utils::ThreadPool *thread_pool);
+
+    /*
+      Checkpoints (see checkpoint.h): save writes all entries together
+      with their keys, so load can restore them into an empty open list
+      without evaluating any states. Only open lists for which
+      supports_checkpoints returns true implement save and load. They
+      also add the evaluators with per-state information that they use
+      (directly or indirectly) to evals in get_checkpointed_evaluators,
+      and return a description of their type and options (excluding the
+      evaluators) in get_checkpoint_type.
+    */
+    virtual bool supports_checkpoints() const;
+    virtual std::string get_checkpoint_type() const;
+    virtual void save(checkpoint::Writer &writer) const;
+    virtual void load(checkpoint::Reader &reader);
+    virtual void get_checkpointed_evaluators(std::vector<Evaluator *> &evals);
+
+    /*
+      Return true if the open list adds the cost and the regression
+      estimate of the operator stack of an entry to its key (only
+      meaningful for open lists of search with backward analysis).
+    */
+    virtual bool supports_stack_estimates() const;
 };
 
 
@@ -159,4 +199,40 @@ bool OpenList<Entry>::only_contains_preferred_entries() const {
     return only_preferred;
 }
 
+template<class Entry>
+void OpenList<Entry>::evaluate_batch(
+    const std::vector<EvaluationContext *> &, utils::ThreadPool *) {
+}
+
+template<class Entry>
+bool OpenList<Entry>::supports_checkpoints() const {
+    return false;
+}
+
+template<class Entry>
+std::string OpenList<Entry>::get_checkpoint_type() const {
+    return "";
+}
+
+template<class Entry>
+void OpenList<Entry>::save(checkpoint::Writer &) const {
+    std::cerr << "This open list does not support checkpoints." << std::endl;
+    utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+}
+
+template<class Entry>
+void OpenList<Entry>::load(checkpoint::Reader &) {
+    std::cerr << "This open list does not support checkpoints." << std::endl;
+    utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+}
+
+template<class Entry>
+void OpenList<Entry>::get_checkpointed_evaluators(std::vector<Evaluator *> &) {
+}
+
+template<class Entry>
+bool OpenList<Entry>::supports_stack_estimates() const {
+    return false;
+}
+
 #endif
@@ -39,6 +39,15 @@ public:
         EvaluationContext &eval_context) const override;
     virtual bool is_reliable_dead_end(
         EvaluationContext &eval_context) const override;
+    virtual void evaluate_batch(
+        const vector<EvaluationContext *> &eval_contexts,
+        utils::ThreadPool *thread_pool) override;
+    virtual bool supports_checkpoints() const override;
+    virtual string get_checkpoint_type() const override;
+    virtual void save(checkpoint::Writer &writer) const override;
+    virtual void load(checkpoint::Reader &reader) override;
+    virtual void get_checkpointed_evaluators(vector<Evaluator *> &evals) override;
+    virtual bool supports_stack_estimates() const override;
 };
 
 
@@ -127,6 +136,65 @@ bool AlternationOpenList<Entry>::is_reliable_dead_end(
     return false;
 }
 
+template<class Entry>
+void AlternationOpenList<Entry>::evaluate_batch(
+    const vector<EvaluationContext *> &eval_contexts,
+    utils::ThreadPool *thread_pool) {
+    for (const auto &sublist : open_lists)
+        sublist->evaluate_batch(eval_contexts, thread_pool);
+}
+
+template<class Entry>
+bool AlternationOpenList<Entry>::supports_checkpoints() const {
+    for (const auto &sublist : open_lists)
+        if (!sublist->supports_checkpoints())
+            return false;
+    return true;
+}
+
+template<class Entry>
+string AlternationOpenList<Entry>::get_checkpoint_type() const {
+    string type = "alt(";
+    for (size_t i = 0; i < open_lists.size(); ++i) {
+        if (i > 0)
+            type += ", ";
+        type += open_lists[i]->get_checkpoint_type();
+    }
+    return type + ")";
+}
+
+template<class Entry>
+void AlternationOpenList<Entry>::save(checkpoint::Writer &writer) const {
+    writer.write_vector(priorities);
+    for (const auto &sublist : open_lists)
+        sublist->save(writer);
+}
+
+template<class Entry>
+void AlternationOpenList<Entry>::load(checkpoint::Reader &reader) {
+    vector<int> saved_priorities = reader.read_vector<int>();
+    if (saved_priorities.size() != open_lists.size())
+        reader.fail("the open list has a different number of sublists");
+    priorities = saved_priorities;
+    for (const auto &sublist : open_lists)
+        sublist->load(reader);
+}
+
+template<class Entry>
+void AlternationOpenList<Entry>::get_checkpointed_evaluators(
+    vector<Evaluator *> &evals) {
+    for (const auto &sublist : open_lists)
+        sublist->get_checkpointed_evaluators(evals);
+}
+
+template<class Entry>
+bool AlternationOpenList<Entry>::supports_stack_estimates() const {
+    for (const auto &sublist : open_lists)
+        if (!sublist->supports_stack_estimates())
+            return false;
+    return true;
+}
+
 
 AlternationOpenListFactory::AlternationOpenListFactory(const Options &options)
     : options(options) {
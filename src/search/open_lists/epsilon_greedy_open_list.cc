@@ -54,6 +54,9 @@ public:
         EvaluationContext &eval_context) const override;
     virtual bool is_reliable_dead_end(
         EvaluationContext &eval_context) const override;
+    virtual void evaluate_batch(
+        const vector<EvaluationContext *> &eval_contexts,
+        utils::ThreadPool *thread_pool) override;
     virtual void get_path_dependent_evaluators(set<Evaluator *> &evals) override;
     virtual bool empty() const override;
     virtual void clear() override;
@@ -118,6 +121,13 @@ bool EpsilonGreedyOpenList<Entry>::is_reliable_dead_end(
     return is_dead_end(eval_context) && evaluator->dead_ends_are_reliable();
 }
 
+template<class Entry>
+void EpsilonGreedyOpenList<Entry>::evaluate_batch(
+    const vector<EvaluationContext *> &eval_contexts,
+    utils::ThreadPool *thread_pool) {
+    EvaluationContext::evaluate_batch(evaluator.get(), eval_contexts, thread_pool);
+}
+
 template<class Entry>
 void EpsilonGreedyOpenList<Entry>::get_path_dependent_evaluators(
     set<Evaluator *> &evals) {
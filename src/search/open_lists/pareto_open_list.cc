@@ -55,6 +55,9 @@ public:
         EvaluationContext &eval_context) const override;
     virtual bool is_reliable_dead_end(
         EvaluationContext &eval_context) const override;
+    virtual void evaluate_batch(
+        const vector<EvaluationContext *> &eval_contexts,
+        utils::ThreadPool *thread_pool) override;
 
     static OpenList<Entry> *_parse(OptionParser &p);
 };
@@ -221,6 +224,14 @@ bool ParetoOpenList<Entry>::is_reliable_dead_end(
     return false;
 }
 
+template<class Entry>
+void ParetoOpenList<Entry>::evaluate_batch(
+    const vector<EvaluationContext *> &eval_contexts,
+    utils::ThreadPool *thread_pool) {
+    for (const shared_ptr<Evaluator> &evaluator : evaluators)
+        EvaluationContext::evaluate_batch(evaluator.get(), eval_contexts, thread_pool);
+}
+
 ParetoOpenListFactory::ParetoOpenListFactory(
     const Options &options)
     : options(options) {
@@ -45,6 +45,15 @@ public:
         EvaluationContext &eval_context) const override;
     virtual bool is_reliable_dead_end(
         EvaluationContext &eval_context) const override;
+    virtual void evaluate_batch(
+        const vector<EvaluationContext *> &eval_contexts,
+        utils::ThreadPool *thread_pool) override;
+    virtual bool supports_checkpoints() const override;
+    virtual string get_checkpoint_type() const override;
+    virtual void save(checkpoint::Writer &writer) const override;
+    virtual void load(checkpoint::Reader &reader) override;
+    virtual void get_checkpointed_evaluators(vector<Evaluator *> &evals) override;
+    virtual bool supports_stack_estimates() const override;
 };
 
 
@@ -115,14 +124,71 @@ bool StandardScalarOpenList<Entry>::is_reliable_dead_end(
     return is_dead_end(eval_context) && evaluator->dead_ends_are_reliable();
 }
 
+template<class Entry>
+void StandardScalarOpenList<Entry>::evaluate_batch(
+    const vector<EvaluationContext *> &eval_contexts,
+    utils::ThreadPool *thread_pool) {
+    EvaluationContext::evaluate_batch(evaluator.get(), eval_contexts, thread_pool);
+}
+
+template<class Entry>
+bool StandardScalarOpenList<Entry>::supports_checkpoints() const {
+    return true;
+}
+
+template<class Entry>
+string StandardScalarOpenList<Entry>::get_checkpoint_type() const {
+    return this->only_contains_preferred_entries() ? "single(pref_only)" : "single";
+}
+
+template<class Entry>
+void StandardScalarOpenList<Entry>::save(checkpoint::Writer &writer) const {
+    writer.write(buckets.size());
+    for (const auto &key_and_bucket : buckets) {
+        writer.write(key_and_bucket.first);
+        writer.write(key_and_bucket.second.size());
+        for (const Entry &entry : key_and_bucket.second)
+            writer.write(entry);
+    }
+}
+
+template<class Entry>
+void StandardScalarOpenList<Entry>::load(checkpoint::Reader &reader) {
+    assert(empty());
+    size_t num_buckets = reader.read<size_t>();
+    for (size_t i = 0; i < num_buckets; ++i) {
+        Bucket &bucket = buckets[reader.read<int>()];
+        size_t bucket_size = reader.read<size_t>();
+        for (size_t j = 0; j < bucket_size; ++j)
+            bucket.push_back(reader.read<Entry>());
+        size += bucket_size;
+    }
+}
+
+template<class Entry>
+void StandardScalarOpenList<Entry>::get_checkpointed_evaluators(
+    vector<Evaluator *> &evals) {
+    evaluator->get_checkpointed_evaluators(evals);
+}
+
+template<class Entry>
+bool StandardScalarOpenList<Entry>::supports_stack_estimates() const {
+    return false;
+}
+
 // specialised functions
 
+template<>
+bool StandardScalarOpenList<fwdbwd::FwdbwdNode>::supports_stack_estimates() const {
+    return true;
+}
+
 template<>
 void StandardScalarOpenList<fwdbwd::FwdbwdNode>::do_insertion(
     EvaluationContext &eval_context, const fwdbwd::FwdbwdNode &entry) {
     int key = eval_context.get_evaluator_value(evaluator.get());
     if(entry.get_stack_pointer() != NULL)
-        key += entry.get_stack_pointer()->get_cost();
+        key += entry.get_stack_pointer()->get_cost() + entry.get_stack_estimate();
     fwdbwd_buckets[key].insert(entry);
     ++size;
 }
@@ -149,6 +215,33 @@ void StandardScalarOpenList<fwdbwd::FwdbwdNode>::clear() {
     size = 0;
 }
 
+template<>
+void StandardScalarOpenList<fwdbwd::FwdbwdNode>::save(
+    checkpoint::Writer &writer) const {
+    writer.write(fwdbwd_buckets.size());
+    for (const auto &key_and_bucket : fwdbwd_buckets) {
+        writer.write(key_and_bucket.first);
+        writer.write(key_and_bucket.second.size());
+        for (const fwdbwd::FwdbwdNode &entry : key_and_bucket.second)
+            writer.write(entry);
+    }
+}
+
+template<>
+void StandardScalarOpenList<fwdbwd::FwdbwdNode>::load(
+    checkpoint::Reader &reader) {
+    assert(empty());
+    size_t num_buckets = reader.read<size_t>();
+    for (size_t i = 0; i < num_buckets; ++i) {
+        fwdbwdBucket &bucket = fwdbwd_buckets[reader.read<int>()];
+        size_t bucket_size = reader.read<size_t>();
+        // Equivalent entries are inserted after each other, which keeps their order.
+        for (size_t j = 0; j < bucket_size; ++j)
+            bucket.insert(bucket.end(), reader.read<fwdbwd::FwdbwdNode>());
+        size += bucket_size;
+    }
+}
+
 
 StandardScalarOpenListFactory::StandardScalarOpenListFactory(
     const Options &options)
@@ -49,6 +49,14 @@ public:
         EvaluationContext &eval_context) const override;
     virtual bool is_reliable_dead_end(
         EvaluationContext &eval_context) const override;
+    virtual void evaluate_batch(
+        const vector<EvaluationContext *> &eval_contexts,
+        utils::ThreadPool *thread_pool) override;
+    virtual bool supports_checkpoints() const override;
+    virtual string get_checkpoint_type() const override;
+    virtual void save(checkpoint::Writer &writer) const override;
+    virtual void load(checkpoint::Reader &reader) override;
+    virtual void get_checkpointed_evaluators(vector<Evaluator *> &evals) override;
 };
 
 
@@ -138,6 +146,63 @@ bool TieBreakingOpenList<Entry>::is_reliable_dead_end(
     return false;
 }
 
+template<class Entry>
+void TieBreakingOpenList<Entry>::evaluate_batch(
+    const vector<EvaluationContext *> &eval_contexts,
+    utils::ThreadPool *thread_pool) {
+    for (const shared_ptr<Evaluator> &evaluator : evaluators)
+        EvaluationContext::evaluate_batch(evaluator.get(), eval_contexts, thread_pool);
+}
+
+template<class Entry>
+bool TieBreakingOpenList<Entry>::supports_checkpoints() const {
+    return true;
+}
+
+template<class Entry>
+string TieBreakingOpenList<Entry>::get_checkpoint_type() const {
+    string type = "tiebreaking";
+    if (this->only_contains_preferred_entries())
+        type += "(pref_only)";
+    if (allow_unsafe_pruning)
+        type += "(unsafe_pruning)";
+    return type;
+}
+
+template<class Entry>
+void TieBreakingOpenList<Entry>::save(checkpoint::Writer &writer) const {
+    writer.write(buckets.size());
+    for (const auto &key_and_bucket : buckets) {
+        writer.write_vector(key_and_bucket.first);
+        writer.write(key_and_bucket.second.size());
+        for (const Entry &entry : key_and_bucket.second)
+            writer.write(entry);
+    }
+}
+
+template<class Entry>
+void TieBreakingOpenList<Entry>::load(checkpoint::Reader &reader) {
+    assert(empty());
+    size_t num_buckets = reader.read<size_t>();
+    for (size_t i = 0; i < num_buckets; ++i) {
+        vector<int> key = reader.read_vector<int>();
+        if (static_cast<int>(key.size()) != dimension())
+            reader.fail("the open list uses a different number of evaluators");
+        Bucket &bucket = buckets[key];
+        size_t bucket_size = reader.read<size_t>();
+        for (size_t j = 0; j < bucket_size; ++j)
+            bucket.push_back(reader.read<Entry>());
+        size += bucket_size;
+    }
+}
+
+template<class Entry>
+void TieBreakingOpenList<Entry>::get_checkpointed_evaluators(
+    vector<Evaluator *> &evals) {
+    for (const shared_ptr<Evaluator> &evaluator : evaluators)
+        evaluator->get_checkpointed_evaluators(evals);
+}
+
 TieBreakingOpenListFactory::TieBreakingOpenListFactory(const Options &options)
     : options(options) {
 }
@@ -43,6 +43,9 @@ public:
     virtual bool is_dead_end(EvaluationContext &eval_context) const override;
     virtual bool is_reliable_dead_end(
         EvaluationContext &eval_context) const override;
+    virtual void evaluate_batch(
+        const vector<EvaluationContext *> &eval_contexts,
+        utils::ThreadPool *thread_pool) override;
     virtual void get_path_dependent_evaluators(set<Evaluator *> &evals) override;
 };
 
@@ -127,6 +130,14 @@ bool TypeBasedOpenList<Entry>::is_reliable_dead_end(
     return false;
 }
 
+template<class Entry>
+void TypeBasedOpenList<Entry>::evaluate_batch(
+    const vector<EvaluationContext *> &eval_contexts,
+    utils::ThreadPool *thread_pool) {
+    for (const shared_ptr<Evaluator> &evaluator : evaluators)
+        EvaluationContext::evaluate_batch(evaluator.get(), eval_contexts, thread_pool);
+}
+
 template<class Entry>
 void TypeBasedOpenList<Entry>::get_path_dependent_evaluators(
     set<Evaluator *> &evals) {
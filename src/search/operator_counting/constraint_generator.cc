@@ -9,6 +9,10 @@ void ConstraintGenerator::initialize_constraints(
     const shared_ptr<AbstractTask> &, vector<lp::LPConstraint> &, double) {
 }
 
+shared_ptr<ConstraintGenerator> ConstraintGenerator::create_thread_local_copy() {
+    return nullptr;
+}
+
 static PluginTypePlugin<ConstraintGenerator> _type_plugin(
     "ConstraintGenerator",
     // TODO: Replace empty string by synopsis for the wiki page.
@@ -27,7 +27,8 @@ namespace operator_counting {
       Example: constraints from landmarks generated for a given state, e.g.
       using the LM-Cut method.
 */
-class ConstraintGenerator {
+class ConstraintGenerator
+    : public std::enable_shared_from_this<ConstraintGenerator> {
 public:
     virtual ~ConstraintGenerator() = default;
 
@@ -51,6 +52,16 @@ public:
     */
     virtual bool update_constraints(const State &state,
                                     lp::LPSolver &lp_solver) = 0;
+
+    /*
+      Called after initialization to get a generator for a thread-local
+      copy of the heuristic, whose LP has the same permanent constraints.
+      The copy calls update_constraints on another thread. Generators
+      that do not change in update_constraints can return themselves.
+      The default returns nullptr, which means that the heuristic cannot
+      be used with several evaluation threads.
+    */
+    virtual std::shared_ptr<ConstraintGenerator> create_thread_local_copy();
 };
 }
 
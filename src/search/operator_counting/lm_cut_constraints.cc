@@ -48,6 +48,16 @@ bool LMCutConstraints::update_constraints(const State &state,
     }
 }
 
+shared_ptr<ConstraintGenerator> LMCutConstraints::create_thread_local_copy() {
+    assert(landmark_generator);
+    shared_ptr<LMCutConstraints> copy = make_shared<LMCutConstraints>();
+    // The copy shares the relaxed task of the landmark generator.
+    copy->landmark_generator =
+        utils::make_unique_ptr<lm_cut_heuristic::LandmarkCutLandmarks>(
+            *landmark_generator);
+    return copy;
+}
+
 static shared_ptr<ConstraintGenerator> _parse(OptionParser &parser) {
     parser.document_synopsis(
         "LM-cut landmark constraints",
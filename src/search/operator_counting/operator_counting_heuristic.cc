@@ -16,7 +16,8 @@ OperatorCountingHeuristic::OperatorCountingHeuristic(const Options &opts)
     : Heuristic(opts),
       constraint_generators(
           opts.get_list<shared_ptr<ConstraintGenerator>>("constraint_generators")),
-      lp_solver(lp::LPSolverType(opts.get_enum("lpsolver"))) {
+      lp_solver_type(lp::LPSolverType(opts.get_enum("lpsolver"))),
+      lp_solver(lp_solver_type) {
     vector<lp::LPVariable> variables;
     double infinity = lp_solver.get_infinity();
     for (OperatorProxy op : task_proxy.get_operators()) {
@@ -30,9 +31,30 @@ OperatorCountingHeuristic::OperatorCountingHeuristic(const Options &opts)
     lp_solver.load_problem(lp::LPObjectiveSense::MINIMIZE, variables, constraints);
 }
 
+OperatorCountingHeuristic::OperatorCountingHeuristic(
+    const OperatorCountingHeuristic &other)
+    : Heuristic(other),
+      lp_solver_type(other.lp_solver_type),
+      lp_solver(lp_solver_type) {
+    lp_solver.load_problem(other.lp_solver);
+}
+
 OperatorCountingHeuristic::~OperatorCountingHeuristic() {
 }
 
+shared_ptr<Heuristic> OperatorCountingHeuristic::create_thread_local_copy() const {
+    shared_ptr<OperatorCountingHeuristic> copy(
+        new OperatorCountingHeuristic(*this));
+    for (const auto &generator : constraint_generators) {
+        shared_ptr<ConstraintGenerator> generator_copy =
+            generator->create_thread_local_copy();
+        if (!generator_copy)
+            return nullptr;
+        copy->constraint_generators.push_back(generator_copy);
+    }
+    return copy;
+}
+
 int OperatorCountingHeuristic::compute_heuristic(const GlobalState &global_state) {
     State state = convert_global_state(global_state);
     return compute_heuristic(state);
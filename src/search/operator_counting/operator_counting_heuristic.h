@@ -17,10 +17,18 @@ class ConstraintGenerator;
 
 class OperatorCountingHeuristic : public Heuristic {
     std::vector<std::shared_ptr<ConstraintGenerator>> constraint_generators;
+    const lp::LPSolverType lp_solver_type;
     lp::LPSolver lp_solver;
 protected:
     virtual int compute_heuristic(const GlobalState &global_state) override;
     int compute_heuristic(const State &state);
+
+    /*
+      The copy gets its own LP solver, into which the LP of other is
+      loaded, and the constraint generators for thread-local copies.
+    */
+    explicit OperatorCountingHeuristic(const OperatorCountingHeuristic &other);
+    virtual std::shared_ptr<Heuristic> create_thread_local_copy() const override;
 public:
     explicit OperatorCountingHeuristic(const options::Options &opts);
     ~OperatorCountingHeuristic();
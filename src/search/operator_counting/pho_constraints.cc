@@ -65,6 +65,11 @@ bool PhOConstraints::update_constraints(const State &state,
     return false;
 }
 
+shared_ptr<ConstraintGenerator> PhOConstraints::create_thread_local_copy() {
+    // update_constraints only reads the PDBs.
+    return shared_from_this();
+}
+
 static shared_ptr<ConstraintGenerator> _parse(OptionParser &parser) {
     parser.document_synopsis(
         "Posthoc optimization constraints",
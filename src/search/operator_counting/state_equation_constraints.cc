@@ -112,6 +112,11 @@ bool StateEquationConstraints::update_constraints(const State &state,
     return false;
 }
 
+shared_ptr<ConstraintGenerator> StateEquationConstraints::create_thread_local_copy() {
+    // update_constraints only reads the propositions.
+    return shared_from_this();
+}
+
 static shared_ptr<ConstraintGenerator> _parse(OptionParser &parser) {
     parser.document_synopsis(
         "State equation constraints",
@@ -1,5 +1,7 @@
 #include "operator_id.h"
 
+#include "abstract_task.h"
+
 #include <ostream>
 
 using namespace std;
@@ -27,6 +29,11 @@ OpStackNode::OpStackNode(OperatorID operator_id, OpStackNode* parent, int op_cos
 	}
 }
 
+OpStackNode::~OpStackNode(){
+	for(auto &op_and_child: children)
+		delete op_and_child.second;
+}
+
 OperatorID OpStackNode::get_operator(){
 	return op_id;
 }
@@ -66,3 +73,30 @@ bool OpStackNode::store_state(StateID state_id){
 	data = state_storage.insert(state_id);
 	return data.second;
 }
+
+void OpStackNode::set_subgoal(vector<FactPair> &&facts){
+	subgoal.reset(new vector<FactPair>(move(facts)));
+}
+
+namespace fwdbwd{
+    FwdbwdNode::FwdbwdNode(StateID state_id, OperatorID operator_id, OpStackNode* op_stack_node, int g_value,
+                           int stack_estimate_value):
+    id(state_id), op_id(operator_id)
+    {
+        op_stack = op_stack_node;
+        state_g_value = g_value;
+        stack_estimate = stack_estimate_value;
+    }
+
+    bool FwdbwdNode::operator<(const FwdbwdNode& rhs) const{
+    
+        if(op_stack == NULL && rhs.get_stack_pointer() == NULL)
+            return state_g_value < rhs.get_g();
+
+        else if(op_stack != NULL && rhs.get_stack_pointer() != NULL)
+            return op_stack->get_depth() < rhs.get_stack_pointer()->get_depth();
+    
+        else
+            return (op_stack == NULL)? true: false;
+    }
+}
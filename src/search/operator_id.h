@@ -4,6 +4,7 @@
 #include "utils/hash.h"
 
 #include <iostream>
+#include <memory>
 
 #include <vector>
 #include <unordered_set>
@@ -74,6 +75,8 @@ struct hash<OperatorID> {
 };
 }
 
+struct FactPair;
+
 class OpStackNode{
 
   // stores the value of the operator it represents
@@ -90,19 +93,33 @@ class OpStackNode{
   // stores state for duplicate detection
   std::unordered_set<StateID> state_storage;
 
+  // regressed subgoal (see fwdbwd::RegressionStackEvaluator), computed on demand
+  std::unique_ptr<std::vector<FactPair>> subgoal;
+
 public:
   OpStackNode(OperatorID operator_id, OpStackNode* parent, int op_cost=0);
+  // deletes the whole subtree below this node
+  ~OpStackNode();
+  OpStackNode(const OpStackNode &) = delete;
+  OpStackNode &operator=(const OpStackNode &) = delete;
 
   OperatorID get_operator();
   OpStackNode* get_parent();
   int get_depth();
   int get_cost();
 
+  const std::unordered_map<OperatorID, OpStackNode*> &get_children() const {return children;}
+  const std::unordered_set<StateID> &get_states() const {return state_storage;}
+
   /* generates child, pair.second is false if state already requested here */
   std::pair<OpStackNode*, bool> gen_child(OperatorID operator_id, StateID state_id, int op_cost);
 
   // returns false if the state if already there, else true
   bool store_state(StateID state_id);
+
+  // returns NULL if the subgoal has not been set yet
+  const std::vector<FactPair> *get_subgoal() const {return subgoal.get();}
+  void set_subgoal(std::vector<FactPair> &&facts);
 };
 
 namespace fwdbwd{
@@ -112,12 +129,16 @@ namespace fwdbwd{
         OperatorID op_id;
         OpStackNode* op_stack;
         int state_g_value;
+        // estimated distance of the stack from being applicable, added to the open list key
+        int stack_estimate;
     public:
-        FwdbwdNode(StateID state_id, OperatorID operator_id, OpStackNode* op_stack_node, int g_value);
+        FwdbwdNode(StateID state_id, OperatorID operator_id, OpStackNode* op_stack_node, int g_value,
+                   int stack_estimate_value=0);
         StateID get_state() const {return id;}
         OperatorID get_operator() const {return op_id;}
         OpStackNode* get_stack_pointer() const {return op_stack;}
         int get_g() const{return state_g_value;}
+        int get_stack_estimate() const{return stack_estimate;}
 
         bool operator<(const FwdbwdNode& rhs) const;
     };
@@ -44,6 +44,9 @@ static shared_ptr<SearchEngine> parse_cmd_line_aux(
     string plan_filename = "sas_plan";
     int num_previously_generated_plans = 0;
     bool is_part_of_anytime_portfolio = false;
+    string checkpoint_filename;
+    int checkpoint_interval = -1;
+    string resume_filename;
     Predefinitions predefinitions;
 
     shared_ptr<SearchEngine> engine;
@@ -122,16 +125,41 @@ static shared_ptr<SearchEngine> parse_cmd_line_aux(
             num_previously_generated_plans = parse_int_arg(arg, args[i]);
             if (num_previously_generated_plans < 0)
                 throw ArgError("argument for --internal-previous-portfolio-plans must be positive");
+        } else if (arg == "--checkpoint-file") {
+            if (is_last)
+                throw ArgError("missing argument after --checkpoint-file");
+            ++i;
+            checkpoint_filename = args[i];
+        } else if (arg == "--checkpoint-interval") {
+            if (is_last)
+                throw ArgError("missing argument after --checkpoint-interval");
+            ++i;
+            checkpoint_interval = parse_int_arg(arg, args[i]);
+            if (checkpoint_interval <= 0)
+                throw ArgError("argument for --checkpoint-interval must be positive");
+        } else if (arg == "--resume") {
+            if (is_last)
+                throw ArgError("missing argument after --resume");
+            ++i;
+            resume_filename = args[i];
         } else {
             throw ArgError("unknown option " + arg);
         }
     }
+    if (checkpoint_interval != -1 && checkpoint_filename.empty())
+        throw ArgError("--checkpoint-interval requires --checkpoint-file");
 
     if (engine) {
         PlanManager &plan_manager = engine->get_plan_manager();
         plan_manager.set_plan_filename(plan_filename);
         plan_manager.set_num_previously_generated_plans(num_previously_generated_plans);
         plan_manager.set_is_part_of_anytime_portfolio(is_part_of_anytime_portfolio);
+        checkpoint::CheckpointManager &checkpoint_manager =
+            engine->get_checkpoint_manager();
+        checkpoint_manager.set_checkpoint_filename(checkpoint_filename);
+        if (checkpoint_interval != -1)
+            checkpoint_manager.set_checkpoint_interval(checkpoint_interval);
+        checkpoint_manager.set_resume_filename(resume_filename);
     }
     return engine;
 }
@@ -180,6 +208,16 @@ string usage(const string &progname) {
            "    This planner call is part of a portfolio which already created\n"
            "    plan files FILENAME.1 up to FILENAME.COUNTER.\n"
            "    Start enumerating plan files with COUNTER+1, i.e. FILENAME.COUNTER+1\n\n"
+           "--checkpoint-file FILENAME\n"
+           "    Write a checkpoint of the search to FILENAME when receiving SIGTERM\n"
+           "    (and then terminate) and, if given, every --checkpoint-interval\n"
+           "    SECONDS. Supported by eager and lazy search with the open lists\n"
+           "    single, tiebreaking and alt.\n\n"
+           "--checkpoint-interval SECONDS\n"
+           "    Time between two checkpoints (default: only on SIGTERM).\n\n"
+           "--resume FILENAME\n"
+           "    Resume the search from the checkpoint FILENAME, which must have\n"
+           "    been written for the same task and search configuration.\n\n"
            "See http://www.fast-downward.org/ for details.";
 }
 }
@@ -48,20 +48,23 @@ public:
 template<class Element>
 class PerStateArray : public subscriber::Subscriber<StateRegistry> {
     const std::vector<Element> default_array;
+    using EntryArrayVector = segmented_vector::SegmentedArrayVector<
+        Element, memory_arena::ArenaAllocator<Element>>;
     using EntryArrayVectorMap = std::unordered_map<const StateRegistry *,
-                                                   segmented_vector::SegmentedArrayVector<Element> *>;
+                                                   EntryArrayVector *>;
     EntryArrayVectorMap entry_arrays_by_registry;
 
     mutable const StateRegistry *cached_registry;
-    mutable segmented_vector::SegmentedArrayVector<Element> *cached_entries;
+    mutable EntryArrayVector *cached_entries;
 
-    segmented_vector::SegmentedArrayVector<Element> *get_entries(const StateRegistry *registry) {
+    EntryArrayVector *get_entries(const StateRegistry *registry) {
         if (cached_registry != registry) {
             cached_registry = registry;
             auto it = entry_arrays_by_registry.find(registry);
             if (it == entry_arrays_by_registry.end()) {
-                cached_entries = new segmented_vector::SegmentedArrayVector<Element>(
-                    default_array.size());
+                cached_entries = new EntryArrayVector(
+                    default_array.size(),
+                    memory_arena::ArenaAllocator<Element>(registry->get_memory_arena()));
                 entry_arrays_by_registry[registry] = cached_entries;
                 registry->subscribe(this);
             } else {
@@ -72,7 +75,7 @@ class PerStateArray : public subscriber::Subscriber<StateRegistry> {
         return cached_entries;
     }
 
-    const segmented_vector::SegmentedArrayVector<Element> *get_entries(
+    const EntryArrayVector *get_entries(
         const StateRegistry *registry) const {
         if (cached_registry != registry) {
             const auto it = entry_arrays_by_registry.find(registry);
@@ -80,7 +83,7 @@ class PerStateArray : public subscriber::Subscriber<StateRegistry> {
                 return nullptr;
             } else {
                 cached_registry = registry;
-                cached_entries = const_cast<segmented_vector::SegmentedArrayVector<Element> *>(
+                cached_entries = const_cast<EntryArrayVector *>(
                     it->second);
             }
         }
@@ -106,8 +109,8 @@ public:
 
     ArrayView<Element> operator[](const GlobalState &state) {
         const StateRegistry *registry = &state.get_registry();
-        segmented_vector::SegmentedArrayVector<Element> *entries = get_entries(registry);
-        int state_id = state.get_id().value;
+        EntryArrayVector *entries = get_entries(registry);
+        size_t state_id = state.get_id().value;
         size_t virtual_size = registry->size();
         assert(utils::in_bounds(state_id, *registry));
         if (entries->size() < virtual_size) {
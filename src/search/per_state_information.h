@@ -1,10 +1,12 @@
 #ifndef PER_STATE_INFORMATION_H
 #define PER_STATE_INFORMATION_H
 
+#include "checkpoint.h"
 #include "global_state.h"
 #include "state_id.h"
 #include "state_registry.h"
 
+#include "algorithms/memory_arena.h"
 #include "algorithms/segmented_vector.h"
 #include "algorithms/subscriber.h"
 #include "utils/collections.h"
@@ -40,12 +42,14 @@
 template<class Entry>
 class PerStateInformation : public subscriber::Subscriber<StateRegistry> {
     const Entry default_value;
+    using EntryVector = segmented_vector::SegmentedVector<
+        Entry, memory_arena::ArenaAllocator<Entry>>;
     using EntryVectorMap = std::unordered_map<const StateRegistry *,
-                                              segmented_vector::SegmentedVector<Entry> * >;
+                                              EntryVector * >;
     EntryVectorMap entries_by_registry;
 
     mutable const StateRegistry *cached_registry;
-    mutable segmented_vector::SegmentedVector<Entry> *cached_entries;
+    mutable EntryVector *cached_entries;
 
     /*
       Returns the SegmentedVector associated with the given StateRegistry.
@@ -53,12 +57,13 @@ class PerStateInformation : public subscriber::Subscriber<StateRegistry> {
       Both the registry and the returned vector are cached to speed up
       consecutive calls with the same registry.
     */
-    segmented_vector::SegmentedVector<Entry> *get_entries(const StateRegistry *registry) {
+    EntryVector *get_entries(const StateRegistry *registry) {
         if (cached_registry != registry) {
             cached_registry = registry;
             auto it = entries_by_registry.find(registry);
             if (it == entries_by_registry.end()) {
-                cached_entries = new segmented_vector::SegmentedVector<Entry>();
+                cached_entries = new EntryVector(
+                    memory_arena::ArenaAllocator<Entry>(registry->get_memory_arena()));
                 entries_by_registry[registry] = cached_entries;
                 registry->subscribe(this);
             } else {
@@ -75,14 +80,14 @@ class PerStateInformation : public subscriber::Subscriber<StateRegistry> {
       Otherwise, both the registry and the returned vector are cached to speed
       up consecutive calls with the same registry.
     */
-    const segmented_vector::SegmentedVector<Entry> *get_entries(const StateRegistry *registry) const {
+    const EntryVector *get_entries(const StateRegistry *registry) const {
         if (cached_registry != registry) {
             const auto it = entries_by_registry.find(registry);
             if (it == entries_by_registry.end()) {
                 return nullptr;
             } else {
                 cached_registry = registry;
-                cached_entries = const_cast<segmented_vector::SegmentedVector<Entry> *>(it->second);
+                cached_entries = const_cast<EntryVector *>(it->second);
             }
         }
         assert(cached_registry == registry);
@@ -113,8 +118,8 @@ public:
 
     Entry &operator[](const GlobalState &state) {
         const StateRegistry *registry = &state.get_registry();
-        segmented_vector::SegmentedVector<Entry> *entries = get_entries(registry);
-        int state_id = state.get_id().value;
+        EntryVector *entries = get_entries(registry);
+        size_t state_id = state.get_id().value;
         size_t virtual_size = registry->size();
         assert(utils::in_bounds(state_id, *registry));
         if (entries->size() < virtual_size) {
@@ -125,19 +130,43 @@ public:
 
     const Entry &operator[](const GlobalState &state) const {
         const StateRegistry *registry = &state.get_registry();
-        const segmented_vector::SegmentedVector<Entry> *entries = get_entries(registry);
+        const EntryVector *entries = get_entries(registry);
         if (!entries) {
             return default_value;
         }
-        int state_id = state.get_id().value;
+        size_t state_id = state.get_id().value;
         assert(utils::in_bounds(state_id, *registry));
-        int num_entries = entries->size();
+        size_t num_entries = entries->size();
         if (state_id >= num_entries) {
             return default_value;
         }
         return (*entries)[state_id];
     }
 
+    /*
+      Write the entries of all states of the registry to a checkpoint,
+      and restore them. Loading replaces all entries for the registry.
+    */
+    void save(checkpoint::Writer &writer, const StateRegistry &registry) const {
+        const EntryVector *entries = get_entries(&registry);
+        size_t num_entries = entries ? entries->size() : 0;
+        writer.write(registry.size());
+        for (size_t i = 0; i < registry.size(); ++i) {
+            writer.write(i < num_entries ? (*entries)[i] : default_value);
+        }
+    }
+
+    void load(checkpoint::Reader &reader, const StateRegistry &registry) {
+        size_t num_entries = reader.read<size_t>();
+        if (num_entries != registry.size())
+            reader.fail("the number of per-state entries does not match");
+        EntryVector *entries = get_entries(&registry);
+        entries->resize(0, default_value);
+        for (size_t i = 0; i < num_entries; ++i) {
+            entries->push_back(reader.read<Entry>());
+        }
+    }
+
     virtual void notify_service_destroyed(const StateRegistry *registry) override {
         delete entries_by_registry[registry];
         entries_by_registry.erase(registry);
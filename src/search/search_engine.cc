@@ -23,6 +23,9 @@ using utils::ExitCode;
 
 class PruningMethod;
 
+// Identifies checkpoint files and their format version.
+static const string CHECKPOINT_MAGIC = "downward-checkpoint-2";
+
 successor_generator::SuccessorGenerator &get_successor_generator(const TaskProxy &task_proxy) {
     cout << "Building successor generator..." << flush;
     int peak_memory_before = utils::get_peak_memory_in_kb();
@@ -40,14 +43,46 @@ successor_generator::SuccessorGenerator &get_successor_generator(const TaskProxy
     return successor_generator;
 }
 
+static shared_ptr<memory_arena::MemoryArena> create_state_arena(const Options &opts) {
+    StatePoolType state_pool_type =
+        static_cast<StatePoolType>(opts.get_enum("state_pool"));
+    if (state_pool_type == StatePoolType::MAPPED_FILE) {
+        size_t resident_budget =
+            static_cast<size_t>(opts.get<int>("state_pool_resident_mb")) << 20;
+        return make_shared<memory_arena::MappedFileArena>(resident_budget);
+    } else if (state_pool_type == StatePoolType::HUGE_PAGES) {
+        return make_shared<memory_arena::HugePageArena>();
+    }
+    return nullptr;
+}
+
+static SearchNodeInfoLayout get_search_node_info_layout(
+    const Options &opts, const TaskProxy &task_proxy) {
+    if (!opts.get<bool>("compact_search_nodes"))
+        return SearchNodeInfoLayout::FULL;
+    // real_g equals g if adjusted costs equal real costs.
+    OperatorCost cost_type = static_cast<OperatorCost>(opts.get_enum("cost_type"));
+    if (cost_type != NORMAL && !task_properties::is_unit_cost(task_proxy))
+        return SearchNodeInfoLayout::FULL;
+    bool reopen_closed =
+        opts.contains("reopen_closed") && opts.get<bool>("reopen_closed");
+    return reopen_closed ? SearchNodeInfoLayout::COMPACT : SearchNodeInfoLayout::SLIM;
+}
+
 SearchEngine::SearchEngine(const Options &opts)
     : status(IN_PROGRESS),
       solution_found(false),
       task(tasks::g_root_task),
       task_proxy(*task),
-      state_registry(task_proxy),
+      state_registry(task_proxy,
+                     static_cast<StateIDSetType>(opts.get_enum("state_id_set")),
+                     opts.get<bool>("compress_states"),
+                     static_cast<StatePackingType>(opts.get_enum("state_packing")),
+                     create_state_arena(opts),
+                     static_cast<size_t>(opts.get<int>("state_segment_kb")) << 10),
       successor_generator(get_successor_generator(task_proxy)),
-      search_space(state_registry),
+      search_space(state_registry,
+                   get_search_node_info_layout(opts, task_proxy)),
       cost_type(static_cast<OperatorCost>(opts.get_enum("cost_type"))),
       is_unit_cost(task_properties::is_unit_cost(task_proxy)),
       max_time(opts.get<double>("max_time")) {
@@ -86,7 +121,16 @@ void SearchEngine::set_plan(const Plan &p) {
 }
 
 void SearchEngine::search() {
-    initialize();
+    if ((checkpoint_manager.writes_checkpoints() || checkpoint_manager.is_resuming()) &&
+        !supports_checkpoints()) {
+        cerr << "This search configuration does not support checkpoints." << endl;
+        utils::exit_with(ExitCode::SEARCH_UNSUPPORTED);
+    }
+    if (checkpoint_manager.is_resuming())
+        resume();
+    else
+        initialize();
+    checkpoint_manager.start();
     utils::CountdownTimer timer(max_time);
     while (status == IN_PROGRESS) {
         status = step();
@@ -95,12 +139,96 @@ void SearchEngine::search() {
             status = TIMEOUT;
             break;
         }
+        if (status == IN_PROGRESS && checkpoint_manager.is_checkpoint_due()) {
+            write_checkpoint();
+            if (checkpoint_manager.is_termination_requested())
+                checkpoint_manager.terminate();
+        }
     }
     // TODO: Revise when and which search times are logged.
     cout << "Actual search time: " << timer.get_elapsed_time()
          << " [t=" << utils::g_timer << "]" << endl;
 }
 
+bool SearchEngine::supports_checkpoints() {
+    return false;
+}
+
+string SearchEngine::get_checkpoint_engine_type() const {
+    return "";
+}
+
+string SearchEngine::get_checkpoint_open_list_type() const {
+    return "";
+}
+
+void SearchEngine::get_checkpointed_evaluators(vector<Evaluator *> &) {
+}
+
+void SearchEngine::save_checkpoint(checkpoint::Writer &) const {
+}
+
+void SearchEngine::load_checkpoint(checkpoint::Reader &) {
+}
+
+void SearchEngine::write_checkpoint() {
+    checkpoint::Writer writer(checkpoint_manager.get_checkpoint_filename());
+    writer.write(CHECKPOINT_MAGIC);
+    writer.write(task_proxy.get_variables().size());
+    writer.write(task_proxy.get_operators().size());
+    writer.write(get_checkpoint_engine_type());
+    writer.write(get_checkpoint_open_list_type());
+    vector<Evaluator *> evaluators;
+    get_checkpointed_evaluators(evaluators);
+    writer.write(evaluators.size());
+    for (const Evaluator *evaluator : evaluators)
+        writer.write(evaluator->get_description());
+    state_registry.save(writer);
+    search_space.save(writer);
+    writer.write(statistics);
+    for (const Evaluator *evaluator : evaluators)
+        evaluator->save_checkpoint(writer, state_registry);
+    save_checkpoint(writer);
+    writer.commit();
+    checkpoint_manager.notify_checkpoint_written();
+}
+
+void SearchEngine::resume() {
+    checkpoint::Reader reader(checkpoint_manager.get_resume_filename());
+    if (reader.read<string>() != CHECKPOINT_MAGIC)
+        reader.fail("not a checkpoint of this planner version");
+    if (reader.read<size_t>() != task_proxy.get_variables().size() ||
+        reader.read<size_t>() != task_proxy.get_operators().size())
+        reader.fail("the checkpoint belongs to a different task");
+    string engine_type = reader.read<string>();
+    if (engine_type != get_checkpoint_engine_type())
+        reader.fail("the checkpoint was written by " + engine_type +
+                    ", not by " + get_checkpoint_engine_type());
+    string open_list_type = reader.read<string>();
+    if (open_list_type != get_checkpoint_open_list_type())
+        reader.fail("the checkpoint was written with open list " +
+                    open_list_type + ", not " + get_checkpoint_open_list_type());
+    vector<Evaluator *> evaluators;
+    get_checkpointed_evaluators(evaluators);
+    if (reader.read<size_t>() != evaluators.size())
+        reader.fail("the search uses a different number of evaluators");
+    for (const Evaluator *evaluator : evaluators) {
+        string description = reader.read<string>();
+        if (description != evaluator->get_description())
+            reader.fail("the checkpoint was written with evaluator " +
+                        description + ", not " + evaluator->get_description());
+    }
+    state_registry.load(reader);
+    search_space.load(reader);
+    statistics = reader.read<SearchStatistics>();
+    for (Evaluator *evaluator : evaluators)
+        evaluator->load_checkpoint(reader, state_registry);
+    load_checkpoint(reader);
+    cout << "Resumed search from " << checkpoint_manager.get_resume_filename()
+         << " with " << state_registry.size() << " registered states [t="
+         << utils::g_timer << "]" << endl;
+}
+
 bool SearchEngine::check_goal_and_set_plan(const GlobalState &state) {
     if (task_properties::is_goal_state(task_proxy, state)) {
         cout << "Solution found!" << endl;
@@ -151,6 +279,95 @@ void SearchEngine::add_options_to_parser(OptionParser &parser) {
         "experiments. Timed-out searches are treated as failed searches, "
         "just like incomplete search algorithms that exhaust their search space.",
         "infinity");
+    parser.add_option<bool>(
+        "compact_search_nodes",
+        "store less information per search node when the search allows it: "
+        "real g values are omitted if adjusted costs equal real costs, and "
+        "creating operators are additionally omitted if closed nodes are "
+        "never reopened. The plan then uses the cheapest operator between "
+        "each state and its parent, so it may differ from the path found "
+        "by the search (it is never more expensive)",
+        "true");
+    vector<string> state_id_sets;
+    vector<string> state_id_sets_doc;
+    state_id_sets.push_back("INT_HASH_SET");
+    state_id_sets_doc.push_back(
+        "hopscotch hash set storing a 32-bit hash and key per bucket");
+    state_id_sets.push_back("SWISS_HASH_SET");
+    state_id_sets_doc.push_back(
+        "Swiss table that probes groups of 16 control bytes at once "
+        "(with SSE2 if available) and uses a faster 64-bit state hash");
+    parser.add_enum_option(
+        "state_id_set",
+        state_id_sets,
+        "hash set used by the state registry to detect duplicate states",
+        "INT_HASH_SET",
+        state_id_sets_doc);
+    parser.add_option<bool>(
+        "compress_states",
+        "store a registered state as the bins in which it differs from its "
+        "predecessor if this is smaller than the state (with a full copy at "
+        "least every 9 states along each path). Every state additionally "
+        "needs 4 bytes to locate its data. This reduces the memory for state "
+        "data if states consist of many bins of which few change, at the "
+        "cost of decoding states when they are looked up. The option is "
+        "ignored for states of at most 3 bins, which are never compressed.",
+        "false");
+    vector<string> state_packings;
+    vector<string> state_packings_doc;
+    state_packings.push_back("BIT_WIDTH");
+    state_packings_doc.push_back(
+        "greedily pack variables into bins by their bit width");
+    state_packings.push_back("CO_CHANGE");
+    state_packings_doc.push_back(
+        "like BIT_WIDTH, but prefer packing variables that are changed by "
+        "the same operators into the same bin, and frequently changed "
+        "variables into the first bins. This reduces the number of bins "
+        "touched when applying an operator. The number of bins is the same");
+    parser.add_enum_option(
+        "state_packing",
+        state_packings,
+        "how the state registry packs state variables into bins",
+        "BIT_WIDTH",
+        state_packings_doc);
+    vector<string> state_pools;
+    vector<string> state_pools_doc;
+    state_pools.push_back("MEMORY");
+    state_pools_doc.push_back("allocate state data in main memory");
+    state_pools.push_back("MAPPED_FILE");
+    state_pools_doc.push_back(
+        "allocate state data and per-state information from a memory-mapped "
+        "temporary file, which the kernel can page out. This lets the search "
+        "use more memory than is available as RAM, at the cost of speed. "
+        "The file is created in the directory given by the TMPDIR "
+        "environment variable (default: /tmp), which should be on a local "
+        "disk");
+    state_pools.push_back("HUGE_PAGES");
+    state_pools_doc.push_back(
+        "allocate state data and per-state information from 2 MB-aligned "
+        "regions of main memory backed by transparent huge pages (if the "
+        "kernel supports them), which reduces TLB misses on large searches");
+    parser.add_enum_option(
+        "state_pool",
+        state_pools,
+        "where the state registry allocates state data and per-state "
+        "information. Hash sets and open lists always use main memory.",
+        "MEMORY",
+        state_pools_doc);
+    parser.add_option<int>(
+        "state_pool_resident_mb",
+        "with state_pool=MAPPED_FILE, the amount of most recently allocated "
+        "memory (in MB) that is kept resident. Older memory is released from "
+        "the process after each 64 MB of allocations",
+        "1024",
+        Bounds("1", "infinity"));
+    parser.add_option<int>(
+        "state_segment_kb",
+        "size (in KB) of the segments in which the state registry allocates "
+        "uncompressed state data. Larger segments need fewer allocations but "
+        "overallocate more memory",
+        "8",
+        Bounds("1", "infinity"));
 }
 
 /* Method doesn't belong here because it's only useful for certain derived classes.
@@ -1,6 +1,7 @@
 #ifndef SEARCH_ENGINE_H
 #define SEARCH_ENGINE_H
 
+#include "checkpoint.h"
 #include "operator_cost.h"
 #include "operator_id.h"
 #include "plan_manager.h"
@@ -32,6 +33,9 @@ class SearchEngine {
     SearchStatus status;
     bool solution_found;
     Plan plan;
+
+    void write_checkpoint();
+    void resume();
 protected:
     // Hold a reference to the task implementation and pass it to objects that need it.
     const std::shared_ptr<AbstractTask> task;
@@ -39,6 +43,7 @@ protected:
     TaskProxy task_proxy;
 
     PlanManager plan_manager;
+    checkpoint::CheckpointManager checkpoint_manager;
     StateRegistry state_registry;
     const successor_generator::SuccessorGenerator &successor_generator;
     SearchSpace search_space;
@@ -52,6 +57,26 @@ protected:
     virtual void initialize() {}
     virtual SearchStatus step() = 0;
 
+    /*
+      Checkpoints (see checkpoint.h). The state registry, the search
+      space, the statistics and the per-state information of the
+      evaluators returned by get_checkpointed_evaluators are written by
+      SearchEngine. Engines that support checkpoints write their
+      remaining data (in particular their open list) in save_checkpoint.
+      When resuming, load_checkpoint is called instead of initialize
+      after the data of SearchEngine is restored. Checkpoints are only
+      written between two calls of step(). The header of a checkpoint
+      contains the descriptions of the evaluators and the types returned
+      by get_checkpoint_engine_type and get_checkpoint_open_list_type,
+      and resuming with a different configuration is rejected.
+    */
+    virtual bool supports_checkpoints();
+    virtual std::string get_checkpoint_engine_type() const;
+    virtual std::string get_checkpoint_open_list_type() const;
+    virtual void get_checkpointed_evaluators(std::vector<Evaluator *> &evals);
+    virtual void save_checkpoint(checkpoint::Writer &writer) const;
+    virtual void load_checkpoint(checkpoint::Reader &reader);
+
     void set_plan(const Plan &plan);
     bool check_goal_and_set_plan(const GlobalState &state);
     int get_adjusted_cost(const OperatorProxy &op) const;
@@ -68,6 +93,7 @@ public:
     void set_bound(int b) {bound = b;}
     int get_bound() {return bound;}
     PlanManager &get_plan_manager() {return plan_manager;}
+    checkpoint::CheckpointManager &get_checkpoint_manager() {return checkpoint_manager;}
 
     /* The following three methods should become functions as they
        do not require access to private/protected class members. */
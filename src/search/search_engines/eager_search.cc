@@ -1,5 +1,7 @@
 #include "eager_search.h"
 
+#include "fwdbwd_common.h"
+
 #include "../evaluation_context.h"
 #include "../evaluator.h"
 #include "../open_list_factory.h"
@@ -7,9 +9,12 @@
 #include "../pruning_method.h"
 
 #include "../algorithms/ordered_set.h"
+#include "../task_utils/incremental_successor_generator.h"
 #include "../task_utils/successor_generator.h"
 #include "../task_utils/task_properties.h"
 #include "../tasks/root_task.h"
+#include "../utils/memory.h"
+#include "../utils/thread_pool.h"
 
 #include <cassert>
 #include <cstdlib>
@@ -22,173 +27,67 @@
 
 using namespace std;
 
-namespace fwdbwd{
-
-    unordered_map<OperatorID, vector<OperatorID> > dependency_map;
-    unordered_map<OperatorID, vector<OperatorID> > inverse_map;
-    unordered_map<StateID, unordered_set<OperatorID> > forward_nodes;
-    unordered_map<OperatorID, bool> goal_ops;
-    // the first int in the unordered map below tracks to the variable id
-    unordered_map<OperatorID, unordered_map<int, pair<int, bool> > > op_data;
-
-    OpStackNode* stack_root = new OpStackNode(OperatorID::no_operator, NULL);
-
-    bool is_applicable(const GlobalState &state, const OperatorProxy op)
-    {
-        for(FactProxy precondition: op.get_preconditions())
-        {
-            if(state[precondition.get_variable().get_id()] != precondition.get_value())
-            return false;
-        }
-        return true;
-    }
-
-    // CHANGE: New function added, do check functionality
-    // RECHECK: Vulnerable function, created in one go.
-    void generate_op_data(const TaskProxy task_proxy)
-    {
-        for(OperatorProxy op: task_proxy.get_operators())
-        {
-            for (FactProxy precondition: op.get_preconditions())
-            {
-                op_data[OperatorID(op.get_id())][precondition.get_variable().get_id()].first = precondition.get_value();
-                op_data[OperatorID(op.get_id())][precondition.get_variable().get_id()].second = false;
-            }
-            for (EffectProxy eff: op.get_effects())
-            {
-                FactProxy f = eff.get_fact();
-                if(op_data[OperatorID(op.get_id())][f.get_variable().get_id()].first != f.get_value())
-                    op_data[OperatorID(op.get_id())][f.get_variable().get_id()].second = true; 
-            }
-        }
-    }
-
-    bool check_goal_op(const OperatorProxy op, const TaskProxy task_proxy)
-    {
-        for(FactProxy precondition: op.get_preconditions())
-        {
-            for(FactProxy goal_fact: task_proxy.get_goals()) 
-            {
-                bool flag1 = (precondition.get_variable() == goal_fact.get_variable());
-                bool flag2 = (precondition.get_value() != goal_fact.get_value());
-                bool flag3 = op_data[OperatorID(op.get_id())][precondition.get_variable().get_id()].second;
-                if(flag1 && flag2 && flag3)
-                    return true;
-            }
-        }
-        return false;
-    }
-
-    // CHANGE: A bug was resolved in this function, do check again.
-    void generate_goal_ops(const TaskProxy task_proxy)
-    {
-        for(OperatorProxy op: task_proxy.get_operators())
-          goal_ops[OperatorID(op.get_id())] = check_goal_op(op, task_proxy);
-    }
-
-    bool is_dependent(OperatorProxy op1, OperatorProxy op2)
-    { 
-        // return true op1 supplies some facts to op2
-
-        PreconditionsProxy pre1 = op1.get_preconditions();
-        PreconditionsProxy pre2 = op2.get_preconditions();
-
-        for(FactProxy p2: pre2)
-        {
-            for(FactProxy p1: pre1)
-            {
-                if(p1.get_variable() == p2.get_variable())
-                {
-                    if(p1.get_value() != p2.get_value())
-                    {
-                        if(op_data[OperatorID(op1.get_id())][p1.get_variable().get_id()].second)
-                            return true;
-                    }
-                    else
-                    {
-                        if(!op_data[OperatorID(op1.get_id())][p1.get_variable().get_id()].second)
-                            return true;
-                    }
-                }
-            }
-        }
-        return false;
-    }
-
-    void generate_dependency_graph(const TaskProxy task_proxy)
-    {
-        OperatorsProxy operators = task_proxy.get_operators();
-      
-        for (OperatorProxy op1 : operators)
-        {
-            for(OperatorProxy op2 : operators)
-            {
-                if(op1 != op2)
-                {
-                    if(is_dependent(op1, op2))
-                    {
-                        dependency_map[OperatorID(op1.get_id())].push_back(OperatorID(op2.get_id()));
-                        inverse_map[OperatorID(op2.get_id())].push_back(OperatorID(op1.get_id()));
-                    }
-                }
-            }
-        }
-    }
-
-    // Call all the functions here
-    void calculate(const TaskProxy task_proxy)
-    {
-        generate_op_data(task_proxy);
-        generate_goal_ops(task_proxy);
-        generate_dependency_graph(task_proxy);
-    }
-
-    FwdbwdNode::FwdbwdNode(StateID state_id, OperatorID operator_id, OpStackNode* op_stack_node, int g_value):
-    id(state_id), op_id(operator_id)
-    {
-        op_stack = op_stack_node;
-        state_g_value = g_value;
-    }
-
-    bool FwdbwdNode::operator<(const FwdbwdNode& rhs) const{
-    
-        if(op_stack == NULL && rhs.get_stack_pointer() == NULL)
-            return state_g_value < rhs.get_g();
-
-        else if(op_stack != NULL && rhs.get_stack_pointer() != NULL)
-            return op_stack->get_depth() < rhs.get_stack_pointer()->get_depth();
-    
-        else
-            return (op_stack == NULL)? true: false;
-    }
-
-}
-
 namespace eager_search {
+static const int APPLICABLE_OPS_CACHE_SIZE = 1024;
+
 EagerSearch::EagerSearch(const Options &opts)
     : SearchEngine(opts),
       reopen_closed_nodes(opts.get<bool>("reopen_closed")),
+      backward_analysis(opts.get<bool>("backward_analysis")),
+      merge_creating_operators(opts.get<bool>("merge_creating_operators") &&
+                               backward_analysis),
+      batch_evaluation((opts.get<bool>("batch_evaluation") ||
+                        opts.get<int>("evaluation_threads") > 1) &&
+                       !backward_analysis),
       open_list(opts.get<shared_ptr<OpenListFactory>>("open")->
                 create_fwdbwd_open_list()),
       f_evaluator(opts.get<shared_ptr<Evaluator>>("f_eval", nullptr)),
       preferred_operator_evaluators(opts.get_list<shared_ptr<Evaluator>>("preferred")),
       lazy_evaluator(opts.get<shared_ptr<Evaluator>>("lazy_evaluator", nullptr)),
-      pruning_method(opts.get<shared_ptr<PruningMethod>>("pruning")) {
+      pruning_method(opts.get<shared_ptr<PruningMethod>>("pruning")),
+      subgoal_failure_cache(opts.get<bool>("cache_subgoal_failures") ?
+                            utils::make_unique_ptr<fwdbwd::SubgoalFailureCache>() : nullptr),
+      regression_stack_evaluator(opts.get<bool>("regression_stack_estimate") ?
+                                 utils::make_unique_ptr<fwdbwd::RegressionStackEvaluator>() : nullptr),
+      num_merged_creating_operators(0),
+      num_incremental_generations(0) {
     if (lazy_evaluator && !lazy_evaluator->does_cache_estimates()) {
         cerr << "lazy_evaluator must cache its estimates" << endl;
         utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
     }
+    if (regression_stack_evaluator && backward_analysis &&
+        !open_list->supports_stack_estimates()) {
+        cerr << "regression_stack_estimate is not supported by this open list" << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+    int evaluation_threads = opts.get<int>("evaluation_threads");
+    if (batch_evaluation && evaluation_threads > 1)
+        thread_pool = utils::make_unique_ptr<utils::ThreadPool>(evaluation_threads);
+    // Only classic eager search expands states with all applicable operators.
+    if (opts.get<bool>("incremental_successors") && !backward_analysis) {
+        incremental_successor_generator =
+            utils::make_unique_ptr<successor_generator::IncrementalSuccessorGenerator>(
+                task_proxy, successor_generator);
+        cached_applicable_ops_ids.assign(APPLICABLE_OPS_CACHE_SIZE, StateID::no_state);
+        cached_applicable_ops.resize(APPLICABLE_OPS_CACHE_SIZE);
+    }
 }
 
-void EagerSearch::initialize() {
+EagerSearch::~EagerSearch() {
+}
+
+void EagerSearch::prepare_search() {
     cout << "Conducting best first search"
+         << (backward_analysis ? " with" : " without")
+         << " backward analysis,"
          << (reopen_closed_nodes ? " with" : " without")
          << " reopening closed nodes, (real) bound = " << bound
          << endl;
     assert(open_list);
 
     // fwdbwd code
-    fwdbwd::calculate(task_proxy);
+    if (backward_analysis)
+        fwdbwd::calculate(task_proxy);
     // fwdbwd code
 
 
@@ -201,6 +100,25 @@ void EagerSearch::initialize() {
 
     path_dependent_evaluators.assign(evals.begin(), evals.end());
 
+    /*
+      Path-dependent evaluators must be notified of a transition before
+      the successor is evaluated, which batch evaluation cannot ensure.
+    */
+    if (batch_evaluation && !path_dependent_evaluators.empty()) {
+        cout << "Batch evaluation is disabled because of path-dependent "
+             << "evaluators." << endl;
+        batch_evaluation = false;
+        thread_pool = nullptr;
+    }
+    if (thread_pool) {
+        cout << "Evaluating successors with " << thread_pool->get_num_threads()
+             << " threads." << endl;
+    }
+}
+
+void EagerSearch::initialize() {
+    prepare_search();
+
     const GlobalState &initial_state = state_registry.get_initial_state();
     for (Evaluator *evaluator : path_dependent_evaluators) {
         evaluator->notify_initial_state(initial_state);
@@ -223,14 +141,134 @@ void EagerSearch::initialize() {
         SearchNode node = search_space.get_node(initial_state);
         node.open_initial();
 
-        fwdbwd::FwdbwdNode fwdbwd_node(initial_state.get_id(), OperatorID::no_operator, NULL, node.get_real_g());
-        open_list->insert(eval_context, fwdbwd_node);
+        insert_forward_node(eval_context, initial_state.get_id(), OperatorID::no_operator, node.get_real_g());
     }
 
     print_initial_evaluator_values(eval_context);
 
 }
 
+bool EagerSearch::supports_checkpoints() {
+    /*
+      Path-dependent evaluators (e.g. the landmark heuristic) store
+      information about the paths to states that is not written to
+      checkpoints.
+    */
+    set<Evaluator *> evals;
+    open_list->get_path_dependent_evaluators(evals);
+    if (f_evaluator)
+        f_evaluator->get_path_dependent_evaluators(evals);
+    return evals.empty() && open_list->supports_checkpoints();
+}
+
+string EagerSearch::get_checkpoint_engine_type() const {
+    string type = reopen_closed_nodes ? "eager reopening closed nodes" : "eager";
+    if (backward_analysis) {
+        type += " with backward analysis";
+        if (merge_creating_operators)
+            type += ", merged creating operators";
+        if (subgoal_failure_cache)
+            type += ", subgoal failure cache";
+    }
+    return type;
+}
+
+string EagerSearch::get_checkpoint_open_list_type() const {
+    return open_list->get_checkpoint_type();
+}
+
+void EagerSearch::get_checkpointed_evaluators(vector<Evaluator *> &evals) {
+    open_list->get_checkpointed_evaluators(evals);
+    if (f_evaluator)
+        f_evaluator->get_checkpointed_evaluators(evals);
+    for (const shared_ptr<Evaluator> &evaluator : preferred_operator_evaluators)
+        evaluator->get_checkpointed_evaluators(evals);
+    if (lazy_evaluator)
+        lazy_evaluator->get_checkpointed_evaluators(evals);
+}
+
+void EagerSearch::save_checkpoint(checkpoint::Writer &writer) const {
+    writer.write(backward_analysis);
+    if (backward_analysis) {
+        // The open list refers to the stack nodes, so they are written first.
+        fwdbwd::save_search_data(writer);
+        writer.write(fwdbwd_statistics);
+        writer.write(pending_creating_operators.size());
+        for (const auto &state_and_ops : pending_creating_operators) {
+            writer.write(state_and_ops.first);
+            writer.write_vector(state_and_ops.second);
+        }
+        writer.write(num_merged_creating_operators);
+        if (subgoal_failure_cache)
+            subgoal_failure_cache->save(writer);
+    }
+    open_list->save(writer);
+}
+
+void EagerSearch::load_checkpoint(checkpoint::Reader &reader) {
+    prepare_search();
+    if (reader.read<bool>() != backward_analysis)
+        reader.fail("the search configuration differs");
+    if (backward_analysis) {
+        fwdbwd::load_search_data(reader);
+        fwdbwd_statistics = reader.read<fwdbwd::FwdbwdStatistics>();
+        size_t num_pending = reader.read<size_t>();
+        for (size_t i = 0; i < num_pending; ++i) {
+            StateID state_id = reader.read<StateID>();
+            pending_creating_operators[state_id] = reader.read_vector<OperatorID>();
+        }
+        num_merged_creating_operators = reader.read<int>();
+        if (subgoal_failure_cache)
+            subgoal_failure_cache->load(reader);
+    }
+    open_list->load(reader);
+}
+
+void EagerSearch::insert_forward_node(
+    EvaluationContext &eval_context, StateID state_id, OperatorID op_id, int g) {
+    if (merge_creating_operators) {
+        vector<OperatorID> &pending = pending_creating_operators[state_id];
+        pending.push_back(op_id);
+        // The state already waits for expansion and will consider op_id then.
+        if (pending.size() > 1) {
+            ++num_merged_creating_operators;
+            return;
+        }
+    }
+    fwdbwd::FwdbwdNode fwdbwd_node(state_id, op_id, NULL, g);
+    open_list->insert(eval_context, fwdbwd_node);
+}
+
+int EagerSearch::get_stack_estimate(
+    const GlobalState &state, OpStackNode *op_stack_node) {
+    if (!regression_stack_evaluator)
+        return 0;
+    return regression_stack_evaluator->compute_estimate(task_proxy, state, op_stack_node);
+}
+
+void EagerSearch::generate_applicable_ops(
+    const GlobalState &state, const SearchNode &node,
+    vector<OperatorID> &applicable_ops) {
+    if (!incremental_successor_generator) {
+        successor_generator.generate_applicable_ops(state, applicable_ops);
+        return;
+    }
+    StateID parent_id = node.get_parent_state_id();
+    int parent_slot = parent_id.hash() % APPLICABLE_OPS_CACHE_SIZE;
+    if (parent_id != StateID::no_state &&
+        cached_applicable_ops_ids[parent_slot] == parent_id) {
+        GlobalState parent = state_registry.lookup_state(parent_id);
+        incremental_successor_generator->generate_applicable_ops(
+            parent, cached_applicable_ops[parent_slot], state, applicable_ops);
+        ++num_incremental_generations;
+    } else {
+        successor_generator.generate_applicable_ops(state, applicable_ops);
+    }
+    int slot = state.get_id().hash() % APPLICABLE_OPS_CACHE_SIZE;
+    cached_applicable_ops_ids[slot] = state.get_id();
+    cached_applicable_ops[slot] = applicable_ops;
+}
+
 void EagerSearch::print_checkpoint_line(int g) const {
     cout << "[g=" << g << ", ";
     statistics.print_basic_statistics();
@@ -239,6 +277,15 @@ void EagerSearch::print_checkpoint_line(int g) const {
 
 void EagerSearch::print_statistics() const {
     statistics.print_detailed_statistics();
+    if (backward_analysis)
+        fwdbwd_statistics.print_statistics();
+    if (merge_creating_operators)
+        cout << "Merged creating operators: " << num_merged_creating_operators << endl;
+    if (incremental_successor_generator)
+        cout << "Incremental successor generations: "
+             << num_incremental_generations << endl;
+    if (subgoal_failure_cache)
+        subgoal_failure_cache->print_statistics();
     search_space.print_statistics();
     pruning_method->print_statistics();
 }
@@ -250,9 +297,44 @@ SearchStatus EagerSearch::step()
         return FAILED;
     fwdbwd::FwdbwdNode fwdbwd_node = n.first;
     if(!fwdbwd_node.get_stack_pointer())
+    {
+      fwdbwd_statistics.inc_forward_steps();
       return forward_step(fwdbwd_node);
+    }
     else
+    {
+      fwdbwd_statistics.inc_backward_steps();
       return backward_step(fwdbwd_node);
+    }
+}
+
+void EagerSearch::evaluate_new_successors(
+    const SearchNode &node, const vector<OperatorID> &succ_op_ids,
+    const vector<GlobalState> &succ_states, vector<int> &batch_indices) {
+    /*
+      Create a context for the first occurrence of each new successor,
+      which is the one that opens the node, and let the open list compute
+      all values it needs for these contexts at once.
+    */
+    batch_eval_contexts.clear();
+    batch_eval_contexts.reserve(succ_states.size());
+    batch_indices.assign(succ_states.size(), -1);
+    unordered_set<StateID> batch_states;
+    for (size_t i = 0; i < succ_states.size(); ++i) {
+        const GlobalState &succ_state = succ_states[i];
+        if (!search_space.get_node(succ_state).is_new() ||
+            !batch_states.insert(succ_state.get_id()).second)
+            continue;
+        OperatorProxy op = task_proxy.get_operators()[succ_op_ids[i]];
+        batch_indices[i] = batch_eval_contexts.size();
+        batch_eval_contexts.emplace_back(
+            succ_state, node.get_g() + get_adjusted_cost(op), false, &statistics);
+    }
+    vector<EvaluationContext *> eval_contexts;
+    eval_contexts.reserve(batch_eval_contexts.size());
+    for (EvaluationContext &eval_context : batch_eval_contexts)
+        eval_contexts.push_back(&eval_context);
+    open_list->evaluate_batch(eval_contexts, thread_pool.get());
 }
 
 SearchStatus EagerSearch::forward_step(fwdbwd::FwdbwdNode fwdbwd_node)
@@ -265,9 +347,41 @@ SearchStatus EagerSearch::forward_step(fwdbwd::FwdbwdNode fwdbwd_node)
     if (check_goal_and_set_plan(s))
         return SOLVED;
 
-    vector<fwdbwd::FwdbwdOps> fwdbwd_ops = generate_fwdbwd_ops(s, fwdbwd_node.get_operator());
+    vector<fwdbwd::FwdbwdOps> fwdbwd_ops;
+    if (!backward_analysis) {
+        // Classic eager search: expand each state once with all applicable operators.
+        node.close();
+        vector<OperatorID> applicable_ops;
+        generate_applicable_ops(s, node, applicable_ops);
+        fwdbwd_ops.reserve(applicable_ops.size());
+        for (OperatorID op_id : applicable_ops)
+            fwdbwd_ops.emplace_back(op_id, true);
+    } else if (merge_creating_operators) {
+        auto pending = pending_creating_operators.find(id);
+        assert(pending != pending_creating_operators.end());
+        fwdbwd_ops = fwdbwd::generate_fwdbwd_ops(
+            task_proxy, successor_generator, s, pending->second);
+        pending_creating_operators.erase(pending);
+    } else {
+        fwdbwd_ops = fwdbwd::generate_fwdbwd_ops(
+            task_proxy, successor_generator, s, fwdbwd_node.get_operator());
+    }
     EvaluationContext eval_context(s, node.get_g(), false, &statistics, true);
 
+    // Register all successors within the bound in one batch.
+    vector<OperatorID> succ_op_ids;
+    for (const fwdbwd::FwdbwdOps &fwdbwd_op : fwdbwd_ops) {
+        OperatorProxy op = task_proxy.get_operators()[fwdbwd_op.first];
+        if (fwdbwd_op.second && node.get_real_g() + op.get_cost() < bound)
+            succ_op_ids.push_back(fwdbwd_op.first);
+    }
+    vector<GlobalState> succ_states;
+    succ_states.reserve(succ_op_ids.size());
+    state_registry.get_successor_states(s, succ_op_ids, succ_states);
+    vector<int> batch_indices;
+    if (batch_evaluation)
+        evaluate_new_successors(node, succ_op_ids, succ_states, batch_indices);
+    size_t next_succ_state = 0;
 
     for (fwdbwd::FwdbwdOps fwdbwd_op: fwdbwd_ops) {
 
@@ -277,7 +391,8 @@ SearchStatus EagerSearch::forward_step(fwdbwd::FwdbwdNode fwdbwd_node)
         {
             if ((node.get_real_g() + op.get_cost()) >= bound)
                 continue;
-            GlobalState succ_state = state_registry.get_successor_state(s, op);
+            size_t succ_index = next_succ_state++;
+            GlobalState succ_state = succ_states[succ_index];
             //FWDBWD: What do they consider when counting generated nodes? What if an old node is generated?
             statistics.inc_generated();
 
@@ -297,8 +412,11 @@ SearchStatus EagerSearch::forward_step(fwdbwd::FwdbwdNode fwdbwd_node)
 
                 int succ_g = node.get_g() + get_adjusted_cost(op);
 
-                EvaluationContext succ_eval_context(
-                    succ_state, succ_g, NULL, &statistics);
+                int batch_index = batch_evaluation ? batch_indices[succ_index] : -1;
+                EvaluationContext succ_eval_context =
+                    batch_index == -1 ?
+                    EvaluationContext(succ_state, succ_g, false, &statistics) :
+                    batch_eval_contexts[batch_index];
                 statistics.inc_evaluated_states();
 
                 if (open_list->is_dead_end(succ_eval_context)) {
@@ -308,16 +426,39 @@ SearchStatus EagerSearch::forward_step(fwdbwd::FwdbwdNode fwdbwd_node)
                 }
                 succ_node.open(node, op, get_adjusted_cost(op));
 
+                if (!backward_analysis) {
+                    insert_forward_node(succ_eval_context, succ_state.get_id(), op_id, succ_node.get_real_g());
+                    if (search_progress.check_progress(succ_eval_context)) {
+                        print_checkpoint_line(succ_node.get_g());
+                        reward_progress();
+                    }
+                    continue;
+                }
+
                 // succ_node.store_foward_operator(op_id);
                 fwdbwd::forward_nodes[succ_state.get_id()].insert(op_id);
 
-                fwdbwd::FwdbwdNode succ_fwdbwd_node(succ_state.get_id(), op_id, NULL, succ_node.get_real_g());
-                open_list->insert(eval_context, succ_fwdbwd_node);
+                insert_forward_node(eval_context, succ_state.get_id(), op_id, succ_node.get_real_g());
                 if (search_progress.check_progress(eval_context)) {
                     print_checkpoint_line(succ_node.get_g());
                     reward_progress();
                 }
             }
+            else if (!backward_analysis) {
+                if (succ_node.get_g() > node.get_g() + get_adjusted_cost(op)) {
+                    // We found a new cheapest path to an open or closed state.
+                    if (reopen_closed_nodes) {
+                        if (succ_node.is_closed())
+                            statistics.inc_reopened();
+                        succ_node.reopen(node, op, get_adjusted_cost(op));
+                        EvaluationContext succ_eval_context(
+                            succ_state, succ_node.get_g(), false, &statistics);
+                        insert_forward_node(succ_eval_context, succ_state.get_id(), op_id, succ_node.get_real_g());
+                    } else {
+                        succ_node.update_parent(node, op, get_adjusted_cost(op));
+                    }
+                }
+            }
             else{
                 if(succ_node.get_g() > node.get_g() + get_adjusted_cost(op))
                     succ_node.update_parent(succ_node, op, get_adjusted_cost(op));
@@ -329,8 +470,7 @@ SearchStatus EagerSearch::forward_step(fwdbwd::FwdbwdNode fwdbwd_node)
                     fwdbwd::forward_nodes[succ_state.get_id()].insert(op_id);
                     EvaluationContext eval_context(
                         succ_state, succ_node.get_g(), NULL, &statistics);
-                    fwdbwd::FwdbwdNode succ_fwdbwd_node(succ_state.get_id(), op_id, NULL, succ_node.get_real_g());
-                    open_list->insert(eval_context, succ_fwdbwd_node);
+                    insert_forward_node(eval_context, succ_state.get_id(), op_id, succ_node.get_real_g());
                 }
             }   
         }
@@ -350,7 +490,9 @@ SearchStatus EagerSearch::forward_step(fwdbwd::FwdbwdNode fwdbwd_node)
                     if(second_child.second)
                     {
                         // Now push this backward into the open list
-                        fwdbwd::FwdbwdNode succ_fwdbwd_node(id, OperatorID::no_operator, second_child.first, node.get_real_g());
+                        fwdbwd::FwdbwdNode succ_fwdbwd_node(id, OperatorID::no_operator, second_child.first, node.get_real_g(),
+                                                            get_stack_estimate(s, second_child.first));
+                        fwdbwd_statistics.inc_stack_entries();
                         open_list->insert(eval_context, succ_fwdbwd_node);
                     }
                 }
@@ -376,8 +518,9 @@ SearchStatus EagerSearch::backward_step(fwdbwd::FwdbwdNode fwdbwd_node)
     OperatorProxy op = task_proxy.get_operators()[op_id];
 
     EvaluationContext eval_context(s, node.get_g(), false, &statistics, true);
-    
-    if(task_properties::is_applicable(op, convert_global_state(s)))
+    State state = convert_global_state(s);
+
+    if(task_properties::is_applicable(op, state))
     {
         /* Apply the top stack operator to the current state
         and push the data entry into the new stack
@@ -423,13 +566,14 @@ SearchStatus EagerSearch::backward_step(fwdbwd::FwdbwdNode fwdbwd_node)
             {
                 // cout << "VERY GOOD WARNING -- 1" << endl;
                 fwdbwd::forward_nodes[succ_state.get_id()].insert(op_id);
-                fwdbwd::FwdbwdNode succ_fwdbwd_node(succ_state.get_id(), op_id, NULL, succ_node.get_real_g());
-                open_list->insert(eval_context, succ_fwdbwd_node);
+                insert_forward_node(eval_context, succ_state.get_id(), op_id, succ_node.get_real_g());
             }
             else
             {
                 // cout << "GOOD WARNING -- 1" << endl;
-                fwdbwd::FwdbwdNode succ_fwdbwd_node(succ_state.get_id(), OperatorID::no_operator, parent_op_stack_node, succ_node.get_real_g());
+                fwdbwd::FwdbwdNode succ_fwdbwd_node(succ_state.get_id(), OperatorID::no_operator, parent_op_stack_node, succ_node.get_real_g(),
+                                                    get_stack_estimate(succ_state, parent_op_stack_node));
+                fwdbwd_statistics.inc_stack_entries();
                 open_list->insert(eval_context, succ_fwdbwd_node);
             }
             if (search_progress.check_progress(eval_context)) {
@@ -451,13 +595,14 @@ SearchStatus EagerSearch::backward_step(fwdbwd::FwdbwdNode fwdbwd_node)
                     if(fwdbwd::forward_nodes[succ_state.get_id()].find(op_id) == fwdbwd::forward_nodes[succ_state.get_id()].end())
                     {
                         fwdbwd::forward_nodes[succ_state.get_id()].insert(op_id);
-                        fwdbwd::FwdbwdNode succ_fwdbwd_node(succ_state.get_id(), op_id, NULL, succ_node.get_real_g());
-                        open_list->insert(eval_context, succ_fwdbwd_node);
+                        insert_forward_node(eval_context, succ_state.get_id(), op_id, succ_node.get_real_g());
                     }
                 }
                 else
                 {
-                    fwdbwd::FwdbwdNode succ_fwdbwd_node(succ_state.get_id(), OperatorID::no_operator, parent_op_stack_node, succ_node.get_real_g());
+                    fwdbwd::FwdbwdNode succ_fwdbwd_node(succ_state.get_id(), OperatorID::no_operator, parent_op_stack_node, succ_node.get_real_g(),
+                                                        get_stack_estimate(succ_state, parent_op_stack_node));
+                    fwdbwd_statistics.inc_stack_entries();
                     open_list->insert(eval_context, succ_fwdbwd_node);
                 }
             }
@@ -465,23 +610,50 @@ SearchStatus EagerSearch::backward_step(fwdbwd::FwdbwdNode fwdbwd_node)
     }
     else
     {
-        for (OperatorID oid : (fwdbwd::dependency_map[op_stack_node->get_operator()]))
-        {
-            OperatorProxy op = task_proxy.get_operators()[oid];
-            pair<OpStackNode*, bool> child = op_stack_node->gen_child(oid, id, op.get_cost());
+        if (subgoal_failure_cache && subgoal_failure_cache->lookup_and_store(state, op, fwdbwd_node))
+            return IN_PROGRESS;
 
-            if(child.second)
-            {
-                fwdbwd::FwdbwdNode succ_fwdbwd_node(id, OperatorID::no_operator, child.first, fwdbwd_node.get_g());
-                open_list->insert(eval_context, succ_fwdbwd_node);
-            }
-        }
+        push_dependent_stacks(fwdbwd_node, s, eval_context);
     }
     return IN_PROGRESS;
 }
 
+void EagerSearch::push_dependent_stacks(
+    const fwdbwd::FwdbwdNode &fwdbwd_node, const GlobalState &s, EvaluationContext &eval_context)
+{
+    StateID id = fwdbwd_node.get_state();
+    OpStackNode* op_stack_node = fwdbwd_node.get_stack_pointer();
+    for (OperatorID oid : (fwdbwd::dependency_map[op_stack_node->get_operator()]))
+    {
+        OperatorProxy op = task_proxy.get_operators()[oid];
+        pair<OpStackNode*, bool> child = op_stack_node->gen_child(oid, id, op.get_cost());
+
+        if(child.second)
+        {
+            fwdbwd::FwdbwdNode succ_fwdbwd_node(id, OperatorID::no_operator, child.first, fwdbwd_node.get_g(),
+                                                get_stack_estimate(s, child.first));
+            fwdbwd_statistics.inc_stack_entries();
+            open_list->insert(eval_context, succ_fwdbwd_node);
+        }
+    }
+}
+
+void EagerSearch::resume_pruned_backward_steps()
+{
+    for (const fwdbwd::FwdbwdNode &fwdbwd_node : subgoal_failure_cache->disable())
+    {
+        GlobalState s = state_registry.lookup_state(fwdbwd_node.get_state());
+        SearchNode node = search_space.get_node(s);
+        EvaluationContext eval_context(s, node.get_g(), false, &statistics, true);
+        push_dependent_stacks(fwdbwd_node, s, eval_context);
+    }
+}
+
 pair<fwdbwd::FwdbwdNode, bool> EagerSearch::fetch_next_node() {
     while (true) {
+        if (open_list->empty() && subgoal_failure_cache &&
+            subgoal_failure_cache->has_pruned_steps())
+            resume_pruned_backward_steps();
         if (open_list->empty()) {
             cout << "Completely explored state space -- no solution!" << endl;
             fwdbwd::FwdbwdNode dummy_node(StateID::no_state, OperatorID::no_operator, NULL, 0);
@@ -548,34 +720,4 @@ State EagerSearch::convert_global_state(const GlobalState &global_state) const {
     return task_proxy.convert_ancestor_state(global_state.unpack());
 }
 
-vector<fwdbwd::FwdbwdOps> EagerSearch::generate_fwdbwd_ops(GlobalState s, OperatorID op_id)
-{
-        vector<OperatorID> base_ops;
-        vector<fwdbwd::FwdbwdOps> fwdbwd_ops;
-
-        
-        if((op_id == OperatorID::no_operator) || fwdbwd::goal_ops[op_id])
-        {
-            successor_generator.generate_applicable_ops(s, base_ops);
-            for(OperatorID id: base_ops)
-                fwdbwd_ops.push_back(make_pair(id, true));
-        }
-        else
-        {
-            base_ops = fwdbwd::inverse_map[op_id];
-            State state = convert_global_state(s);
-
-            for(OperatorID id: base_ops)
-            {
-                OperatorProxy op = task_proxy.get_operators()[id];
-                if(task_properties::is_applicable(op, state))
-                    fwdbwd_ops.push_back(make_pair(id, true));
-                else
-                    fwdbwd_ops.push_back(make_pair(id, false));
-            }
-        }
-
-        return fwdbwd_ops;
-}
-
 }
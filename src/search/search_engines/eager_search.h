@@ -1,24 +1,38 @@
 #ifndef SEARCH_ENGINES_EAGER_SEARCH_H
 #define SEARCH_ENGINES_EAGER_SEARCH_H
 
+#include "fwdbwd_common.h"
+
 #include "../open_list.h"
 #include "../search_engine.h"
 #include "../state_id.h"
 #include "../operator_id.h"
 
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 class Evaluator;
 class PruningMethod;
 
+namespace successor_generator {
+class IncrementalSuccessorGenerator;
+}
+
 namespace options {
 class Options;
 }
 
+namespace utils {
+class ThreadPool;
+}
+
 namespace eager_search {
 class EagerSearch : public SearchEngine {
     const bool reopen_closed_nodes;
+    const bool backward_analysis;
+    const bool merge_creating_operators;
+    bool batch_evaluation;
 
     std::unique_ptr<FwdbwdOpenList> open_list;
     std::shared_ptr<Evaluator> f_evaluator;
@@ -28,10 +42,48 @@ class EagerSearch : public SearchEngine {
     std::shared_ptr<Evaluator> lazy_evaluator;
 
     std::shared_ptr<PruningMethod> pruning_method;
+    std::unique_ptr<fwdbwd::SubgoalFailureCache> subgoal_failure_cache;
+    std::unique_ptr<fwdbwd::RegressionStackEvaluator> regression_stack_evaluator;
+    fwdbwd::FwdbwdStatistics fwdbwd_statistics;
 
+    // Creating operators of states with a pending forward entry (merge_creating_operators only).
+    std::unordered_map<StateID, std::vector<OperatorID>> pending_creating_operators;
+    int num_merged_creating_operators;
+
+    /*
+      With incremental_successors, the applicable operators of recently
+      expanded states are kept in a direct-mapped cache (indexed by the
+      state ID modulo its size). A state whose parent is in the cache
+      derives its applicable operators from those of the parent.
+    */
+    std::unique_ptr<successor_generator::IncrementalSuccessorGenerator>
+    incremental_successor_generator;
+    std::vector<StateID> cached_applicable_ops_ids;
+    std::vector<std::vector<OperatorID>> cached_applicable_ops;
+    int num_incremental_generations;
+
+    // Contexts of the new successors of the current expansion (batch_evaluation only).
+    std::vector<EvaluationContext> batch_eval_contexts;
+    // Threads for evaluating batches (only with evaluation_threads > 1).
+    std::unique_ptr<utils::ThreadPool> thread_pool;
+
+    void evaluate_new_successors(const SearchNode &node,
+                                 const std::vector<OperatorID> &succ_op_ids,
+                                 const std::vector<GlobalState> &succ_states,
+                                 std::vector<int> &batch_indices);
+
+    void prepare_search();
+    void generate_applicable_ops(const GlobalState &state, const SearchNode &node,
+                                 std::vector<OperatorID> &applicable_ops);
     std::pair<fwdbwd::FwdbwdNode, bool> fetch_next_node();
     SearchStatus forward_step(fwdbwd::FwdbwdNode fwdbwd_node);
     SearchStatus backward_step(fwdbwd::FwdbwdNode fwdbwd_node);
+    void push_dependent_stacks(const fwdbwd::FwdbwdNode &fwdbwd_node, const GlobalState &s,
+                               EvaluationContext &eval_context);
+    void resume_pruned_backward_steps();
+    void insert_forward_node(EvaluationContext &eval_context, StateID state_id,
+                             OperatorID op_id, int g);
+    int get_stack_estimate(const GlobalState &state, OpStackNode *op_stack_node);
     
     void start_f_value_statistics(EvaluationContext &eval_context);
     void update_f_value_statistics(const SearchNode &node);
@@ -39,15 +91,21 @@ class EagerSearch : public SearchEngine {
     void print_checkpoint_line(int g) const;
 
     State convert_global_state(const GlobalState &global_state) const;
-    std::vector<fwdbwd::FwdbwdOps> generate_fwdbwd_ops(GlobalState s, OperatorID op_id);
 
 protected:
     virtual void initialize() override;
     virtual SearchStatus step() override;
 
+    virtual bool supports_checkpoints() override;
+    virtual std::string get_checkpoint_engine_type() const override;
+    virtual std::string get_checkpoint_open_list_type() const override;
+    virtual void get_checkpointed_evaluators(std::vector<Evaluator *> &evals) override;
+    virtual void save_checkpoint(checkpoint::Writer &writer) const override;
+    virtual void load_checkpoint(checkpoint::Reader &reader) override;
+
 public:
     explicit EagerSearch(const options::Options &opts);
-    virtual ~EagerSearch() = default;
+    virtual ~EagerSearch();
 
     virtual void print_statistics() const override;
 
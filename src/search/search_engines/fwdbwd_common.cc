@@ -0,0 +1,478 @@
+#include "fwdbwd_common.h"
+
+#include "../checkpoint.h"
+#include "../global_state.h"
+#include "../option_parser.h"
+#include "../task_proxy.h"
+
+#include "../task_utils/successor_generator.h"
+#include "../task_utils/task_properties.h"
+
+#include <algorithm>
+#include <iostream>
+
+using namespace std;
+
+namespace fwdbwd{
+
+    unordered_map<OperatorID, vector<OperatorID> > dependency_map;
+    unordered_map<OperatorID, vector<OperatorID> > inverse_map;
+    unordered_map<StateID, unordered_set<OperatorID> > forward_nodes;
+    unordered_map<OperatorID, bool> goal_ops;
+    unordered_map<OperatorID, unordered_map<int, pair<int, bool> > > op_data;
+
+    OpStackNode* stack_root = new OpStackNode(OperatorID::no_operator, NULL);
+
+    bool is_applicable(const GlobalState &state, const OperatorProxy op)
+    {
+        for(FactProxy precondition: op.get_preconditions())
+        {
+            if(state[precondition.get_variable().get_id()] != precondition.get_value())
+            return false;
+        }
+        return true;
+    }
+
+    // CHANGE: New function added, do check functionality
+    // RECHECK: Vulnerable function, created in one go.
+    void generate_op_data(const TaskProxy task_proxy)
+    {
+        for(OperatorProxy op: task_proxy.get_operators())
+        {
+            for (FactProxy precondition: op.get_preconditions())
+            {
+                op_data[OperatorID(op.get_id())][precondition.get_variable().get_id()].first = precondition.get_value();
+                op_data[OperatorID(op.get_id())][precondition.get_variable().get_id()].second = false;
+            }
+            for (EffectProxy eff: op.get_effects())
+            {
+                FactProxy f = eff.get_fact();
+                if(op_data[OperatorID(op.get_id())][f.get_variable().get_id()].first != f.get_value())
+                    op_data[OperatorID(op.get_id())][f.get_variable().get_id()].second = true; 
+            }
+        }
+    }
+
+    bool check_goal_op(const OperatorProxy op, const TaskProxy task_proxy)
+    {
+        for(FactProxy precondition: op.get_preconditions())
+        {
+            for(FactProxy goal_fact: task_proxy.get_goals()) 
+            {
+                bool flag1 = (precondition.get_variable() == goal_fact.get_variable());
+                bool flag2 = (precondition.get_value() != goal_fact.get_value());
+                bool flag3 = op_data[OperatorID(op.get_id())][precondition.get_variable().get_id()].second;
+                if(flag1 && flag2 && flag3)
+                    return true;
+            }
+        }
+        return false;
+    }
+
+    // CHANGE: A bug was resolved in this function, do check again.
+    void generate_goal_ops(const TaskProxy task_proxy)
+    {
+        for(OperatorProxy op: task_proxy.get_operators())
+          goal_ops[OperatorID(op.get_id())] = check_goal_op(op, task_proxy);
+    }
+
+    bool is_dependent(OperatorProxy op1, OperatorProxy op2)
+    { 
+        // return true op1 supplies some facts to op2
+
+        PreconditionsProxy pre1 = op1.get_preconditions();
+        PreconditionsProxy pre2 = op2.get_preconditions();
+
+        for(FactProxy p2: pre2)
+        {
+            for(FactProxy p1: pre1)
+            {
+                if(p1.get_variable() == p2.get_variable())
+                {
+                    if(p1.get_value() != p2.get_value())
+                    {
+                        if(op_data[OperatorID(op1.get_id())][p1.get_variable().get_id()].second)
+                            return true;
+                    }
+                    else
+                    {
+                        if(!op_data[OperatorID(op1.get_id())][p1.get_variable().get_id()].second)
+                            return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    void generate_dependency_graph(const TaskProxy task_proxy)
+    {
+        OperatorsProxy operators = task_proxy.get_operators();
+      
+        for (OperatorProxy op1 : operators)
+        {
+            for(OperatorProxy op2 : operators)
+            {
+                if(op1 != op2)
+                {
+                    if(is_dependent(op1, op2))
+                    {
+                        dependency_map[OperatorID(op1.get_id())].push_back(OperatorID(op2.get_id()));
+                        inverse_map[OperatorID(op2.get_id())].push_back(OperatorID(op1.get_id()));
+                    }
+                }
+            }
+        }
+    }
+
+    // Call all the functions here
+    void calculate(const TaskProxy task_proxy)
+    {
+        dependency_map.clear();
+        inverse_map.clear();
+        forward_nodes.clear();
+        goal_ops.clear();
+        op_data.clear();
+        // The stack tree stores state ids of the previous search.
+        delete stack_root;
+        stack_root = new OpStackNode(OperatorID::no_operator, NULL);
+
+        generate_op_data(task_proxy);
+        generate_goal_ops(task_proxy);
+        generate_dependency_graph(task_proxy);
+    }
+
+    vector<FwdbwdOps> generate_fwdbwd_ops(
+        const TaskProxy &task_proxy,
+        const successor_generator::SuccessorGenerator &successor_generator,
+        const GlobalState &s, OperatorID op_id)
+    {
+        vector<OperatorID> base_ops;
+        vector<FwdbwdOps> fwdbwd_ops;
+
+        if((op_id == OperatorID::no_operator) || goal_ops[op_id])
+        {
+            successor_generator.generate_applicable_ops(s, base_ops);
+            for(OperatorID id: base_ops)
+                fwdbwd_ops.push_back(make_pair(id, true));
+        }
+        else
+        {
+            base_ops = inverse_map[op_id];
+            State state = task_proxy.convert_ancestor_state(s.unpack());
+
+            for(OperatorID id: base_ops)
+            {
+                OperatorProxy op = task_proxy.get_operators()[id];
+                if(task_properties::is_applicable(op, state))
+                    fwdbwd_ops.push_back(make_pair(id, true));
+                else
+                    fwdbwd_ops.push_back(make_pair(id, false));
+            }
+        }
+
+        return fwdbwd_ops;
+    }
+
+    vector<FwdbwdOps> generate_fwdbwd_ops(
+        const TaskProxy &task_proxy,
+        const successor_generator::SuccessorGenerator &successor_generator,
+        const GlobalState &s, const vector<OperatorID> &op_ids)
+    {
+        for(OperatorID op_id: op_ids)
+        {
+            if((op_id == OperatorID::no_operator) || goal_ops[op_id])
+                return generate_fwdbwd_ops(task_proxy, successor_generator, s, OperatorID::no_operator);
+        }
+
+        vector<FwdbwdOps> fwdbwd_ops;
+        vector<bool> seen(task_proxy.get_operators().size(), false);
+        State state = task_proxy.convert_ancestor_state(s.unpack());
+
+        for(OperatorID op_id: op_ids)
+        {
+            for(OperatorID id: inverse_map[op_id])
+            {
+                if(seen[id.get_index()])
+                    continue;
+                seen[id.get_index()] = true;
+                OperatorProxy op = task_proxy.get_operators()[id];
+                fwdbwd_ops.push_back(make_pair(id, task_properties::is_applicable(op, state)));
+            }
+        }
+
+        return fwdbwd_ops;
+    }
+
+    static void save_stack_node(checkpoint::Writer &writer, OpStackNode *node)
+    {
+        writer.add_stack_node(node);
+        writer.write(node->get_children().size());
+        for(const auto &op_and_child: node->get_children())
+        {
+            OpStackNode *child = op_and_child.second;
+            writer.write(child->get_operator());
+            writer.write(child->get_cost() - node->get_cost());
+            const unordered_set<StateID> &states = child->get_states();
+            writer.write_vector(vector<StateID>(states.begin(), states.end()));
+            save_stack_node(writer, child);
+        }
+    }
+
+    static void load_stack_node(checkpoint::Reader &reader, OpStackNode *node)
+    {
+        reader.add_stack_node(node);
+        size_t num_children = reader.read<size_t>();
+        for(size_t i = 0; i < num_children; ++i)
+        {
+            OperatorID op_id = reader.read<OperatorID>();
+            int op_cost = reader.read<int>();
+            vector<StateID> states = reader.read_vector<StateID>();
+            // gen_child stores a state, so every child has at least one.
+            if(states.empty())
+                reader.fail("invalid operator stack");
+            OpStackNode *child = node->gen_child(op_id, states[0], op_cost).first;
+            for(StateID state_id: states)
+                child->store_state(state_id);
+            load_stack_node(reader, child);
+        }
+    }
+
+    void save_search_data(checkpoint::Writer &writer)
+    {
+        writer.write(forward_nodes.size());
+        for(const auto &state_and_ops: forward_nodes)
+        {
+            writer.write(state_and_ops.first);
+            writer.write_vector(vector<OperatorID>(
+                state_and_ops.second.begin(), state_and_ops.second.end()));
+        }
+        save_stack_node(writer, stack_root);
+    }
+
+    void load_search_data(checkpoint::Reader &reader)
+    {
+        size_t num_forward_nodes = reader.read<size_t>();
+        for(size_t i = 0; i < num_forward_nodes; ++i)
+        {
+            StateID state_id = reader.read<StateID>();
+            vector<OperatorID> op_ids = reader.read_vector<OperatorID>();
+            forward_nodes[state_id].insert(op_ids.begin(), op_ids.end());
+        }
+        load_stack_node(reader, stack_root);
+    }
+
+    FwdbwdStatistics::FwdbwdStatistics()
+        : forward_steps(0),
+          backward_steps(0),
+          stack_entries(0)
+    {
+    }
+
+    void FwdbwdStatistics::print_statistics() const
+    {
+        cout << "Forward steps: " << forward_steps << endl;
+        cout << "Backward steps: " << backward_steps << endl;
+        cout << "Operator stack entries: " << stack_entries << endl;
+    }
+
+    SubgoalFailureCache::SubgoalFailureCache()
+        : enabled(true),
+          num_hits(0),
+          num_saved_insertions(0),
+          num_resumed_steps(0)
+    {
+    }
+
+    bool SubgoalFailureCache::lookup_and_store(
+        const State &state, const OperatorProxy &op, const FwdbwdNode &entry)
+    {
+        if(!enabled)
+            return false;
+
+        vector<int> key;
+        key.reserve(op.get_preconditions().size() + 1);
+        key.push_back(op.get_id());
+        for(FactProxy precondition: op.get_preconditions())
+            key.push_back(state[precondition.get_variable()].get_value());
+
+        if(failures.insert(move(key)).second)
+            return false;
+        ++num_hits;
+        pruned_steps.push_back(entry);
+
+        // Only count the stacks that gen_child would have created for the state.
+        OpStackNode *op_stack_node = entry.get_stack_pointer();
+        const auto &children = op_stack_node->get_children();
+        for(OperatorID oid: dependency_map[OperatorID(op.get_id())])
+        {
+            auto child = children.find(oid);
+            if(child == children.end() || !child->second->get_states().count(entry.get_state()))
+                ++num_saved_insertions;
+        }
+        return true;
+    }
+
+    vector<FwdbwdNode> SubgoalFailureCache::disable()
+    {
+        cout << "Open list is empty, resuming " << pruned_steps.size()
+             << " backward steps pruned by the subgoal failure cache." << endl;
+        enabled = false;
+        // The resumed steps make the insertions after all.
+        num_saved_insertions = 0;
+        num_resumed_steps += pruned_steps.size();
+        vector<FwdbwdNode> steps;
+        steps.swap(pruned_steps);
+        return steps;
+    }
+
+    void SubgoalFailureCache::print_statistics() const
+    {
+        cout << "Subgoal failure cache entries: " << failures.size() << endl;
+        cout << "Subgoal failure cache hits: " << num_hits << endl;
+        cout << "Open list insertions saved by subgoal failure cache: "
+             << num_saved_insertions << endl;
+        if(!enabled)
+            cout << "Backward steps resumed after disabling subgoal failure cache: "
+                 << num_resumed_steps << endl;
+    }
+
+    void SubgoalFailureCache::save(checkpoint::Writer &writer) const
+    {
+        writer.write(failures.size());
+        for(const vector<int> &failure: failures)
+            writer.write_vector(failure);
+        writer.write_vector(pruned_steps);
+        writer.write(enabled);
+        writer.write(num_hits);
+        writer.write(num_saved_insertions);
+        writer.write(num_resumed_steps);
+    }
+
+    void SubgoalFailureCache::load(checkpoint::Reader &reader)
+    {
+        size_t num_failures = reader.read<size_t>();
+        for(size_t i = 0; i < num_failures; ++i)
+            failures.insert(reader.read_vector<int>());
+        pruned_steps = reader.read_vector<FwdbwdNode>();
+        enabled = reader.read<bool>();
+        num_hits = reader.read<int>();
+        num_saved_insertions = reader.read<int>();
+        num_resumed_steps = reader.read<int>();
+    }
+
+    const vector<FactPair> &RegressionStackEvaluator::get_subgoal(
+        const TaskProxy &task_proxy, OpStackNode *op_stack_node)
+    {
+        const vector<FactPair> *stored_subgoal = op_stack_node->get_subgoal();
+        if(stored_subgoal)
+            return *stored_subgoal;
+
+        vector<FactPair> subgoal;
+        // The root of the stack tree has no operator and an empty subgoal.
+        if(op_stack_node->get_parent() != NULL)
+        {
+            OperatorProxy op = task_proxy.get_operators()[op_stack_node->get_operator()];
+            vector<int> touched_vars;
+            for(FactProxy precondition: op.get_preconditions())
+            {
+                subgoal.push_back(precondition.get_pair());
+                touched_vars.push_back(precondition.get_variable().get_id());
+            }
+            for(EffectProxy eff: op.get_effects())
+                touched_vars.push_back(eff.get_fact().get_variable().get_id());
+            sort(touched_vars.begin(), touched_vars.end());
+
+            for(const FactPair &fact: get_subgoal(task_proxy, op_stack_node->get_parent()))
+            {
+                if(!binary_search(touched_vars.begin(), touched_vars.end(), fact.var))
+                    subgoal.push_back(fact);
+            }
+        }
+        op_stack_node->set_subgoal(move(subgoal));
+        return *op_stack_node->get_subgoal();
+    }
+
+    int RegressionStackEvaluator::compute_estimate(
+        const TaskProxy &task_proxy, const GlobalState &state, OpStackNode *op_stack_node)
+    {
+        int num_unsatisfied = 0;
+        for(const FactPair &fact: get_subgoal(task_proxy, op_stack_node))
+        {
+            if(state[fact.var] != fact.value)
+                ++num_unsatisfied;
+        }
+        return num_unsatisfied;
+    }
+
+    void add_options_to_parser(options::OptionParser &parser)
+    {
+        parser.add_option<bool>(
+            "cache_subgoal_failures",
+            "do not push the dependent operators of an inapplicable stack "
+            "operator again if the operator already failed in a state with "
+            "the same values on its precondition variables. The pruned "
+            "backward steps are resumed (and the cache is disabled) if the "
+            "open list runs empty, so the search stays complete.",
+            "false");
+        parser.add_option<bool>(
+            "regression_stack_estimate",
+            "add the number of facts of the regressed subgoal of an operator "
+            "stack that do not hold in the state to the open list key of the "
+            "entry, so that backward chains that are nearly applicable are "
+            "expanded first. Only supported by single open lists and "
+            "alternations of them, which add the cost of the operator stack "
+            "to the key as well.",
+            "false");
+    }
+
+    void add_eager_options_to_parser(options::OptionParser &parser)
+    {
+        parser.add_option<bool>(
+            "backward_analysis",
+            "use the operator dependencies to restrict forward expansions "
+            "and to chain backwards from inapplicable operators. If false, "
+            "every state is expanded once with all applicable operators "
+            "(classic eager search), which is useful as a baseline.",
+            "true");
+        parser.add_option<bool>(
+            "merge_creating_operators",
+            "keep at most one forward open list entry per state. If a state "
+            "is reached by another operator while it is still waiting for "
+            "expansion, the operator is added to the pending entry, and the "
+            "expansion considers the union of the operators that depend on "
+            "all pending creating operators. Only used with backward "
+            "analysis, since classic search ignores the creating operators.",
+            "false");
+        parser.add_option<bool>(
+            "incremental_successors",
+            "derive the applicable operators of a state from those of its "
+            "parent if the parent was expanded recently, instead of running "
+            "the successor generator. Only operators with preconditions on "
+            "variables changed by the transition are checked. This pays off "
+            "for tasks with many applicable operators per state. Only used "
+            "without backward analysis.",
+            "false");
+        parser.add_option<bool>(
+            "batch_evaluation",
+            "evaluate all new successors of an expanded state in one batch "
+            "before inserting them into the open list. Heuristics that "
+            "support it (add, ff) then explore the relaxed task for several "
+            "states at once. Only used without backward analysis and "
+            "without path-dependent evaluators.",
+            "false");
+        parser.add_option<int>(
+            "evaluation_threads",
+            "number of threads for batch evaluation (implies batch_evaluation "
+            "if larger than 1). Each thread evaluates the states with its own "
+            "copy of each heuristic. The copies share the data that does not "
+            "change during the search. Only add, ff, hmax, lmcut, cea and "
+            "operatorcounting (with lmcut_constraints, state_equation_constraints "
+            "and pho_constraints) support several threads; the planner exits "
+            "with an error for other heuristics. The successors are inserted "
+            "into the open list in the same order as with a single thread, so "
+            "the search does not depend on the number of threads.",
+            "1",
+            options::Bounds("1", "infinity"));
+    }
+}
@@ -0,0 +1,187 @@
+#ifndef SEARCH_ENGINES_FWDBWD_COMMON_H
+#define SEARCH_ENGINES_FWDBWD_COMMON_H
+
+/*
+  This module contains the operator dependency analysis and the helper
+  functions shared by the search engines that implement forward search
+  with backward analysis (eager and lazy).
+
+  The analysis is computed once per search by calling calculate() from
+  the initialize() method of the search engine.
+*/
+
+#include "../abstract_task.h"
+#include "../operator_id.h"
+
+#include "../utils/hash.h"
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class GlobalState;
+class OperatorProxy;
+class State;
+class TaskProxy;
+
+namespace checkpoint {
+class Reader;
+class Writer;
+}
+
+namespace options {
+class OptionParser;
+}
+
+namespace successor_generator {
+class SuccessorGenerator;
+}
+
+namespace fwdbwd {
+// dependency_map[op1] contains op2 iff op1 supplies some fact to op2.
+extern std::unordered_map<OperatorID, std::vector<OperatorID>> dependency_map;
+// inverse_map is the transpose of dependency_map.
+extern std::unordered_map<OperatorID, std::vector<OperatorID>> inverse_map;
+// Creating operators with which a state has already been queued for expansion.
+extern std::unordered_map<StateID, std::unordered_set<OperatorID>> forward_nodes;
+extern std::unordered_map<OperatorID, bool> goal_ops;
+// the first int in the unordered map below tracks to the variable id
+extern std::unordered_map<OperatorID, std::unordered_map<int, std::pair<int, bool>>> op_data;
+
+extern OpStackNode *stack_root;
+
+bool is_applicable(const GlobalState &state, const OperatorProxy op);
+
+/*
+  Compute op_data, goal_ops and the dependency graph for the given
+  task. Calling this again (e.g. from a second search engine in an
+  iterated search) discards all data of the previous search.
+*/
+void calculate(const TaskProxy task_proxy);
+
+/*
+  Return the operators to consider when expanding state s, which was
+  reached by op_id. The flag of each entry tells whether the operator
+  is applicable in s (forward step) or has to be achieved by backward
+  chaining first.
+*/
+std::vector<FwdbwdOps> generate_fwdbwd_ops(
+    const TaskProxy &task_proxy,
+    const successor_generator::SuccessorGenerator &successor_generator,
+    const GlobalState &s, OperatorID op_id);
+
+/*
+  Like above, but for a state that was reached by several operators.
+  Each operator in the union of the inverse_map entries of op_ids is
+  returned (and checked for applicability) only once.
+*/
+std::vector<FwdbwdOps> generate_fwdbwd_ops(
+    const TaskProxy &task_proxy,
+    const successor_generator::SuccessorGenerator &successor_generator,
+    const GlobalState &s, const std::vector<OperatorID> &op_ids);
+
+/*
+  Write forward_nodes and the operator stack tree to a checkpoint, and
+  restore them after calling calculate(). The stack nodes are registered
+  with the writer and reader, so open list entries written after them
+  can refer to them.
+*/
+void save_search_data(checkpoint::Writer &writer);
+void load_search_data(checkpoint::Reader &reader);
+
+// Counters that are specific to search with backward analysis.
+class FwdbwdStatistics {
+    int forward_steps;
+    int backward_steps;
+    int stack_entries;
+public:
+    FwdbwdStatistics();
+
+    void inc_forward_steps() {++forward_steps;}
+    void inc_backward_steps() {++backward_steps;}
+    void inc_stack_entries() {++stack_entries;}
+
+    void print_statistics() const;
+};
+
+/*
+  Remembers the backward steps in which the top operator of a stack
+  was not applicable. A failure is identified by the operator and the
+  values of the state on the precondition variables of the operator,
+  so states that agree on these variables miss the same preconditions.
+  Pushing the dependent operators again for such a context often only
+  repeats backward chains that were already queued.
+
+  The chains may however continue from a different operator stack or
+  state, so pruned backward steps are only deferred: when the open list
+  runs empty, the search disables the cache and resumes all pruned
+  steps. The search therefore only reports that there is no solution
+  if it would do so without the cache.
+*/
+class SubgoalFailureCache {
+    utils::HashSet<std::vector<int>> failures;
+    // Open list entries whose backward step was pruned.
+    std::vector<FwdbwdNode> pruned_steps;
+    bool enabled;
+    int num_hits;
+    int num_saved_insertions;
+    int num_resumed_steps;
+public:
+    SubgoalFailureCache();
+
+    /*
+      Return true if the cache is enabled and op already failed in a
+      state that agrees with state on the precondition variables of op.
+      In this case, the backward step of entry (whose top operator is
+      op) is remembered, so that it can be resumed later. Otherwise,
+      store the failure and return false.
+    */
+    bool lookup_and_store(const State &state, const OperatorProxy &op,
+                          const FwdbwdNode &entry);
+
+    bool has_pruned_steps() const {
+        return !pruned_steps.empty();
+    }
+
+    /*
+      Disable the cache and return the pruned backward steps, for which
+      the search then pushes the dependent operators.
+    */
+    std::vector<FwdbwdNode> disable();
+
+    void print_statistics() const;
+
+    void save(checkpoint::Writer &writer) const;
+    void load(checkpoint::Reader &reader);
+};
+
+/*
+  Estimates how far an operator stack is from being applicable in a
+  state. The subgoal of a stack is obtained by regressing the
+  preconditions of its operators from the bottom of the stack to the
+  top, ignoring delete interactions: the subgoal of a node contains
+  the preconditions of its operator and all facts of the subgoal of
+  its parent on variables that the operator neither requires nor
+  changes. The estimate is the number of subgoal facts that do not
+  hold in the state.
+
+  Subgoals are computed incrementally from the parent node and stored
+  in the nodes of the stack tree (and thus freed with it), so scoring
+  an entry only compares the subgoal of its stack with the state.
+*/
+class RegressionStackEvaluator {
+    const std::vector<FactPair> &get_subgoal(
+        const TaskProxy &task_proxy, OpStackNode *op_stack_node);
+public:
+    int compute_estimate(const TaskProxy &task_proxy, const GlobalState &state,
+                         OpStackNode *op_stack_node);
+};
+
+// Add the options that are common to all search engines with backward analysis.
+void add_options_to_parser(options::OptionParser &parser);
+
+// Add the options that are only supported by eager search.
+void add_eager_options_to_parser(options::OptionParser &parser);
+}
+
+#endif
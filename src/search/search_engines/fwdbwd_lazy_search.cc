@@ -0,0 +1,343 @@
+#include "fwdbwd_lazy_search.h"
+
+#include "fwdbwd_common.h"
+
+#include "../open_list_factory.h"
+#include "../option_parser.h"
+
+#include "../algorithms/ordered_set.h"
+#include "../task_utils/successor_generator.h"
+#include "../task_utils/task_properties.h"
+#include "../utils/memory.h"
+#include "../utils/rng_options.h"
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+using namespace std;
+
+namespace fwdbwd_lazy_search {
+FwdbwdLazySearch::FwdbwdLazySearch(const Options &opts)
+    : SearchEngine(opts),
+      open_list(opts.get<shared_ptr<OpenListFactory>>("open")->
+                create_fwdbwd_open_list()),
+      reopen_closed_nodes(opts.get<bool>("reopen_closed")),
+      randomize_successors(opts.get<bool>("randomize_successors")),
+      preferred_successors_first(opts.get<bool>("preferred_successors_first")),
+      rng(utils::parse_rng_from_options(opts)),
+      subgoal_failure_cache(opts.get<bool>("cache_subgoal_failures") ?
+                            utils::make_unique_ptr<fwdbwd::SubgoalFailureCache>() : nullptr),
+      regression_stack_evaluator(opts.get<bool>("regression_stack_estimate") ?
+                                 utils::make_unique_ptr<fwdbwd::RegressionStackEvaluator>() : nullptr),
+      current_state(state_registry.get_initial_state()),
+      current_predecessor_id(StateID::no_state),
+      current_operator_id(OperatorID::no_operator),
+      current_op_stack(nullptr),
+      current_g(0),
+      current_real_g(0),
+      current_eval_context(current_state, 0, true, &statistics) {
+    /*
+      We initialize current_eval_context in such a way that the initial node
+      counts as "preferred".
+    */
+    if (regression_stack_evaluator && !open_list->supports_stack_estimates()) {
+        cerr << "regression_stack_estimate is not supported by this open list" << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+}
+
+void FwdbwdLazySearch::set_preferred_operator_evaluators(
+    vector<shared_ptr<Evaluator>> &evaluators) {
+    preferred_operator_evaluators = evaluators;
+}
+
+void FwdbwdLazySearch::initialize() {
+    cout << "Conducting lazy best first search with backward analysis, "
+         << (reopen_closed_nodes ? "with" : "without")
+         << " reopening closed nodes, (real) bound = " << bound << endl;
+
+    assert(open_list);
+
+    fwdbwd::calculate(task_proxy);
+
+    set<Evaluator *> evals;
+    open_list->get_path_dependent_evaluators(evals);
+
+    // Add evaluators that are used for preferred operators (in case they are
+    // not also used in the open list).
+    for (const shared_ptr<Evaluator> &evaluator : preferred_operator_evaluators) {
+        evaluator->get_path_dependent_evaluators(evals);
+    }
+
+    path_dependent_evaluators.assign(evals.begin(), evals.end());
+    const GlobalState &initial_state = state_registry.get_initial_state();
+    for (Evaluator *evaluator : path_dependent_evaluators) {
+        evaluator->notify_initial_state(initial_state);
+    }
+}
+
+void FwdbwdLazySearch::insert_entry(
+    StateID state_id, OperatorID op_id, OpStackNode *op_stack,
+    int new_g, int new_real_g, bool is_preferred) {
+    if (new_real_g >= bound)
+        return;
+    /*
+      The entry is ranked by the heuristic values of current_state, the
+      state it is generated from. The state it leads to is evaluated
+      only when the entry is removed from the open list.
+    */
+    int stack_estimate = 0;
+    if (op_stack) {
+        fwdbwd_statistics.inc_stack_entries();
+        /*
+          If op_id is set, op_stack will be checked in the state reached
+          by op_id, which is not known yet. Its subgoal regressed over
+          op_id is the subgoal of current_op_stack, so we score that one
+          in current_state instead.
+        */
+        if (regression_stack_evaluator)
+            stack_estimate = regression_stack_evaluator->compute_estimate(
+                task_proxy, current_state,
+                op_id == OperatorID::no_operator ? op_stack : current_op_stack);
+    }
+    EvaluationContext new_eval_context(
+        current_eval_context.get_cache(), new_g, is_preferred, nullptr);
+    open_list->insert(new_eval_context,
+                      fwdbwd::FwdbwdNode(state_id, op_id, op_stack, new_real_g,
+                                         stack_estimate));
+}
+
+void FwdbwdLazySearch::push_dependent_stacks(
+    OpStackNode *op_stack_node, StateID state_id) {
+    for (OperatorID oid : fwdbwd::dependency_map[op_stack_node->get_operator()]) {
+        OperatorProxy op = task_proxy.get_operators()[oid];
+        pair<OpStackNode *, bool> child = op_stack_node->gen_child(oid, state_id, op.get_cost());
+        if (child.second)
+            insert_entry(state_id, OperatorID::no_operator, child.first,
+                         current_g, current_real_g, false);
+    }
+}
+
+void FwdbwdLazySearch::forward_step() {
+    ordered_set::OrderedSet<OperatorID> preferred_operators;
+    for (const shared_ptr<Evaluator> &preferred_operator_evaluator : preferred_operator_evaluators) {
+        collect_preferred_operators(current_eval_context,
+                                    preferred_operator_evaluator.get(),
+                                    preferred_operators);
+    }
+
+    StateID id = current_state.get_id();
+    vector<fwdbwd::FwdbwdOps> fwdbwd_ops = fwdbwd::generate_fwdbwd_ops(
+        task_proxy, successor_generator, current_state, current_operator_id);
+    if (randomize_successors) {
+        rng->shuffle(fwdbwd_ops);
+    }
+    if (preferred_successors_first) {
+        stable_partition(
+            fwdbwd_ops.begin(), fwdbwd_ops.end(),
+            [&preferred_operators](const fwdbwd::FwdbwdOps &fwdbwd_op) {
+                return fwdbwd_op.second && preferred_operators.contains(fwdbwd_op.first);
+            });
+    }
+
+    for (const fwdbwd::FwdbwdOps &fwdbwd_op : fwdbwd_ops) {
+        OperatorID op_id = fwdbwd_op.first;
+        OperatorProxy op = task_proxy.get_operators()[op_id];
+        if (fwdbwd_op.second) {
+            statistics.inc_generated();
+            insert_entry(id, op_id, nullptr,
+                         current_g + get_adjusted_cost(op),
+                         current_real_g + op.get_cost(),
+                         preferred_operators.contains(op_id));
+        } else {
+            // Start backward chaining from op and the operators supplying its facts.
+            pair<OpStackNode *, bool> first_child =
+                fwdbwd::stack_root->gen_child(op_id, id, op.get_cost());
+            if (first_child.second)
+                push_dependent_stacks(first_child.first, id);
+        }
+    }
+}
+
+void FwdbwdLazySearch::backward_step() {
+    assert(current_op_stack);
+    OperatorID op_id = current_op_stack->get_operator();
+    OperatorProxy op = task_proxy.get_operators()[op_id];
+    State state = task_proxy.convert_ancestor_state(current_state.unpack());
+
+    if (task_properties::is_applicable(op, state)) {
+        /*
+          Pop the top operator: the state reached by it continues with
+          the rest of the stack, or is expanded forward once the stack
+          is exhausted.
+        */
+        statistics.inc_generated();
+        OpStackNode *parent_op_stack_node = current_op_stack->get_parent();
+        if (parent_op_stack_node == fwdbwd::stack_root)
+            parent_op_stack_node = nullptr;
+        insert_entry(current_state.get_id(), op_id, parent_op_stack_node,
+                     current_g + get_adjusted_cost(op),
+                     current_real_g + op.get_cost(), false);
+    } else if (!subgoal_failure_cache ||
+               !subgoal_failure_cache->lookup_and_store(
+                   state, op, fwdbwd::FwdbwdNode(current_state.get_id(), OperatorID::no_operator,
+                                                 current_op_stack, current_real_g))) {
+        push_dependent_stacks(current_op_stack, current_state.get_id());
+    }
+}
+
+bool FwdbwdLazySearch::reach_current_state() {
+    SearchNode node = search_space.get_node(current_state);
+    if (node.is_dead_end())
+        return false;
+
+    if (current_operator_id == OperatorID::no_operator) {
+        // Backward entries stay in a state that has already been reached.
+        if (current_predecessor_id != StateID::no_state)
+            return true;
+
+        statistics.inc_evaluated_states();
+        print_initial_evaluator_values(current_eval_context);
+        if (open_list->is_dead_end(current_eval_context)) {
+            cout << "Initial state is a dead end." << endl;
+            node.mark_as_dead_end();
+            statistics.inc_dead_ends();
+            return false;
+        }
+        node.open_initial();
+        if (search_progress.check_progress(current_eval_context))
+            print_checkpoint_line(current_g);
+        return true;
+    }
+
+    assert(current_predecessor_id != StateID::no_state);
+    GlobalState parent_state = state_registry.lookup_state(current_predecessor_id);
+    SearchNode parent_node = search_space.get_node(parent_state);
+    OperatorProxy current_operator = task_proxy.get_operators()[current_operator_id];
+    bool reopened = false;
+
+    if (node.is_new()) {
+        for (Evaluator *evaluator : path_dependent_evaluators)
+            evaluator->notify_state_transition(
+                parent_state, current_operator_id, current_state);
+        statistics.inc_evaluated_states();
+        if (open_list->is_dead_end(current_eval_context)) {
+            node.mark_as_dead_end();
+            statistics.inc_dead_ends();
+            return false;
+        }
+        node.open(parent_node, current_operator, get_adjusted_cost(current_operator));
+        if (search_progress.check_progress(current_eval_context)) {
+            print_checkpoint_line(current_g);
+            reward_progress();
+        }
+    } else if (current_g < node.get_g()) {
+        if (reopen_closed_nodes) {
+            node.reopen(parent_node, current_operator, get_adjusted_cost(current_operator));
+            statistics.inc_reopened();
+            reopened = true;
+        } else {
+            node.update_parent(parent_node, current_operator, get_adjusted_cost(current_operator));
+        }
+    }
+
+    /*
+      Only continue if the state has not been queued with this operator
+      or stack yet, or if it has been reopened with a lower g value.
+    */
+    bool is_new_entry = current_op_stack ?
+        current_op_stack->store_state(current_state.get_id()) :
+        fwdbwd::forward_nodes[current_state.get_id()].insert(current_operator_id).second;
+    return is_new_entry || reopened;
+}
+
+void FwdbwdLazySearch::resume_pruned_backward_steps() {
+    for (const fwdbwd::FwdbwdNode &entry : subgoal_failure_cache->disable()) {
+        current_state = state_registry.lookup_state(entry.get_state());
+        current_op_stack = entry.get_stack_pointer();
+        current_g = search_space.get_node(current_state).get_g();
+        current_real_g = entry.get_g();
+        current_eval_context = EvaluationContext(current_state, current_g, false, &statistics);
+        push_dependent_stacks(current_op_stack, current_state.get_id());
+    }
+}
+
+SearchStatus FwdbwdLazySearch::fetch_next_state() {
+    if (open_list->empty() && subgoal_failure_cache &&
+        subgoal_failure_cache->has_pruned_steps())
+        resume_pruned_backward_steps();
+    if (open_list->empty()) {
+        cout << "Completely explored state space -- no solution!" << endl;
+        return FAILED;
+    }
+
+    fwdbwd::FwdbwdNode next = open_list->remove_min();
+
+    current_predecessor_id = next.get_state();
+    current_operator_id = next.get_operator();
+    current_op_stack = next.get_stack_pointer();
+    GlobalState current_predecessor = state_registry.lookup_state(current_predecessor_id);
+    SearchNode pred_node = search_space.get_node(current_predecessor);
+
+    if (current_operator_id == OperatorID::no_operator) {
+        current_state = current_predecessor;
+        current_g = pred_node.get_g();
+        current_real_g = pred_node.get_real_g();
+    } else {
+        OperatorProxy current_operator = task_proxy.get_operators()[current_operator_id];
+        assert(task_properties::is_applicable(current_operator, current_predecessor.unpack()));
+        current_state = state_registry.get_successor_state(current_predecessor, current_operator);
+        current_g = pred_node.get_g() + get_adjusted_cost(current_operator);
+        current_real_g = pred_node.get_real_g() + current_operator.get_cost();
+    }
+
+    current_eval_context = EvaluationContext(current_state, current_g, true, &statistics);
+
+    return IN_PROGRESS;
+}
+
+SearchStatus FwdbwdLazySearch::step() {
+    // Invariants:
+    // - current_state is the state the last removed entry leads to.
+    // - current_predecessor_id is the state in which current_operator_id was
+    //   applied, or current_state itself if current_operator_id is no_operator.
+    // - current_op_stack is the operator stack to continue backward chaining
+    //   with, or NULL if current_state is to be expanded forward.
+    // - current_g and current_real_g are the g values of current_state along
+    //   this entry (using adjusted and real costs).
+
+    if (reach_current_state()) {
+        if (check_goal_and_set_plan(current_state))
+            return SOLVED;
+        if (current_op_stack) {
+            fwdbwd_statistics.inc_backward_steps();
+            backward_step();
+        } else {
+            fwdbwd_statistics.inc_forward_steps();
+            forward_step();
+        }
+        statistics.inc_expanded();
+    }
+    return fetch_next_state();
+}
+
+void FwdbwdLazySearch::reward_progress() {
+    open_list->boost_preferred();
+}
+
+void FwdbwdLazySearch::print_checkpoint_line(int g) const {
+    cout << "[g=" << g << ", ";
+    statistics.print_basic_statistics();
+    cout << "]" << endl;
+}
+
+void FwdbwdLazySearch::print_statistics() const {
+    statistics.print_detailed_statistics();
+    fwdbwd_statistics.print_statistics();
+    if (subgoal_failure_cache)
+        subgoal_failure_cache->print_statistics();
+    search_space.print_statistics();
+}
+}
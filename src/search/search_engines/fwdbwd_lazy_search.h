@@ -0,0 +1,87 @@
+#ifndef SEARCH_ENGINES_FWDBWD_LAZY_SEARCH_H
+#define SEARCH_ENGINES_FWDBWD_LAZY_SEARCH_H
+
+#include "fwdbwd_common.h"
+
+#include "../evaluation_context.h"
+#include "../evaluator.h"
+#include "../global_state.h"
+#include "../open_list.h"
+#include "../operator_id.h"
+#include "../search_engine.h"
+#include "../search_progress.h"
+#include "../search_space.h"
+
+#include "../utils/rng.h"
+
+#include <memory>
+#include <vector>
+
+namespace options {
+class Options;
+}
+
+/*
+  Forward search with backward analysis and deferred evaluation.
+
+  Open list entries are edges: an entry (s, op, stack) stands for the
+  state reached by applying op in s (or s itself if op is
+  no_operator), which is then expanded forward (stack == NULL) or
+  used to continue backward chaining on the given operator stack.
+  Entries are inserted with the heuristic values of s, and a state is
+  only evaluated when the first entry leading to it is removed from
+  the open list.
+*/
+namespace fwdbwd_lazy_search {
+class FwdbwdLazySearch : public SearchEngine {
+protected:
+    std::unique_ptr<FwdbwdOpenList> open_list;
+
+    // Search behavior parameters
+    bool reopen_closed_nodes; // whether to re-expand states reached on a cheaper path
+    bool randomize_successors;
+    bool preferred_successors_first;
+    std::shared_ptr<utils::RandomNumberGenerator> rng;
+
+    std::vector<Evaluator *> path_dependent_evaluators;
+    std::vector<std::shared_ptr<Evaluator>> preferred_operator_evaluators;
+    std::unique_ptr<fwdbwd::SubgoalFailureCache> subgoal_failure_cache;
+    std::unique_ptr<fwdbwd::RegressionStackEvaluator> regression_stack_evaluator;
+    fwdbwd::FwdbwdStatistics fwdbwd_statistics;
+
+    GlobalState current_state;
+    StateID current_predecessor_id;
+    OperatorID current_operator_id;
+    OpStackNode *current_op_stack;
+    int current_g;
+    int current_real_g;
+    EvaluationContext current_eval_context;
+
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+    bool reach_current_state();
+    void forward_step();
+    void backward_step();
+    void insert_entry(StateID state_id, OperatorID op_id,
+                      OpStackNode *op_stack, int new_g, int new_real_g,
+                      bool is_preferred);
+    void push_dependent_stacks(OpStackNode *op_stack_node, StateID state_id);
+    void resume_pruned_backward_steps();
+    SearchStatus fetch_next_state();
+
+    void reward_progress();
+
+    void print_checkpoint_line(int g) const;
+
+public:
+    explicit FwdbwdLazySearch(const options::Options &opts);
+    virtual ~FwdbwdLazySearch() = default;
+
+    void set_preferred_operator_evaluators(std::vector<std::shared_ptr<Evaluator>> &evaluators);
+
+    virtual void print_statistics() const override;
+};
+}
+
+#endif
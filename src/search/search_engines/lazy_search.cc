@@ -41,7 +41,7 @@ void LazySearch::set_preferred_operator_evaluators(
     preferred_operator_evaluators = evaluators;
 }
 
-void LazySearch::initialize() {
+void LazySearch::prepare_search() {
     cout << "Conducting lazy best first search, (real) bound = " << bound << endl;
 
     assert(open_list);
@@ -55,12 +55,64 @@ void LazySearch::initialize() {
     }
 
     path_dependent_evaluators.assign(evals.begin(), evals.end());
+}
+
+void LazySearch::initialize() {
+    prepare_search();
     const GlobalState &initial_state = state_registry.get_initial_state();
     for (Evaluator *evaluator : path_dependent_evaluators) {
         evaluator->notify_initial_state(initial_state);
     }
 }
 
+bool LazySearch::supports_checkpoints() {
+    // Path-dependent evaluators keep information that is not written to checkpoints.
+    set<Evaluator *> evals;
+    open_list->get_path_dependent_evaluators(evals);
+    for (const shared_ptr<Evaluator> &evaluator : preferred_operator_evaluators) {
+        evaluator->get_path_dependent_evaluators(evals);
+    }
+    return evals.empty() && open_list->supports_checkpoints();
+}
+
+string LazySearch::get_checkpoint_engine_type() const {
+    return reopen_closed_nodes ? "lazy reopening closed nodes" : "lazy";
+}
+
+string LazySearch::get_checkpoint_open_list_type() const {
+    return open_list->get_checkpoint_type();
+}
+
+void LazySearch::get_checkpointed_evaluators(vector<Evaluator *> &evals) {
+    open_list->get_checkpointed_evaluators(evals);
+    for (const shared_ptr<Evaluator> &evaluator : preferred_operator_evaluators) {
+        evaluator->get_checkpointed_evaluators(evals);
+    }
+}
+
+void LazySearch::save_checkpoint(checkpoint::Writer &writer) const {
+    // Checkpoints are written after step(), i.e., after fetch_next_state().
+    writer.write(current_state.get_id());
+    writer.write(current_predecessor_id);
+    writer.write(current_operator_id);
+    writer.write(current_g);
+    writer.write(current_real_g);
+    writer.write(rng->get_state());
+    open_list->save(writer);
+}
+
+void LazySearch::load_checkpoint(checkpoint::Reader &reader) {
+    prepare_search();
+    current_state = state_registry.lookup_state(reader.read<StateID>());
+    current_predecessor_id = reader.read<StateID>();
+    current_operator_id = reader.read<OperatorID>();
+    current_g = reader.read<int>();
+    current_real_g = reader.read<int>();
+    current_eval_context = EvaluationContext(current_state, current_g, true, &statistics);
+    rng->set_state(reader.read<string>());
+    open_list->load(reader);
+}
+
 vector<OperatorID> LazySearch::get_successor_operators(
     const ordered_set::OrderedSet<OperatorID> &preferred_operators) const {
     vector<OperatorID> applicable_operators;
@@ -43,6 +43,14 @@ protected:
     virtual void initialize() override;
     virtual SearchStatus step() override;
 
+    virtual bool supports_checkpoints() override;
+    virtual std::string get_checkpoint_engine_type() const override;
+    virtual std::string get_checkpoint_open_list_type() const override;
+    virtual void get_checkpointed_evaluators(std::vector<Evaluator *> &evals) override;
+    virtual void save_checkpoint(checkpoint::Writer &writer) const override;
+    virtual void load_checkpoint(checkpoint::Reader &reader) override;
+
+    void prepare_search();
     void generate_successors();
     SearchStatus fetch_next_state();
 
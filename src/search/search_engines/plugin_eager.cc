@@ -1,4 +1,5 @@
 #include "eager_search.h"
+#include "fwdbwd_common.h"
 #include "search_common.h"
 
 #include "../option_parser.h"
@@ -23,6 +24,8 @@ static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
         "use preferred operators of these evaluators", "[]");
 
     SearchEngine::add_pruning_option(parser);
+    fwdbwd::add_options_to_parser(parser);
+    fwdbwd::add_eager_options_to_parser(parser);
     SearchEngine::add_options_to_parser(parser);
     Options opts = parser.parse();
 
@@ -0,0 +1,66 @@
+#include "fwdbwd_common.h"
+#include "fwdbwd_lazy_search.h"
+#include "search_common.h"
+
+#include "../option_parser.h"
+#include "../plugin.h"
+
+using namespace std;
+
+namespace plugin_fwdbwd_lazy_greedy {
+static const string DEFAULT_LAZY_BOOST = "1000";
+
+static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Greedy search with backward analysis (lazy)",
+        "Forward search with backward analysis that defers the evaluation "
+        "of states until they are removed from the open list. Successors "
+        "and backward chaining entries are ranked by the heuristic values "
+        "of the state they are generated from.");
+    parser.document_note(
+        "Open lists",
+        "The open lists are created in the same way as for lazy_greedy.");
+    parser.document_note(
+        "Successor ordering with backward analysis",
+        "randomize_successors shuffles all operators considered in a "
+        "forward step, including those that start backward chaining. "
+        "preferred_successors_first moves the preferred forward successors "
+        "to the front.");
+    parser.document_note(
+        "Supported tasks",
+        "Like eager search with backward analysis, this search is only "
+        "guaranteed to work for tasks in transition normal form.");
+
+    parser.add_list_option<shared_ptr<Evaluator>>("evals", "evaluators");
+    parser.add_list_option<shared_ptr<Evaluator>>(
+        "preferred",
+        "use preferred operators of these evaluators", "[]");
+    parser.add_option<bool>(
+        "reopen_closed",
+        "expand states again when they are reached on a cheaper path. "
+        "States are never closed by this search, so otherwise a cheaper "
+        "path only updates the parent of a state that has already been "
+        "reached with the same operator or operator stack",
+        "false");
+    parser.add_option<int>(
+        "boost",
+        "boost value for alternation queues that are restricted "
+        "to preferred operator nodes",
+        DEFAULT_LAZY_BOOST);
+    fwdbwd::add_options_to_parser(parser);
+    SearchEngine::add_succ_order_options(parser);
+    SearchEngine::add_options_to_parser(parser);
+    Options opts = parser.parse();
+
+    shared_ptr<fwdbwd_lazy_search::FwdbwdLazySearch> engine;
+    if (!parser.dry_run()) {
+        opts.set("open", search_common::create_greedy_open_list_factory(opts));
+        engine = make_shared<fwdbwd_lazy_search::FwdbwdLazySearch>(opts);
+        vector<shared_ptr<Evaluator>> preferred_list = opts.get_list<shared_ptr<Evaluator>>("preferred");
+        engine->set_preferred_operator_evaluators(preferred_list);
+    }
+    return engine;
+}
+
+static Plugin<SearchEngine> _plugin("fwdbwd_lazy_greedy", _parse);
+}
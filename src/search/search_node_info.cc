@@ -8,3 +8,8 @@ static_assert(
     sizeof(SearchNodeInfo) == info_bytes + padding_bytes,
     "The size of SearchNodeInfo is larger than expected. This probably means "
     "that packing two fields into one integer using bitfields is not supported.");
+
+static_assert(
+    sizeof(SlimSearchNodeInfo) <= 2 * sizeof(StateID) &&
+    sizeof(CompactSearchNodeInfo) <= sizeof(SearchNodeInfo),
+    "The smaller SearchNodeInfo layouts are larger than expected.");
@@ -7,18 +7,52 @@
 // For documentation on classes relevant to storing and working with registered
 // states see the file state_registry.h.
 
-struct SearchNodeInfo {
+/*
+  The search space can store its nodes in one of three layouts. Each
+  layout extends the previous one, so SearchNode accesses the common
+  fields through a SlimSearchNodeInfo reference and only needs to check
+  the layout for the additional fields.
+
+  SLIM: status, g and parent. SearchSpace::trace_path uses the
+    cheapest operator leading from the parent to the node, so the plan
+    may differ from the path of the search (see
+    SearchSpace::find_creating_operator). Searches that reopen closed
+    nodes use COMPACT instead, so that their plans follow the search path.
+  COMPACT: adds the creating operator.
+  FULL: adds real_g. The other layouts use g as real_g, which is only
+    correct if adjusted costs equal real costs.
+*/
+enum class SearchNodeInfoLayout {
+    SLIM,
+    COMPACT,
+    FULL
+};
+
+struct SlimSearchNodeInfo {
     enum NodeStatus {NEW = 0, OPEN = 1, CLOSED = 2, DEAD_END = 3};
 
     unsigned int status : 2;
     int g : 30;
     StateID parent_state_id;
+
+    SlimSearchNodeInfo()
+        : status(NEW), g(-1), parent_state_id(StateID::no_state) {
+    }
+};
+
+struct CompactSearchNodeInfo : public SlimSearchNodeInfo {
     OperatorID creating_operator;
+
+    CompactSearchNodeInfo()
+        : creating_operator(-1) {
+    }
+};
+
+struct SearchNodeInfo : public CompactSearchNodeInfo {
     int real_g;
 
     SearchNodeInfo()
-        : status(NEW), g(-1), parent_state_id(StateID::no_state),
-          creating_operator(-1), real_g(-1) {
+        : real_g(-1) {
     }
 };
 
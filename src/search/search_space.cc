@@ -1,19 +1,26 @@
 #include "search_space.h"
 
+#include "checkpoint.h"
 #include "global_state.h"
 #include "search_node_info.h"
 #include "task_proxy.h"
 
+#include "task_utils/successor_generator.h"
+#include "utils/system.h"
+
 #include <cassert>
+#include <limits>
 
 using namespace std;
 
 SearchNode::SearchNode(const StateRegistry &state_registry,
                        StateID state_id,
-                       SearchNodeInfo &info)
+                       SlimSearchNodeInfo &info,
+                       SearchNodeInfoLayout layout)
     : state_registry(state_registry),
       state_id(state_id),
-      info(info) {
+      info(info),
+      layout(layout) {
     assert(state_id != StateID::no_state);
 }
 
@@ -43,16 +50,43 @@ int SearchNode::get_g() const {
 }
 
 int SearchNode::get_real_g() const {
-    return info.real_g;
+    if (layout == SearchNodeInfoLayout::FULL)
+        return static_cast<const SearchNodeInfo &>(info).real_g;
+    return info.g;
+}
+
+StateID SearchNode::get_parent_state_id() const {
+    return info.parent_state_id;
+}
+
+void SearchNode::set_parent(const SearchNode &parent_node,
+                            const OperatorProxy &parent_op,
+                            int adjusted_cost) {
+    info.g = parent_node.info.g + adjusted_cost;
+    info.parent_state_id = parent_node.get_state_id();
+    if (layout != SearchNodeInfoLayout::SLIM) {
+        static_cast<CompactSearchNodeInfo &>(info).creating_operator =
+            OperatorID(parent_op.get_id());
+    }
+    if (layout == SearchNodeInfoLayout::FULL) {
+        static_cast<SearchNodeInfo &>(info).real_g =
+            parent_node.get_real_g() + parent_op.get_cost();
+    } else {
+        assert(adjusted_cost == parent_op.get_cost());
+    }
 }
 
 void SearchNode::open_initial() {
     assert(info.status == SearchNodeInfo::NEW);
     info.status = SearchNodeInfo::OPEN;
     info.g = 0;
-    info.real_g = 0;
     info.parent_state_id = StateID::no_state;
-    info.creating_operator = OperatorID::no_operator;
+    if (layout != SearchNodeInfoLayout::SLIM) {
+        static_cast<CompactSearchNodeInfo &>(info).creating_operator =
+            OperatorID::no_operator;
+    }
+    if (layout == SearchNodeInfoLayout::FULL)
+        static_cast<SearchNodeInfo &>(info).real_g = 0;
 }
 
 void SearchNode::open(const SearchNode &parent_node,
@@ -60,10 +94,7 @@ void SearchNode::open(const SearchNode &parent_node,
                       int adjusted_cost) {
     assert(info.status == SearchNodeInfo::NEW);
     info.status = SearchNodeInfo::OPEN;
-    info.g = parent_node.info.g + adjusted_cost;
-    info.real_g = parent_node.info.real_g + parent_op.get_cost();
-    info.parent_state_id = parent_node.get_state_id();
-    info.creating_operator = OperatorID(parent_op.get_id());
+    set_parent(parent_node, parent_op, adjusted_cost);
 }
 
 void SearchNode::reopen(const SearchNode &parent_node,
@@ -75,10 +106,7 @@ void SearchNode::reopen(const SearchNode &parent_node,
     // The latter possibility is for inconsistent heuristics, which
     // may require reopening closed nodes.
     info.status = SearchNodeInfo::OPEN;
-    info.g = parent_node.info.g + adjusted_cost;
-    info.real_g = parent_node.info.real_g + parent_op.get_cost();
-    info.parent_state_id = parent_node.get_state_id();
-    info.creating_operator = OperatorID(parent_op.get_id());
+    set_parent(parent_node, parent_op, adjusted_cost);
 }
 
 // like reopen, except doesn't change status
@@ -89,10 +117,7 @@ void SearchNode::update_parent(const SearchNode &parent_node,
            info.status == SearchNodeInfo::CLOSED);
     // The latter possibility is for inconsistent heuristics, which
     // may require reopening closed nodes.
-    info.g = parent_node.info.g + adjusted_cost;
-    info.real_g = parent_node.info.real_g + parent_op.get_cost();
-    info.parent_state_id = parent_node.get_state_id();
-    info.creating_operator = OperatorID(parent_op.get_id());
+    set_parent(parent_node, parent_op, adjusted_cost);
 }
 
 void SearchNode::close() {
@@ -107,22 +132,121 @@ void SearchNode::mark_as_dead_end() {
 void SearchNode::dump(const TaskProxy &task_proxy) const {
     cout << state_id << ": ";
     get_state().dump_fdr();
-    if (info.creating_operator != OperatorID::no_operator) {
+    if (info.parent_state_id == StateID::no_state) {
+        cout << " no parent" << endl;
+    } else if (layout == SearchNodeInfoLayout::SLIM) {
+        cout << " created from " << info.parent_state_id << endl;
+    } else {
+        OperatorID creating_operator =
+            static_cast<const CompactSearchNodeInfo &>(info).creating_operator;
         OperatorsProxy operators = task_proxy.get_operators();
-        OperatorProxy op = operators[info.creating_operator.get_index()];
+        OperatorProxy op = operators[creating_operator.get_index()];
         cout << " created by " << op.get_name()
              << " from " << info.parent_state_id << endl;
-    } else {
-        cout << " no parent" << endl;
     }
 }
 
-SearchSpace::SearchSpace(StateRegistry &state_registry)
-    : state_registry(state_registry) {
+SearchSpace::SearchSpace(StateRegistry &state_registry,
+                         SearchNodeInfoLayout layout)
+    : layout(layout),
+      state_registry(state_registry) {
 }
 
 SearchNode SearchSpace::get_node(const GlobalState &state) {
-    return SearchNode(state_registry, state.get_id(), search_node_infos[state]);
+    switch (layout) {
+    case SearchNodeInfoLayout::SLIM:
+        return SearchNode(state_registry, state.get_id(),
+                          slim_search_node_infos[state], layout);
+    case SearchNodeInfoLayout::COMPACT:
+        return SearchNode(state_registry, state.get_id(),
+                          compact_search_node_infos[state], layout);
+    case SearchNodeInfoLayout::FULL:
+        return SearchNode(state_registry, state.get_id(),
+                          search_node_infos[state], layout);
+    default:
+        ABORT("Unknown search node info layout");
+    }
+}
+
+const SlimSearchNodeInfo &SearchSpace::get_info(const GlobalState &state) const {
+    switch (layout) {
+    case SearchNodeInfoLayout::SLIM:
+        return slim_search_node_infos[state];
+    case SearchNodeInfoLayout::COMPACT:
+        return compact_search_node_infos[state];
+    case SearchNodeInfoLayout::FULL:
+        return search_node_infos[state];
+    default:
+        ABORT("Unknown search node info layout");
+    }
+}
+
+OperatorID SearchSpace::get_creating_operator(const GlobalState &state) const {
+    switch (layout) {
+    case SearchNodeInfoLayout::SLIM:
+        return find_creating_operator(state);
+    case SearchNodeInfoLayout::COMPACT:
+        return compact_search_node_infos[state].creating_operator;
+    case SearchNodeInfoLayout::FULL:
+        return search_node_infos[state].creating_operator;
+    default:
+        ABORT("Unknown search node info layout");
+    }
+}
+
+/*
+  Find the cheapest operator that leads from the parent of state to
+  state. This need not be the operator the search used: engines update
+  the parent of a state without updating the g values of the states
+  reached from it (e.g., eager search without reopening, or search with
+  backward analysis, which never closes states), so the g values do not
+  identify the operator. The plan extracted with the slim layout is
+  therefore a path along the parent pointers that may differ from the
+  path of the search. It is never more expensive than that path, but
+  (as with the other layouts) its cost may differ from the g value of
+  the goal state.
+*/
+OperatorID SearchSpace::find_creating_operator(const GlobalState &state) const {
+    const SlimSearchNodeInfo &info = get_info(state);
+    GlobalState parent_state = state_registry.lookup_state(info.parent_state_id);
+
+    const TaskProxy &task_proxy = state_registry.get_task_proxy();
+    OperatorsProxy operators = task_proxy.get_operators();
+    VariablesProxy variables = task_proxy.get_variables();
+    vector<OperatorID> applicable_ops;
+    successor_generator::g_successor_generators[task_proxy].generate_applicable_ops(
+        parent_state, applicable_ops);
+    OperatorID best_op = OperatorID::no_operator;
+    int best_cost = numeric_limits<int>::max();
+    vector<int> successor_values(variables.size());
+    for (OperatorID op_id : applicable_ops) {
+        OperatorProxy op = operators[op_id];
+        if (op.get_cost() >= best_cost)
+            continue;
+        for (size_t var = 0; var < variables.size(); ++var)
+            successor_values[var] = parent_state[var];
+        for (EffectProxy effect : op.get_effects()) {
+            if (does_fire(effect, parent_state)) {
+                FactPair fact = effect.get_fact().get_pair();
+                successor_values[fact.var] = fact.value;
+            }
+        }
+        bool leads_to_state = true;
+        for (VariableProxy var : variables) {
+            // Derived variables are determined by the other variables.
+            int var_id = var.get_id();
+            if (!var.is_derived() && successor_values[var_id] != state[var_id]) {
+                leads_to_state = false;
+                break;
+            }
+        }
+        if (leads_to_state) {
+            best_op = op_id;
+            best_cost = op.get_cost();
+        }
+    }
+    assert(best_op != OperatorID::no_operator);
+    return best_op;
 }
 
 void SearchSpace::trace_path(const GlobalState &goal_state,
@@ -130,12 +254,13 @@ void SearchSpace::trace_path(const GlobalState &goal_state,
     GlobalState current_state = goal_state;
     assert(path.empty());
     for (;;) {
-        const SearchNodeInfo &info = search_node_infos[current_state];
-        if (info.creating_operator == OperatorID::no_operator) {
-            assert(info.parent_state_id == StateID::no_state);
+        const SlimSearchNodeInfo &info = get_info(current_state);
+        if (info.parent_state_id == StateID::no_state) {
+            assert(layout == SearchNodeInfoLayout::SLIM ||
+                   get_creating_operator(current_state) == OperatorID::no_operator);
             break;
         }
-        path.push_back(info.creating_operator);
+        path.push_back(get_creating_operator(current_state));
         current_state = state_registry.lookup_state(info.parent_state_id);
     }
     reverse(path.begin(), path.end());
@@ -147,20 +272,65 @@ void SearchSpace::dump(const TaskProxy &task_proxy) const {
         /* The body duplicates SearchNode::dump() but we cannot create
            a search node without discarding the const qualifier. */
         GlobalState state = state_registry.lookup_state(id);
-        const SearchNodeInfo &node_info = search_node_infos[state];
+        const SlimSearchNodeInfo &node_info = get_info(state);
         cout << id << ": ";
         state.dump_fdr();
-        if (node_info.creating_operator != OperatorID::no_operator &&
-            node_info.parent_state_id != StateID::no_state) {
-            OperatorProxy op = operators[node_info.creating_operator.get_index()];
+        if (node_info.parent_state_id == StateID::no_state) {
+            cout << "has no parent" << endl;
+        } else if (layout == SearchNodeInfoLayout::SLIM) {
+            cout << " created from " << node_info.parent_state_id << endl;
+        } else {
+            OperatorProxy op =
+                operators[get_creating_operator(state).get_index()];
             cout << " created by " << op.get_name()
                  << " from " << node_info.parent_state_id << endl;
-        } else {
-            cout << "has no parent" << endl;
         }
     }
 }
 
 void SearchSpace::print_statistics() const {
+    cout << "Bytes per search node: ";
+    switch (layout) {
+    case SearchNodeInfoLayout::SLIM:
+        cout << sizeof(SlimSearchNodeInfo) << " (slim layout)" << endl;
+        break;
+    case SearchNodeInfoLayout::COMPACT:
+        cout << sizeof(CompactSearchNodeInfo) << " (compact layout)" << endl;
+        break;
+    case SearchNodeInfoLayout::FULL:
+        cout << sizeof(SearchNodeInfo) << " (full layout)" << endl;
+        break;
+    }
     state_registry.print_statistics();
 }
+
+void SearchSpace::save(checkpoint::Writer &writer) const {
+    writer.write(layout);
+    switch (layout) {
+    case SearchNodeInfoLayout::SLIM:
+        slim_search_node_infos.save(writer, state_registry);
+        break;
+    case SearchNodeInfoLayout::COMPACT:
+        compact_search_node_infos.save(writer, state_registry);
+        break;
+    case SearchNodeInfoLayout::FULL:
+        search_node_infos.save(writer, state_registry);
+        break;
+    }
+}
+
+void SearchSpace::load(checkpoint::Reader &reader) {
+    if (reader.read<SearchNodeInfoLayout>() != layout)
+        reader.fail("the search nodes use a different layout");
+    switch (layout) {
+    case SearchNodeInfoLayout::SLIM:
+        slim_search_node_infos.load(reader, state_registry);
+        break;
+    case SearchNodeInfoLayout::COMPACT:
+        compact_search_node_infos.load(reader, state_registry);
+        break;
+    case SearchNodeInfoLayout::FULL:
+        search_node_infos.load(reader, state_registry);
+        break;
+    }
+}
@@ -16,11 +16,18 @@ class TaskProxy;
 class SearchNode {
     const StateRegistry &state_registry;
     StateID state_id;
-    SearchNodeInfo &info;
+    // Refers to an object of the class that belongs to layout.
+    SlimSearchNodeInfo &info;
+    SearchNodeInfoLayout layout;
+
+    void set_parent(const SearchNode &parent_node,
+                    const OperatorProxy &parent_op,
+                    int adjusted_cost);
 public:
     SearchNode(const StateRegistry &state_registry,
                StateID state_id,
-               SearchNodeInfo &info);
+               SlimSearchNodeInfo &info,
+               SearchNodeInfoLayout layout);
 
     StateID get_state_id() const {
         return state_id;
@@ -34,6 +41,8 @@ public:
 
     int get_g() const;
     int get_real_g() const;
+    // Returns StateID::no_state for the initial state.
+    StateID get_parent_state_id() const;
 
     void open_initial();
     void open(const SearchNode &parent_node,
@@ -53,11 +62,21 @@ public:
 
 
 class SearchSpace {
+    // Only the infos for the chosen layout are used.
+    const SearchNodeInfoLayout layout;
+    PerStateInformation<SlimSearchNodeInfo> slim_search_node_infos;
+    PerStateInformation<CompactSearchNodeInfo> compact_search_node_infos;
     PerStateInformation<SearchNodeInfo> search_node_infos;
 
     StateRegistry &state_registry;
+
+    const SlimSearchNodeInfo &get_info(const GlobalState &state) const;
+    OperatorID get_creating_operator(const GlobalState &state) const;
+    OperatorID find_creating_operator(const GlobalState &state) const;
 public:
-    explicit SearchSpace(StateRegistry &state_registry);
+    explicit SearchSpace(
+        StateRegistry &state_registry,
+        SearchNodeInfoLayout layout = SearchNodeInfoLayout::FULL);
 
     SearchNode get_node(const GlobalState &state);
     void trace_path(const GlobalState &goal_state,
@@ -65,6 +84,10 @@ public:
 
     void dump(const TaskProxy &task_proxy) const;
     void print_statistics() const;
+
+    // Write and restore the node infos of all registered states.
+    void save(checkpoint::Writer &writer) const;
+    void load(checkpoint::Reader &reader);
 };
 
 #endif
@@ -1,11 +1,24 @@
 #ifndef STATE_ID_H
 #define STATE_ID_H
 
+#include <cstdint>
 #include <iostream>
 
 // For documentation on classes relevant to storing and working with registered
 // states see the file state_registry.h.
 
+/*
+  StateIDs use 32-bit integers, which limits a state registry to 2^31
+  states. Compile with USE_64_BIT_STATE_IDS (see the cmake option of
+  the same name) to use 64-bit integers for StateIDs and the hash set
+  of the registry.
+*/
+#ifdef USE_64_BIT_STATE_IDS
+using StateIDValue = std::int64_t;
+#else
+using StateIDValue = int;
+#endif
+
 class StateID {
     friend class StateRegistry;
     friend std::ostream &operator<<(std::ostream &os, StateID id);
@@ -15,17 +28,14 @@ class StateID {
     friend class PerStateArray;
     friend class PerStateBitset;
 
-    int value;
-    explicit StateID(int value_)
+    StateIDValue value;
+    explicit StateID(StateIDValue value_)
         : value(value_) {
     }
 
     // No implementation to prevent default construction
     StateID();
 public:
-    ~StateID() {
-    }
-
     static const StateID no_state;
 
     bool operator==(const StateID &other) const {
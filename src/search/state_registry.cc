@@ -1,27 +1,140 @@
 #include "state_registry.h"
 
+#include "checkpoint.h"
 #include "per_state_information.h"
 #include "task_proxy.h"
 
 #include "task_utils/task_properties.h"
+#include "utils/memory.h"
+
+#include <algorithm>
 
 using namespace std;
 
-StateRegistry::StateRegistry(const TaskProxy &task_proxy)
+/*
+  Maximal number of deltas between a compressed state and the next full
+  copy (see DeltaArrayVector), which bounds the time for decoding.
+*/
+static const int MAX_DELTA_DEPTH = 8;
+static const int DECODED_STATE_CACHE_SIZE = 64;
+/*
+  Whether compressing states saves memory is checked whenever the number
+  of registered states reaches a power of two that is at least this
+  large.
+*/
+static const size_t MIN_STATES_FOR_COMPRESSION_CHECK = 1 << 16;
+
+StateRegistry::StateRegistry(
+    const TaskProxy &task_proxy, StateIDSetType state_id_set_type,
+    bool compress_states, StatePackingType state_packing_type,
+    const shared_ptr<memory_arena::MemoryArena> &arena,
+    size_t state_segment_bytes)
     : task_proxy(task_proxy),
-      state_packer(task_properties::g_state_packers[task_proxy]),
+      state_packer(state_packing_type == StatePackingType::CO_CHANGE ?
+                   task_properties::g_co_change_state_packers[task_proxy] :
+                   task_properties::g_state_packers[task_proxy]),
       axiom_evaluator(g_axiom_evaluators[task_proxy]),
       num_variables(task_proxy.get_variables().size()),
-      state_data_pool(get_bins_per_state()),
+      state_id_set_type(state_id_set_type),
+      compress_states(
+          compress_states &&
+          delta_array_vector::DeltaArrayVector<PackedStateBin>::can_save_memory(
+              get_bins_per_state())),
+      arena(arena),
+      state_data_pool(
+          get_bins_per_state(),
+          memory_arena::ArenaAllocator<PackedStateBin>(arena),
+          state_segment_bytes),
       registered_states(
-          StateIDSemanticHash(state_data_pool, get_bins_per_state()),
-          StateIDSemanticEqual(state_data_pool, get_bins_per_state())),
+          StateIDSemanticHash(*this, get_bins_per_state()),
+          StateIDSemanticEqual(*this, get_bins_per_state())),
+      swiss_registered_states(
+          StateIDFastHash(*this, get_bins_per_state()),
+          StateIDSemanticEqual(*this, get_bins_per_state())),
       cached_initial_state(0) {
+    if (this->compress_states) {
+        compressed_state_pool = utils::make_unique_ptr<CompressedStatePool>(
+            get_bins_per_state(), MAX_DELTA_DEPTH,
+            memory_arena::ArenaAllocator<PackedStateBin>(arena),
+            state_segment_bytes);
+        decoded_state_ids.assign(DECODED_STATE_CACHE_SIZE, StateID::no_state);
+        decoded_states.assign(DECODED_STATE_CACHE_SIZE, nullptr);
+    } else if (compress_states) {
+        cout << "States with " << get_bins_per_state() << " bins are too small "
+             << "to be compressed, storing them uncompressed." << endl;
+    }
+    variable_layouts.reserve(num_variables);
+    for (int var = 0; var < num_variables; ++var)
+        variable_layouts.push_back(state_packer.get_variable_layout(var));
+    compile_packed_effects();
 }
 
 
 StateRegistry::~StateRegistry() {
     delete cached_initial_state;
+    release_decoded_states();
+}
+
+void StateRegistry::release_decoded_states() {
+    for (PackedStateBin *decoded_state : decoded_states) {
+        if (decoded_state)
+            DecodedStateBuffer::remove_reference(decoded_state);
+    }
+    decoded_states.clear();
+    decoded_state_ids.clear();
+}
+
+void StateRegistry::compile_packed_effects() {
+    OperatorsProxy operators = task_proxy.get_operators();
+    packed_effects_start.reserve(operators.size() + 1);
+    has_conditional_effects.reserve(operators.size());
+    for (OperatorProxy op : operators) {
+        packed_effects_start.push_back(packed_effects.size());
+        EffectsProxy effects = op.get_effects();
+        bool is_conditional = false;
+        for (EffectProxy effect : effects) {
+            if (!effect.get_conditions().empty()) {
+                is_conditional = true;
+                break;
+            }
+        }
+        has_conditional_effects.push_back(is_conditional);
+        if (is_conditional)
+            continue;
+
+        size_t op_start = packed_effects.size();
+        for (EffectProxy effect : effects) {
+            FactPair fact = effect.get_fact().get_pair();
+            int bin_index = state_packer.get_bin_index(fact.var);
+            PackedStateBin clear_mask = state_packer.get_clear_mask(fact.var);
+            PackedStateBin value_bits = state_packer.get_value_bits(fact.var, fact.value);
+            // Operators only touch a few bins, so a linear scan is enough.
+            size_t i = op_start;
+            while (i < packed_effects.size() && packed_effects[i].bin_index != bin_index)
+                ++i;
+            if (i == packed_effects.size()) {
+                packed_effects.push_back({bin_index, clear_mask, value_bits});
+            } else {
+                PackedEffect &packed_effect = packed_effects[i];
+                packed_effect.clear_mask &= clear_mask;
+                packed_effect.set_bits = (packed_effect.set_bits & clear_mask) | value_bits;
+            }
+        }
+    }
+    packed_effects_start.push_back(packed_effects.size());
+}
+
+uint64_t StateRegistry::compute_hash(const PackedStateBin *buffer) const {
+    if (state_id_set_type == StateIDSetType::SWISS_HASH_SET)
+        return StateIDFastHash(*this, get_bins_per_state()).hash_buffer(buffer);
+    return StateIDSemanticHash(*this, get_bins_per_state()).hash_buffer(buffer);
+}
+
+void StateRegistry::prefetch(uint64_t hash) const {
+    if (state_id_set_type == StateIDSetType::SWISS_HASH_SET)
+        swiss_registered_states.prefetch(hash);
+    else
+        registered_states.prefetch(static_cast<int_hash_set::HashType>(hash));
 }
 
 StateID StateRegistry::insert_id_or_pop_state() {
@@ -31,18 +144,94 @@ StateID StateRegistry::insert_id_or_pop_state() {
       is present), we have to remove the duplicate entry from the
       state data pool.
     */
-    StateID id(state_data_pool.size() - 1);
-    pair<int, bool> result = registered_states.insert(id.value);
+    return insert_id_or_pop_state(
+        compute_hash(state_data_pool[state_data_pool.size() - 1]));
+}
+
+StateID StateRegistry::insert_id_or_pop_state(uint64_t hash) {
+    StateID id(get_num_stored_states() - 1);
+    pair<int_hash_set::KeyType, bool> result =
+        (state_id_set_type == StateIDSetType::SWISS_HASH_SET) ?
+        swiss_registered_states.insert_with_hash(id.value, hash) :
+        registered_states.insert_with_hash(
+            id.value, static_cast<int_hash_set::HashType>(hash));
     bool is_new_entry = result.second;
     if (!is_new_entry) {
-        state_data_pool.pop_back();
+        if (compress_states)
+            compressed_state_pool->pop_back();
+        else
+            state_data_pool.pop_back();
     }
-    assert(registered_states.size() == static_cast<int>(state_data_pool.size()));
+    assert(size() == get_num_stored_states());
     return StateID(result.first);
 }
 
+StateID StateRegistry::register_state(
+    const PackedStateBin *buffer, uint64_t hash, const GlobalState *predecessor) {
+    if (!compress_states) {
+        state_data_pool.push_back(buffer);
+        return insert_id_or_pop_state(hash);
+    }
+    if (predecessor) {
+        compressed_state_pool->push_back(
+            buffer, predecessor->get_id().value, predecessor->get_packed_buffer());
+    } else {
+        compressed_state_pool->push_back(buffer);
+    }
+    StateID id = insert_id_or_pop_state(hash);
+    size_t num_states = size();
+    if (num_states >= MIN_STATES_FOR_COMPRESSION_CHECK &&
+        (num_states & (num_states - 1)) == 0)
+        check_compression();
+    return id;
+}
+
+void StateRegistry::check_compression() {
+    size_t num_states = size();
+    size_t num_bytes = compressed_state_pool->get_num_bytes();
+    if (num_bytes < num_states * get_state_size_in_bytes())
+        return;
+    cout << "Compressed states take "
+         << static_cast<double>(num_bytes) / num_states
+         << " bytes per state (uncompressed: " << get_state_size_in_bytes()
+         << "), storing them uncompressed." << endl;
+    vector<PackedStateBin> buffer(get_bins_per_state());
+    for (size_t id = 0; id < num_states; ++id) {
+        compressed_state_pool->decode(id, buffer.data());
+        state_data_pool.push_back(buffer.data());
+    }
+    compressed_state_pool = nullptr;
+    /*
+      GlobalStates that were looked up before keep their decoded buffers,
+      which are freed once the last of them is destroyed.
+    */
+    release_decoded_states();
+    compress_states = false;
+}
+
+size_t StateRegistry::get_num_stored_states() const {
+    if (compress_states)
+        return compressed_state_pool->size();
+    return state_data_pool.size();
+}
+
 GlobalState StateRegistry::lookup_state(StateID id) const {
-    return GlobalState(state_data_pool[id.value], *this, id);
+    if (!compress_states)
+        return GlobalState(state_data_pool[id.value], *this, id);
+
+    int slot = id.value % DECODED_STATE_CACHE_SIZE;
+    PackedStateBin *&decoded_state = decoded_states[slot];
+    if (decoded_state_ids[slot] != id) {
+        if (!decoded_state || DecodedStateBuffer::get_num_references(decoded_state) > 1) {
+            // The old buffer is still in use.
+            if (decoded_state)
+                DecodedStateBuffer::remove_reference(decoded_state);
+            decoded_state = DecodedStateBuffer::create(get_bins_per_state());
+        }
+        compressed_state_pool->decode(id.value, decoded_state);
+        decoded_state_ids[slot] = id;
+    }
+    return GlobalState(decoded_state, *this, id, true);
 }
 
 const GlobalState &StateRegistry::get_initial_state() {
@@ -55,10 +244,9 @@ const GlobalState &StateRegistry::get_initial_state() {
         for (size_t i = 0; i < initial_state.size(); ++i) {
             state_packer.set(buffer, i, initial_state[i].get_value());
         }
-        state_data_pool.push_back(buffer);
-        // buffer is copied by push_back
+        // buffer is copied by register_state
+        StateID id = register_state(buffer, compute_hash(buffer), nullptr);
         delete[] buffer;
-        StateID id = insert_id_or_pop_state();
         cached_initial_state = new GlobalState(lookup_state(id));
     }
     return *cached_initial_state;
@@ -67,21 +255,73 @@ const GlobalState &StateRegistry::get_initial_state() {
 //TODO it would be nice to move the actual state creation (and operator application)
 //     out of the StateRegistry. This could for example be done by global functions
 //     operating on state buffers (PackedStateBin *).
-GlobalState StateRegistry::get_successor_state(const GlobalState &predecessor, const OperatorProxy &op) {
+void StateRegistry::apply_effects(
+    const GlobalState &predecessor, const OperatorProxy &op, PackedStateBin *buffer) const {
     assert(!op.is_axiom());
-    state_data_pool.push_back(predecessor.get_packed_buffer());
-    PackedStateBin *buffer = state_data_pool[state_data_pool.size() - 1];
-    for (EffectProxy effect : op.get_effects()) {
-        if (does_fire(effect, predecessor)) {
-            FactPair effect_pair = effect.get_fact().get_pair();
-            state_packer.set(buffer, effect_pair.var, effect_pair.value);
+    int op_id = op.get_id();
+    if (has_conditional_effects[op_id]) {
+        for (EffectProxy effect : op.get_effects()) {
+            if (does_fire(effect, predecessor)) {
+                FactPair effect_pair = effect.get_fact().get_pair();
+                state_packer.set(buffer, effect_pair.var, effect_pair.value);
+            }
+        }
+    } else {
+        for (int i = packed_effects_start[op_id]; i < packed_effects_start[op_id + 1]; ++i) {
+            const PackedEffect &packed_effect = packed_effects[i];
+            PackedStateBin &bin = buffer[packed_effect.bin_index];
+            bin = (bin & packed_effect.clear_mask) | packed_effect.set_bits;
         }
     }
+}
+
+GlobalState StateRegistry::get_successor_state(const GlobalState &predecessor, const OperatorProxy &op) {
+    if (compress_states) {
+        int num_bins = get_bins_per_state();
+        const PackedStateBin *predecessor_buffer = predecessor.get_packed_buffer();
+        successor_buffers.assign(predecessor_buffer, predecessor_buffer + num_bins);
+        PackedStateBin *buffer = successor_buffers.data();
+        apply_effects(predecessor, op, buffer);
+        axiom_evaluator.evaluate(buffer, state_packer);
+        StateID id = register_state(buffer, compute_hash(buffer), &predecessor);
+        return lookup_state(id);
+    }
+    state_data_pool.push_back(predecessor.get_packed_buffer());
+    PackedStateBin *buffer = state_data_pool[state_data_pool.size() - 1];
+    apply_effects(predecessor, op, buffer);
     axiom_evaluator.evaluate(buffer, state_packer);
     StateID id = insert_id_or_pop_state();
     return lookup_state(id);
 }
 
+void StateRegistry::get_successor_states(
+    const GlobalState &predecessor, const vector<OperatorID> &op_ids,
+    vector<GlobalState> &successors) {
+    int num_bins = get_bins_per_state();
+    int num_successors = op_ids.size();
+    successor_buffers.resize(num_successors * num_bins);
+    successor_hashes.resize(num_successors);
+
+    // First pass: compute successors and hashes and prefetch their buckets.
+    const PackedStateBin *predecessor_buffer = predecessor.get_packed_buffer();
+    OperatorsProxy operators = task_proxy.get_operators();
+    for (int i = 0; i < num_successors; ++i) {
+        PackedStateBin *buffer = &successor_buffers[i * num_bins];
+        copy(predecessor_buffer, predecessor_buffer + num_bins, buffer);
+        apply_effects(predecessor, operators[op_ids[i]], buffer);
+        axiom_evaluator.evaluate(buffer, state_packer);
+        successor_hashes[i] = compute_hash(buffer);
+        prefetch(successor_hashes[i]);
+    }
+
+    // Second pass: register the successors.
+    for (int i = 0; i < num_successors; ++i) {
+        StateID id = register_state(
+            &successor_buffers[i * num_bins], successor_hashes[i], &predecessor);
+        successors.push_back(lookup_state(id));
+    }
+}
+
 int StateRegistry::get_bins_per_state() const {
     return state_packer.get_num_bins();
 }
@@ -92,5 +332,52 @@ int StateRegistry::get_state_size_in_bytes() const {
 
 void StateRegistry::print_statistics() const {
     cout << "Number of registered states: " << size() << endl;
-    registered_states.print_statistics();
+    if (compress_states) {
+        size_t num_bytes = compressed_state_pool->get_num_bytes();
+        cout << "Compressed state data: " << num_bytes << " bytes ("
+             << static_cast<double>(num_bytes) / max<size_t>(size(), 1)
+             << " bytes per state, uncompressed: "
+             << get_state_size_in_bytes() << ")" << endl;
+        cout << "States stored as differences: "
+             << compressed_state_pool->get_num_deltas() << endl;
+    }
+    if (arena)
+        arena->print_statistics();
+    if (state_id_set_type == StateIDSetType::SWISS_HASH_SET)
+        swiss_registered_states.print_statistics();
+    else
+        registered_states.print_statistics();
+}
+
+void StateRegistry::save(checkpoint::Writer &writer) const {
+    int num_bins = get_bins_per_state();
+    writer.write(num_bins);
+    writer.write(size());
+    vector<PackedStateBin> scratch;
+    for (size_t id = 0; id < size(); ++id) {
+        writer.write_array(get_state_data(id, scratch), num_bins);
+    }
+}
+
+void StateRegistry::load(checkpoint::Reader &reader) {
+    int num_bins = get_bins_per_state();
+    if (reader.read<int>() != num_bins)
+        reader.fail("the states are packed differently");
+    size_t num_states = reader.read<size_t>();
+    vector<PackedStateBin> buffer(num_bins);
+    for (size_t id = 0; id < num_states; ++id) {
+        reader.read_array(buffer.data(), num_bins);
+        StateID state_id = StateID::no_state;
+        if (compress_states && id > 0) {
+            // Consecutive states are often siblings, so they share most bins.
+            GlobalState predecessor = lookup_state(StateID(id - 1));
+            state_id = register_state(
+                buffer.data(), compute_hash(buffer.data()), &predecessor);
+        } else {
+            state_id = register_state(
+                buffer.data(), compute_hash(buffer.data()), nullptr);
+        }
+        if (state_id.value != static_cast<StateIDValue>(id))
+            reader.fail("the state registry is not empty");
+    }
 }
@@ -4,15 +4,26 @@
 #include "abstract_task.h"
 #include "axioms.h"
 #include "global_state.h"
+#include "operator_id.h"
 #include "state_id.h"
 
+#include "algorithms/delta_array_vector.h"
 #include "algorithms/int_hash_set.h"
 #include "algorithms/int_packer.h"
+#include "algorithms/memory_arena.h"
 #include "algorithms/segmented_vector.h"
 #include "algorithms/subscriber.h"
+#include "algorithms/swiss_hash_set.h"
 #include "utils/hash.h"
 
+#include <memory>
 #include <set>
+#include <type_traits>
+
+namespace checkpoint {
+class Reader;
+class Writer;
+}
 
 /*
   Overview of classes relevant to storing and working with registered states.
@@ -24,8 +35,10 @@
     State first.
     A GlobalState is always registered in a StateRegistry and has a valid ID.
     It can (only) be constructed from a StateRegistry by factory methods for
-    the initial state and successor states. It never owns the actual state data
-    which is borrowed from the StateRegistry that created it.
+    the initial state and successor states. Usually, it does not own the actual
+    state data which is borrowed from the StateRegistry that created it. Only
+    if the registry compresses states, the GlobalState holds a reference to a
+    decoded copy of the state data (see DecodedStateBuffer).
 
   State
     This class is used for fast access to state data. It contains and owns all
@@ -60,6 +73,9 @@
     This class is used to store the actual (packed) state data for all states
     while avoiding dynamically allocating each state individually.
     The index within this vector corresponds to the ID of the state.
+    If states are compressed, a DeltaArrayVector<PackedStateBin> is used
+    instead, which stores states as differences to their predecessor if the
+    difference is smaller than the state.
 
   PerStateInformation<T>
     Associates a value of type T with every state in a given StateRegistry.
@@ -83,6 +99,8 @@
 
     SearchNodeInfo
       Remaining part of a search node besides the state that needs to be stored.
+      SlimSearchNodeInfo and CompactSearchNodeInfo are smaller layouts for
+      searches that do not need all fields (see search_node_info.h).
 
     SearchNode
       A SearchNode combines a StateID, a reference to a SearchNodeInfo and
@@ -108,40 +126,109 @@
     state and each landmark whether it was reached in this state.
 */
 
+// Hash set implementation used for duplicate detection in a StateRegistry.
+enum class StateIDSetType {
+    INT_HASH_SET,
+    SWISS_HASH_SET
+};
+
+// Strategy for packing the state variables into bins.
+enum class StatePackingType {
+    // Greedy packing by bit width (task_properties::g_state_packers).
+    BIT_WIDTH,
+    // Co-locate variables changed by the same operators
+    // (task_properties::g_co_change_state_packers).
+    CO_CHANGE
+};
+
+// Memory used for the state data and per-state information.
+enum class StatePoolType {
+    MEMORY,
+    // Memory-mapped temporary file (see memory_arena::MappedFileArena).
+    MAPPED_FILE,
+    // Transparent huge pages (see memory_arena::HugePageArena).
+    HUGE_PAGES
+};
+
 class StateRegistry : public subscriber::SubscriberService<StateRegistry> {
     struct StateIDSemanticHash {
-        const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool;
+        const StateRegistry &registry;
         int state_size;
-        StateIDSemanticHash(
-            const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool,
-            int state_size)
-            : state_data_pool(state_data_pool),
+        // Scratch space for decoding compressed states.
+        mutable std::vector<PackedStateBin> scratch;
+        StateIDSemanticHash(const StateRegistry &registry, int state_size)
+            : registry(registry),
               state_size(state_size) {
         }
 
-        int_hash_set::HashType operator()(int id) const {
-            const PackedStateBin *data = state_data_pool[id];
+        int_hash_set::HashType operator()(int_hash_set::KeyType id) const {
+            return hash_buffer(registry.get_state_data(id, scratch));
+        }
+
+        int_hash_set::HashType hash_buffer(const PackedStateBin *data) const {
             utils::HashState hash_state;
             for (int i = 0; i < state_size; ++i) {
                 hash_state.feed(data[i]);
             }
+#ifdef USE_64_BIT_STATE_IDS
+            return hash_state.get_hash64();
+#else
             return hash_state.get_hash32();
+#endif
+        }
+    };
+
+    /*
+      64-bit hash for SwissHashSet. It mixes two bins at a time with a
+      multiplication instead of feeding each bin through HashState.
+    */
+    struct StateIDFastHash {
+        const StateRegistry &registry;
+        int state_size;
+        mutable std::vector<PackedStateBin> scratch;
+        StateIDFastHash(const StateRegistry &registry, int state_size)
+            : registry(registry),
+              state_size(state_size) {
+        }
+
+        swiss_hash_set::HashType operator()(swiss_hash_set::KeyType id) const {
+            return hash_buffer(registry.get_state_data(id, scratch));
+        }
+
+        swiss_hash_set::HashType hash_buffer(const PackedStateBin *data) const {
+            std::uint64_t hash = state_size;
+            int i = 0;
+            for (; i + 1 < state_size; i += 2) {
+                std::uint64_t word = (std::uint64_t(data[i + 1]) << 32) | data[i];
+                hash = (hash ^ word) * 0x9e3779b97f4a7c15ULL;
+                hash ^= hash >> 29;
+            }
+            if (i < state_size) {
+                hash = (hash ^ data[i]) * 0x9e3779b97f4a7c15ULL;
+            }
+            // Final avalanche step of MurmurHash3.
+            hash ^= hash >> 33;
+            hash *= 0xff51afd7ed558ccdULL;
+            hash ^= hash >> 33;
+            hash *= 0xc4ceb9fe1a85ec53ULL;
+            hash ^= hash >> 33;
+            return hash;
         }
     };
 
     struct StateIDSemanticEqual {
-        const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool;
+        const StateRegistry &registry;
         int state_size;
-        StateIDSemanticEqual(
-            const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool,
-            int state_size)
-            : state_data_pool(state_data_pool),
+        mutable std::vector<PackedStateBin> lhs_scratch;
+        mutable std::vector<PackedStateBin> rhs_scratch;
+        StateIDSemanticEqual(const StateRegistry &registry, int state_size)
+            : registry(registry),
               state_size(state_size) {
         }
 
-        bool operator()(int lhs, int rhs) const {
-            const PackedStateBin *lhs_data = state_data_pool[lhs];
-            const PackedStateBin *rhs_data = state_data_pool[rhs];
+        bool operator()(int_hash_set::KeyType lhs, int_hash_set::KeyType rhs) const {
+            const PackedStateBin *lhs_data = registry.get_state_data(lhs, lhs_scratch);
+            const PackedStateBin *rhs_data = registry.get_state_data(rhs, rhs_scratch);
             return std::equal(lhs_data, lhs_data + state_size, rhs_data);
         }
     };
@@ -152,33 +239,144 @@ class StateRegistry : public subscriber::SubscriberService<StateRegistry> {
       i.e. the actual state data is compared, not the memory location.
     */
     using StateIDSet = int_hash_set::IntHashSet<StateIDSemanticHash, StateIDSemanticEqual>;
+    using SwissStateIDSet = swiss_hash_set::SwissHashSet<StateIDFastHash, StateIDSemanticEqual>;
 
     TaskProxy task_proxy;
     const int_packer::IntPacker &state_packer;
+    // Layouts of all variables in state_packer, for inlined value access.
+    std::vector<int_packer::IntPacker::VariableLayout> variable_layouts;
     AxiomEvaluator &axiom_evaluator;
     const int num_variables;
+    const StateIDSetType state_id_set_type;
+    /*
+      Cleared (and the states moved to state_data_pool) if the
+      compressed states turn out to take more memory than uncompressed
+      ones (see check_compression).
+    */
+    bool compress_states;
+    /*
+      Arena for the state data and for the per-state information of
+      this registry. If it is null, memory is allocated with new.
+    */
+    const std::shared_ptr<memory_arena::MemoryArena> arena;
 
-    segmented_vector::SegmentedArrayVector<PackedStateBin> state_data_pool;
+    typedef delta_array_vector::DeltaArrayVector<
+            PackedStateBin, memory_arena::ArenaAllocator<PackedStateBin>,
+            std::make_unsigned<StateIDValue>::type> CompressedStatePool;
+
+    // Only one of the two pools is used, depending on compress_states.
+    segmented_vector::SegmentedArrayVector<
+        PackedStateBin, memory_arena::ArenaAllocator<PackedStateBin>> state_data_pool;
+    std::unique_ptr<CompressedStatePool> compressed_state_pool;
+    // Only the set selected by state_id_set_type is used.
     StateIDSet registered_states;
+    SwissStateIDSet swiss_registered_states;
 
     GlobalState *cached_initial_state;
 
+    /*
+      With compress_states, lookup_state decodes states into
+      DecodedStateBuffers referenced by the returned GlobalStates. The
+      buffers of recently looked up states are kept in a small
+      direct-mapped cache (indexed by the state ID modulo its size),
+      which holds one reference to each. A cached buffer is reused for
+      another state once no GlobalState refers to it anymore.
+    */
+    mutable std::vector<StateID> decoded_state_ids;
+    mutable std::vector<PackedStateBin *> decoded_states;
+
+    /*
+      Effect of an operator on one bin of a packed state:
+      bin = (bin & clear_mask) | set_bits.
+    */
+    struct PackedEffect {
+        int bin_index;
+        PackedStateBin clear_mask;
+        PackedStateBin set_bits;
+    };
+
+    /*
+      The effects of all operators without conditional effects are
+      compiled to PackedEffects (at most one per bin) once, when the
+      registry is created. The effects of operator i are stored in
+      packed_effects[packed_effects_start[i]] up to (excluding)
+      packed_effects[packed_effects_start[i + 1]]. Operators with
+      conditional effects are applied through the task interface.
+    */
+    std::vector<PackedEffect> packed_effects;
+    std::vector<int> packed_effects_start;
+    std::vector<bool> has_conditional_effects;
+
+    // Scratch space for get_successor_states.
+    std::vector<PackedStateBin> successor_buffers;
+    std::vector<std::uint64_t> successor_hashes;
+
+    void compile_packed_effects();
+    void apply_effects(const GlobalState &predecessor, const OperatorProxy &op,
+                       PackedStateBin *buffer) const;
+    std::uint64_t compute_hash(const PackedStateBin *buffer) const;
+    void prefetch(std::uint64_t hash) const;
     StateID insert_id_or_pop_state();
+    StateID insert_id_or_pop_state(std::uint64_t hash);
+    StateID register_state(const PackedStateBin *buffer, std::uint64_t hash,
+                           const GlobalState *predecessor);
+    size_t get_num_stored_states() const;
     int get_bins_per_state() const;
+    void check_compression();
+    void release_decoded_states();
+
+    /*
+      Return the data of the stored state with the given ID. For
+      compressed states, the data is decoded into scratch.
+    */
+    const PackedStateBin *get_state_data(
+        int_hash_set::KeyType id, std::vector<PackedStateBin> &scratch) const {
+        if (!compress_states)
+            return state_data_pool[id];
+        scratch.resize(state_packer.get_num_bins());
+        compressed_state_pool->decode(id, scratch.data());
+        return scratch.data();
+    }
 public:
-    explicit StateRegistry(const TaskProxy &task_proxy);
+    /*
+      If compress_states is true, states are stored as differences to
+      their predecessor state where this is smaller (see
+      DeltaArrayVector), which saves memory at the cost of decoding
+      states on every lookup. It is ignored for states of at most three
+      bins, for which no difference is smaller than the state, and
+      dropped during the search if it does not save memory.
+      If arena is given, the state data and all per-state information
+      for this registry are allocated from it. state_segment_bytes is
+      the segment size of the (uncompressed) state data pool.
+    */
+    explicit StateRegistry(
+        const TaskProxy &task_proxy,
+        StateIDSetType state_id_set_type = StateIDSetType::INT_HASH_SET,
+        bool compress_states = false,
+        StatePackingType state_packing_type = StatePackingType::BIT_WIDTH,
+        const std::shared_ptr<memory_arena::MemoryArena> &arena = nullptr,
+        size_t state_segment_bytes = 8192);
     ~StateRegistry();
 
     const TaskProxy &get_task_proxy() const {
         return task_proxy;
     }
 
+    const std::shared_ptr<memory_arena::MemoryArena> &get_memory_arena() const {
+        return arena;
+    }
+
     int get_num_variables() const {
         return num_variables;
     }
 
     int get_state_value(const PackedStateBin *buffer, int var) const {
-        return state_packer.get(buffer, var);
+        return variable_layouts[var].get(buffer);
+    }
+
+    const std::vector<int_packer::IntPacker::VariableLayout> &
+    get_variable_layouts() const {
+        return variable_layouts;
     }
 
     /*
@@ -200,10 +398,25 @@ public:
     */
     GlobalState get_successor_state(const GlobalState &predecessor, const OperatorProxy &op);
 
+    /*
+      Registers the states that result from applying each of the given
+      operators to predecessor and appends them to successors (in the
+      order of op_ids). The result is the same as calling
+      get_successor_state for each operator, but all successors and
+      their hashes are computed first and the hash set buckets are
+      prefetched before the insertions are resolved, so the cache
+      misses of the lookups overlap.
+    */
+    void get_successor_states(const GlobalState &predecessor,
+                              const std::vector<OperatorID> &op_ids,
+                              std::vector<GlobalState> &successors);
+
     /*
       Returns the number of states registered so far.
     */
     size_t size() const {
+        if (state_id_set_type == StateIDSetType::SWISS_HASH_SET)
+            return swiss_registered_states.size();
         return registered_states.size();
     }
 
@@ -211,6 +424,16 @@ public:
 
     void print_statistics() const;
 
+    /*
+      Write the data of all registered states to a checkpoint, and
+      register the states of a checkpoint in the same order. The registry
+      must not contain other states than the initial state when loading,
+      so that all states get the IDs they had when the checkpoint was
+      written.
+    */
+    void save(checkpoint::Writer &writer) const;
+    void load(checkpoint::Reader &reader);
+
     class const_iterator : public std::iterator<
                                std::forward_iterator_tag, StateID> {
         /*
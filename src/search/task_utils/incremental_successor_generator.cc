@@ -0,0 +1,147 @@
+#include "incremental_successor_generator.h"
+
+#include "successor_generator.h"
+
+#include "../global_state.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+using namespace std;
+
+namespace successor_generator {
+IncrementalSuccessorGenerator::IncrementalSuccessorGenerator(
+    const TaskProxy &task_proxy,
+    const SuccessorGenerator &successor_generator)
+    : current_mark(0) {
+    VariablesProxy variables = task_proxy.get_variables();
+    num_variables = variables.size();
+    int num_facts = 0;
+    fact_offsets.reserve(num_variables);
+    for (VariableProxy var : variables) {
+        fact_offsets.push_back(num_facts);
+        num_facts += var.get_domain_size();
+    }
+
+    OperatorsProxy operators = task_proxy.get_operators();
+    int num_operators = operators.size();
+    vector<int> num_operators_by_fact(num_facts, 0);
+    precondition_start.reserve(num_operators + 1);
+    for (OperatorProxy op : operators) {
+        precondition_start.push_back(preconditions.size());
+        for (FactProxy pre : op.get_preconditions()) {
+            FactPair fact = pre.get_pair();
+            preconditions.push_back(fact);
+            ++num_operators_by_fact[get_fact_id(fact.var, fact.value)];
+        }
+    }
+    precondition_start.push_back(preconditions.size());
+
+    // Fill operators_by_fact with a counting sort by fact.
+    operators_by_fact_start.resize(num_facts + 1);
+    operators_by_fact_start[0] = 0;
+    for (int fact_id = 0; fact_id < num_facts; ++fact_id) {
+        operators_by_fact_start[fact_id + 1] =
+            operators_by_fact_start[fact_id] + num_operators_by_fact[fact_id];
+    }
+    operators_by_fact.resize(preconditions.size());
+    vector<int> next_position(operators_by_fact_start.begin(),
+                              operators_by_fact_start.end() - 1);
+    for (int op_id = 0; op_id < num_operators; ++op_id) {
+        for (int i = precondition_start[op_id]; i < precondition_start[op_id + 1]; ++i) {
+            const FactPair &fact = preconditions[i];
+            operators_by_fact[next_position[get_fact_id(fact.var, fact.value)]++] = op_id;
+        }
+    }
+
+    vector<OperatorID> ordered_operators;
+    successor_generator.get_operators_in_generation_order(ordered_operators);
+    assert(static_cast<int>(ordered_operators.size()) == num_operators);
+    operator_ranks.resize(num_operators);
+    for (int rank = 0; rank < num_operators; ++rank)
+        operator_ranks[ordered_operators[rank].get_index()] = rank;
+
+    marks.resize(num_operators, 0);
+}
+
+bool IncrementalSuccessorGenerator::is_applicable(
+    int op_id, const GlobalState &state) const {
+    for (int i = precondition_start[op_id]; i < precondition_start[op_id + 1]; ++i) {
+        const FactPair &fact = preconditions[i];
+        if (state[fact.var] != fact.value)
+            return false;
+    }
+    return true;
+}
+
+void IncrementalSuccessorGenerator::start_marking() {
+    if (current_mark == numeric_limits<int>::max()) {
+        fill(marks.begin(), marks.end(), 0);
+        current_mark = 0;
+    }
+    ++current_mark;
+}
+
+void IncrementalSuccessorGenerator::generate_applicable_ops(
+    const GlobalState &other_state, const vector<OperatorID> &other_ops,
+    const GlobalState &state, vector<OperatorID> &applicable_ops) {
+    assert(applicable_ops.empty());
+    changed_variables.clear();
+    for (int var = 0; var < num_variables; ++var) {
+        if (other_state[var] != state[var])
+            changed_variables.push_back(var);
+    }
+
+    /*
+      Mark the operators that depend on the old value of a changed
+      variable. An operator of other_ops with a precondition on a changed
+      variable must have such a precondition, so these are exactly the
+      operators that are no longer applicable. Since the operators
+      depending on the new values do not hold in other_state, they are
+      not in other_ops and can be checked and marked in the same pass.
+    */
+    start_marking();
+    for (int var : changed_variables) {
+        int fact_id = get_fact_id(var, other_state[var]);
+        for (int i = operators_by_fact_start[fact_id];
+             i < operators_by_fact_start[fact_id + 1]; ++i) {
+            marks[operators_by_fact[i]] = current_mark;
+        }
+    }
+    new_operators.clear();
+    for (int var : changed_variables) {
+        int fact_id = get_fact_id(var, state[var]);
+        for (int i = operators_by_fact_start[fact_id];
+             i < operators_by_fact_start[fact_id + 1]; ++i) {
+            int op_id = operators_by_fact[i];
+            if (marks[op_id] != current_mark) {
+                marks[op_id] = current_mark;
+                if (is_applicable(op_id, state))
+                    new_operators.push_back(op_id);
+            }
+        }
+    }
+    sort(new_operators.begin(), new_operators.end(),
+         [this](int op1, int op2) {
+             return operator_ranks[op1] < operator_ranks[op2];
+         });
+
+    // Merge the remaining and new operators, both sorted by rank.
+    applicable_ops.reserve(other_ops.size() + new_operators.size());
+    auto new_op_it = new_operators.begin();
+    for (OperatorID op : other_ops) {
+        int op_id = op.get_index();
+        if (marks[op_id] == current_mark)
+            continue;
+        while (new_op_it != new_operators.end() &&
+               operator_ranks[*new_op_it] < operator_ranks[op_id]) {
+            applicable_ops.emplace_back(*new_op_it);
+            ++new_op_it;
+        }
+        applicable_ops.push_back(op);
+    }
+    for (; new_op_it != new_operators.end(); ++new_op_it)
+        applicable_ops.emplace_back(*new_op_it);
+}
+}
@@ -0,0 +1,71 @@
+#ifndef TASK_UTILS_INCREMENTAL_SUCCESSOR_GENERATOR_H
+#define TASK_UTILS_INCREMENTAL_SUCCESSOR_GENERATOR_H
+
+#include "../task_proxy.h"
+
+#include <vector>
+
+class GlobalState;
+class OperatorID;
+
+namespace successor_generator {
+class SuccessorGenerator;
+
+/*
+  Derives the applicable operators of a state from the applicable
+  operators of another state (usually its parent) instead of traversing
+  the successor generator. Only operators with a precondition on a
+  variable whose value differs between the two states are considered:
+  operators with a precondition on the old value of such a variable are
+  removed, and operators with a precondition on the new value are added
+  if all of their preconditions hold.
+
+  This pays off if states have many applicable operators and successors
+  differ from their parent in few variables. The result is the same (and
+  in the same order) as for SuccessorGenerator::generate_applicable_ops.
+*/
+class IncrementalSuccessorGenerator {
+    int num_variables;
+    // Preconditions of operator i are in range [precondition_start[i], precondition_start[i + 1]).
+    std::vector<FactPair> preconditions;
+    std::vector<int> precondition_start;
+    /*
+      Operators with a precondition on fact (var, value) are in range
+      [operators_by_fact_start[id], operators_by_fact_start[id + 1]) of
+      operators_by_fact, where id = fact_offsets[var] + value.
+    */
+    std::vector<int> fact_offsets;
+    std::vector<int> operators_by_fact;
+    std::vector<int> operators_by_fact_start;
+    // Position of each operator in the order of the successor generator.
+    std::vector<int> operator_ranks;
+
+    // Scratch space. An operator is marked if marks[op] == current_mark.
+    std::vector<int> changed_variables;
+    std::vector<int> new_operators;
+    std::vector<int> marks;
+    int current_mark;
+
+    int get_fact_id(int var, int value) const {
+        return fact_offsets[var] + value;
+    }
+    bool is_applicable(int op_id, const GlobalState &state) const;
+    void start_marking();
+public:
+    IncrementalSuccessorGenerator(
+        const TaskProxy &task_proxy,
+        const SuccessorGenerator &successor_generator);
+
+    /*
+      Set applicable_ops (which must be empty) to the applicable
+      operators of state, given the applicable operators other_ops of
+      other_state as generated by the successor generator or by this
+      class. Both states must belong to the same registry.
+    */
+    void generate_applicable_ops(
+        const GlobalState &other_state, const std::vector<OperatorID> &other_ops,
+        const GlobalState &state, std::vector<OperatorID> &applicable_ops);
+};
+}
+
+#endif
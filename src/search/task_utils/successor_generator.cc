@@ -5,24 +5,51 @@
 
 #include "../abstract_task.h"
 #include "../global_state.h"
+#include "../state_registry.h"
+
+#include <cassert>
 
 using namespace std;
 
 namespace successor_generator {
-SuccessorGenerator::SuccessorGenerator(const TaskProxy &task_proxy)
-    : root(SuccessorGeneratorFactory(task_proxy).create()) {
+SuccessorGenerator::SuccessorGenerator(const TaskProxy &task_proxy) {
+    SuccessorGeneratorFactory(task_proxy).create()->compile(program);
+    program.shrink_to_fit();
 }
 
-SuccessorGenerator::~SuccessorGenerator() = default;
-
 void SuccessorGenerator::generate_applicable_ops(
     const State &state, vector<OperatorID> &applicable_ops) const {
-    root->generate_applicable_ops(state, applicable_ops);
+    program.generate_applicable_ops(state, applicable_ops);
 }
 
 void SuccessorGenerator::generate_applicable_ops(
     const GlobalState &state, vector<OperatorID> &applicable_ops) const {
-    root->generate_applicable_ops(state, applicable_ops);
+    program.generate_applicable_ops(
+        state.get_packed_buffer(),
+        state.get_registry().get_variable_layouts(),
+        applicable_ops);
+}
+
+void SuccessorGenerator::generate_applicable_ops(
+    const vector<GlobalState> &states,
+    vector<vector<OperatorID>> &applicable_ops) const {
+    applicable_ops.resize(states.size());
+    if (states.empty())
+        return;
+    const StateRegistry &registry = states[0].get_registry();
+    vector<const int_packer::IntPacker::Bin *> buffers;
+    buffers.reserve(states.size());
+    for (const GlobalState &state : states) {
+        assert(&state.get_registry() == &registry);
+        buffers.push_back(state.get_packed_buffer());
+    }
+    program.generate_applicable_ops(
+        buffers, registry.get_variable_layouts(), applicable_ops);
+}
+
+void SuccessorGenerator::get_operators_in_generation_order(
+    vector<OperatorID> &operators) const {
+    program.get_operators(operators);
 }
 
 PerTaskInformation<SuccessorGenerator> g_successor_generators;
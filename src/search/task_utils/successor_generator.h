@@ -1,9 +1,10 @@
 #ifndef TASK_UTILS_SUCCESSOR_GENERATOR_H
 #define TASK_UTILS_SUCCESSOR_GENERATOR_H
 
+#include "successor_generator_program.h"
+
 #include "../per_task_information.h"
 
-#include <memory>
 #include <vector>
 
 class GlobalState;
@@ -12,25 +13,38 @@ class State;
 class TaskProxy;
 
 namespace successor_generator {
-class GeneratorBase;
-
+/*
+  The tree built by SuccessorGeneratorFactory is compiled into a
+  GeneratorProgram and discarded afterwards.
+*/
 class SuccessorGenerator {
-    std::unique_ptr<GeneratorBase> root;
+    GeneratorProgram program;
 
 public:
     explicit SuccessorGenerator(const TaskProxy &task_proxy);
-    /*
-      We cannot use the default destructor (implicitly or explicitly)
-      here because GeneratorBase is a forward declaration and the
-      incomplete type cannot be destroyed.
-    */
-    ~SuccessorGenerator();
 
     void generate_applicable_ops(
         const State &state, std::vector<OperatorID> &applicable_ops) const;
     // Transitional method, used until the search is switched to the new task interface.
     void generate_applicable_ops(
         const GlobalState &state, std::vector<OperatorID> &applicable_ops) const;
+    /*
+      Generate the applicable operators of several states in a single
+      traversal of the program. applicable_ops is resized to the number
+      of states and the applicable operators of states[i] are appended to
+      applicable_ops[i], in the same order as for a single state. All
+      states must belong to the same registry.
+    */
+    void generate_applicable_ops(
+        const std::vector<GlobalState> &states,
+        std::vector<std::vector<OperatorID>> &applicable_ops) const;
+
+    /*
+      Append all operators in the order in which generate_applicable_ops
+      generates applicable operators.
+    */
+    void get_operators_in_generation_order(
+        std::vector<OperatorID> &operators) const;
 };
 
 extern PerTaskInformation<SuccessorGenerator> g_successor_generators;
@@ -1,8 +1,11 @@
 #include "successor_generator_internals.h"
 
+#include "successor_generator_program.h"
+
 #include "../global_state.h"
 #include "../task_proxy.h"
 
+#include <algorithm>
 #include <cassert>
 
 using namespace std;
@@ -22,7 +25,10 @@ using namespace std;
   - Going further down this route, on the more extreme end of the
     spectrum, we could use a "byte-code" style representation, where
     the successor generator is just a long vector of ints combining
-    information about node type with node payload.
+    information about node type with node payload. (The successor
+    generator now compiles the tree into such a representation, see
+    successor_generator_program.h. The ideas below for compacting it
+    further are not implemented.)
 
     For example, we could represent different node types as follows,
     where BINARY_FORK etc. are symbolic constants for tagging node
@@ -93,6 +99,17 @@ void GeneratorForkBinary::generate_applicable_ops(
     generator2->generate_applicable_ops(state, applicable_ops);
 }
 
+void GeneratorForkBinary::compile(GeneratorProgram &program) const {
+    int node_pos = program.append(GeneratorProgram::FORK);
+    program.append(2);
+    int offset1_pos = program.append(0);
+    int offset2_pos = program.append(0);
+    program.set_offset_to_end(offset1_pos, node_pos);
+    generator1->compile(program);
+    program.set_offset_to_end(offset2_pos, node_pos);
+    generator2->compile(program);
+}
+
 GeneratorForkMulti::GeneratorForkMulti(vector<unique_ptr<GeneratorBase>> children)
     : children(move(children)) {
     /* Note that we permit 0-ary forks as a way to define empty
@@ -114,6 +131,18 @@ void GeneratorForkMulti::generate_applicable_ops(
         generator->generate_applicable_ops(state, applicable_ops);
 }
 
+void GeneratorForkMulti::compile(GeneratorProgram &program) const {
+    int node_pos = program.append(GeneratorProgram::FORK);
+    program.append(children.size());
+    int first_offset_pos = program.get_size();
+    for (size_t i = 0; i < children.size(); ++i)
+        program.append(0);
+    for (size_t i = 0; i < children.size(); ++i) {
+        program.set_offset_to_end(first_offset_pos + i, node_pos);
+        children[i]->compile(program);
+    }
+}
+
 GeneratorSwitchVector::GeneratorSwitchVector(
     int switch_var_id, vector<unique_ptr<GeneratorBase>> &&generator_for_value)
     : switch_var_id(switch_var_id),
@@ -138,6 +167,21 @@ void GeneratorSwitchVector::generate_applicable_ops(
     }
 }
 
+void GeneratorSwitchVector::compile(GeneratorProgram &program) const {
+    int node_pos = program.append(GeneratorProgram::SWITCH_VECTOR);
+    program.append(switch_var_id);
+    program.append(generator_for_value.size());
+    int first_offset_pos = program.get_size();
+    for (size_t value = 0; value < generator_for_value.size(); ++value)
+        program.append(0);
+    for (size_t value = 0; value < generator_for_value.size(); ++value) {
+        if (generator_for_value[value]) {
+            program.set_offset_to_end(first_offset_pos + value, node_pos);
+            generator_for_value[value]->compile(program);
+        }
+    }
+}
+
 GeneratorSwitchHash::GeneratorSwitchHash(
     int switch_var_id,
     unordered_map<int, unique_ptr<GeneratorBase>> &&generator_for_value)
@@ -165,6 +209,28 @@ void GeneratorSwitchHash::generate_applicable_ops(
     }
 }
 
+void GeneratorSwitchHash::compile(GeneratorProgram &program) const {
+    // Sorted switches replace the hash lookup by a binary search.
+    vector<int> values;
+    values.reserve(generator_for_value.size());
+    for (const auto &item : generator_for_value)
+        values.push_back(item.first);
+    sort(values.begin(), values.end());
+
+    int node_pos = program.append(GeneratorProgram::SWITCH_SORTED);
+    program.append(switch_var_id);
+    program.append(values.size());
+    for (int value : values)
+        program.append(value);
+    int first_offset_pos = program.get_size();
+    for (size_t i = 0; i < values.size(); ++i)
+        program.append(0);
+    for (size_t i = 0; i < values.size(); ++i) {
+        program.set_offset_to_end(first_offset_pos + i, node_pos);
+        generator_for_value.at(values[i])->compile(program);
+    }
+}
+
 GeneratorSwitchSingle::GeneratorSwitchSingle(
     int switch_var_id, int value, unique_ptr<GeneratorBase> generator_for_value)
     : switch_var_id(switch_var_id),
@@ -186,6 +252,13 @@ void GeneratorSwitchSingle::generate_applicable_ops(
     }
 }
 
+void GeneratorSwitchSingle::compile(GeneratorProgram &program) const {
+    program.append(GeneratorProgram::SWITCH_SINGLE);
+    program.append(switch_var_id);
+    program.append(value);
+    generator_for_value->compile(program);
+}
+
 GeneratorLeafVector::GeneratorLeafVector(vector<OperatorID> &&applicable_operators)
     : applicable_operators(move(applicable_operators)) {
 }
@@ -212,6 +285,13 @@ void GeneratorLeafVector::generate_applicable_ops(
     }
 }
 
+void GeneratorLeafVector::compile(GeneratorProgram &program) const {
+    program.append(GeneratorProgram::LEAF);
+    program.append(applicable_operators.size());
+    for (OperatorID id : applicable_operators)
+        program.append(id.get_index());
+}
+
 GeneratorLeafSingle::GeneratorLeafSingle(OperatorID applicable_operator)
     : applicable_operator(applicable_operator) {
 }
@@ -225,4 +305,10 @@ void GeneratorLeafSingle::generate_applicable_ops(
     const GlobalState &, vector<OperatorID> &applicable_ops) const {
     applicable_ops.push_back(applicable_operator);
 }
+
+void GeneratorLeafSingle::compile(GeneratorProgram &program) const {
+    program.append(GeneratorProgram::LEAF);
+    program.append(1);
+    program.append(applicable_operator.get_index());
+}
 }
@@ -11,6 +11,8 @@ class GlobalState;
 class State;
 
 namespace successor_generator {
+class GeneratorProgram;
+
 class GeneratorBase {
 public:
     virtual ~GeneratorBase() {}
@@ -20,6 +22,9 @@ public:
     // Transitional method, used until the search is switched to the new task interface.
     virtual void generate_applicable_ops(
         const GlobalState &state, std::vector<OperatorID> &applicable_ops) const = 0;
+
+    // Append this node and its descendants to the program.
+    virtual void compile(GeneratorProgram &program) const = 0;
 };
 
 class GeneratorForkBinary : public GeneratorBase {
@@ -34,6 +39,7 @@ public:
     // Transitional method, used until the search is switched to the new task interface.
     virtual void generate_applicable_ops(
         const GlobalState &state, std::vector<OperatorID> &applicable_ops) const override;
+    virtual void compile(GeneratorProgram &program) const override;
 };
 
 class GeneratorForkMulti : public GeneratorBase {
@@ -45,6 +51,7 @@ public:
     // Transitional method, used until the search is switched to the new task interface.
     virtual void generate_applicable_ops(
         const GlobalState &state, std::vector<OperatorID> &applicable_ops) const override;
+    virtual void compile(GeneratorProgram &program) const override;
 };
 
 class GeneratorSwitchVector : public GeneratorBase {
@@ -59,6 +66,7 @@ public:
     // Transitional method, used until the search is switched to the new task interface.
     virtual void generate_applicable_ops(
         const GlobalState &state, std::vector<OperatorID> &applicable_ops) const override;
+    virtual void compile(GeneratorProgram &program) const override;
 };
 
 class GeneratorSwitchHash : public GeneratorBase {
@@ -73,6 +81,7 @@ public:
     // Transitional method, used until the search is switched to the new task interface.
     virtual void generate_applicable_ops(
         const GlobalState &state, std::vector<OperatorID> &applicable_ops) const override;
+    virtual void compile(GeneratorProgram &program) const override;
 };
 
 class GeneratorSwitchSingle : public GeneratorBase {
@@ -88,6 +97,7 @@ public:
     // Transitional method, used until the search is switched to the new task interface.
     virtual void generate_applicable_ops(
         const GlobalState &state, std::vector<OperatorID> &applicable_ops) const override;
+    virtual void compile(GeneratorProgram &program) const override;
 };
 
 class GeneratorLeafVector : public GeneratorBase {
@@ -99,6 +109,7 @@ public:
     // Transitional method, used until the search is switched to the new task interface.
     virtual void generate_applicable_ops(
         const GlobalState &state, std::vector<OperatorID> &applicable_ops) const override;
+    virtual void compile(GeneratorProgram &program) const override;
 };
 
 class GeneratorLeafSingle : public GeneratorBase {
@@ -110,6 +121,7 @@ public:
     // Transitional method, used until the search is switched to the new task interface.
     virtual void generate_applicable_ops(
         const GlobalState &state, std::vector<OperatorID> &applicable_ops) const override;
+    virtual void compile(GeneratorProgram &program) const override;
 };
 }
 
@@ -0,0 +1,294 @@
+#include "successor_generator_program.h"
+
+#include "../operator_id.h"
+#include "../task_proxy.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+namespace successor_generator {
+int GeneratorProgram::get_child_offset(const int *node, int value) {
+    if (node[0] == SWITCH_VECTOR)
+        return node[3 + value];
+    assert(node[0] == SWITCH_SORTED);
+    int num_children = node[2];
+    const int *values = node + 3;
+    const int *values_end = values + num_children;
+    const int *it = lower_bound(values, values_end, value);
+    if (it == values_end || *it != value)
+        return 0;
+    return values_end[it - values];
+}
+
+template<typename ValueReader>
+void GeneratorProgram::generate_applicable_ops(
+    const int *node, const ValueReader &get_value,
+    vector<OperatorID> &applicable_ops) const {
+    while (true) {
+        switch (node[0]) {
+        case FORK: {
+            int num_children = node[1];
+            if (num_children == 0)
+                return;
+            for (int i = 0; i < num_children - 1; ++i)
+                generate_applicable_ops(node + node[2 + i], get_value, applicable_ops);
+            // Continue with the last child instead of recursing.
+            node += node[1 + num_children];
+            break;
+        }
+        case SWITCH_VECTOR:
+        case SWITCH_SORTED: {
+            int offset = get_child_offset(node, get_value(node[1]));
+            if (offset == 0)
+                return;
+            node += offset;
+            break;
+        }
+        case SWITCH_SINGLE:
+            if (get_value(node[1]) != node[2])
+                return;
+            node += 3;
+            break;
+        case LEAF: {
+            int num_ops = node[1];
+            // See GeneratorLeafVector for the reason for using push_back.
+            for (int i = 0; i < num_ops; ++i)
+                applicable_ops.push_back(OperatorID(node[2 + i]));
+            return;
+        }
+        default:
+            assert(false);
+            return;
+        }
+    }
+}
+
+void GeneratorProgram::generate_applicable_ops(
+    const State &state, vector<OperatorID> &applicable_ops) const {
+    assert(!code.empty());
+    generate_applicable_ops(
+        code.data(),
+        [&state](int var) {return state[var].get_value();},
+        applicable_ops);
+}
+
+void GeneratorProgram::generate_applicable_ops(
+    const int_packer::IntPacker::Bin *buffer,
+    const vector<int_packer::IntPacker::VariableLayout> &layouts,
+    vector<OperatorID> &applicable_ops) const {
+    assert(!code.empty());
+    generate_applicable_ops(
+        code.data(),
+        [buffer, &layouts](int var) {return layouts[var].get(buffer);},
+        applicable_ops);
+}
+
+int GeneratorProgram::get_child_key(const int *node, int value) {
+    if (node[0] == SWITCH_VECTOR)
+        return node[3 + value] == 0 ? 0 : value + 1;
+    assert(node[0] == SWITCH_SORTED);
+    int num_children = node[2];
+    const int *values = node + 3;
+    const int *values_end = values + num_children;
+    const int *it = lower_bound(values, values_end, value);
+    if (it == values_end || *it != value)
+        return 0;
+    return it - values + 1;
+}
+
+int GeneratorProgram::get_child_offset_for_key(const int *node, int key) {
+    assert(key > 0);
+    if (node[0] == SWITCH_VECTOR)
+        return node[2 + key];
+    assert(node[0] == SWITCH_SORTED);
+    return node[2 + node[2] + key];
+}
+
+void GeneratorProgram::group_by_child(
+    int *begin, int *end, int num_keys, BatchScratch &scratch) {
+    const vector<int> &child_keys = scratch.child_keys;
+    int num_states = end - begin;
+    if (num_keys > 4 * num_states) {
+        // Counting would mostly touch empty buckets.
+        sort(begin, end, [&child_keys](int index1, int index2) {
+                 return child_keys[index1] < child_keys[index2];
+             });
+        return;
+    }
+    vector<int> &key_starts = scratch.key_starts;
+    key_starts.assign(num_keys + 1, 0);
+    for (int *it = begin; it != end; ++it)
+        ++key_starts[child_keys[*it] + 1];
+    for (int key = 1; key < num_keys; ++key)
+        key_starts[key] += key_starts[key - 1];
+    vector<int> &sorted_indices = scratch.sorted_indices;
+    for (int *it = begin; it != end; ++it)
+        sorted_indices[key_starts[child_keys[*it]]++] = *it;
+    copy(sorted_indices.begin(), sorted_indices.begin() + num_states, begin);
+}
+
+template<typename ValueReader>
+void GeneratorProgram::generate_applicable_ops_for_batch(
+    const int *node, int *begin, int *end, const ValueReader &get_value,
+    BatchScratch &scratch, vector<vector<OperatorID>> &applicable_ops) const {
+    while (true) {
+        if (end - begin == 1) {
+            // Nothing left to share: continue with the plain traversal.
+            int index = *begin;
+            generate_applicable_ops(
+                node,
+                [index, &get_value](int var) {return get_value(index, var);},
+                applicable_ops[index]);
+            return;
+        }
+        switch (node[0]) {
+        case FORK: {
+            int num_children = node[1];
+            if (num_children == 0)
+                return;
+            for (int i = 0; i < num_children - 1; ++i) {
+                generate_applicable_ops_for_batch(
+                    node + node[2 + i], begin, end, get_value, scratch,
+                    applicable_ops);
+            }
+            node += node[1 + num_children];
+            break;
+        }
+        case SWITCH_VECTOR:
+        case SWITCH_SORTED: {
+            int var = node[1];
+            vector<int> &child_keys = scratch.child_keys;
+            int first_key = get_child_key(node, get_value(*begin, var));
+            child_keys[*begin] = first_key;
+            bool same_child = true;
+            for (int *it = begin + 1; it != end; ++it) {
+                int key = get_child_key(node, get_value(*it, var));
+                child_keys[*it] = key;
+                same_child &= (key == first_key);
+            }
+            if (same_child) {
+                if (first_key == 0)
+                    return;
+                node += get_child_offset_for_key(node, first_key);
+                break;
+            }
+            group_by_child(begin, end, node[2] + 1, scratch);
+            // States without a child come first.
+            while (begin != end && child_keys[*begin] == 0)
+                ++begin;
+            if (begin == end)
+                return;
+            /*
+              The recursive calls only overwrite the child keys of the
+              states in their own group, so the keys of the following
+              groups stay intact. We continue with the last group instead
+              of recursing.
+            */
+            while (true) {
+                int key = child_keys[*begin];
+                int *group_end = begin + 1;
+                while (group_end != end && child_keys[*group_end] == key)
+                    ++group_end;
+                if (group_end == end) {
+                    node += get_child_offset_for_key(node, key);
+                    break;
+                }
+                generate_applicable_ops_for_batch(
+                    node + get_child_offset_for_key(node, key), begin, group_end,
+                    get_value, scratch, applicable_ops);
+                begin = group_end;
+            }
+            break;
+        }
+        case SWITCH_SINGLE: {
+            int var = node[1];
+            int value = node[2];
+            end = partition(begin, end, [&get_value, var, value](int index) {
+                                return get_value(index, var) == value;
+                            });
+            if (begin == end)
+                return;
+            node += 3;
+            break;
+        }
+        case LEAF: {
+            int num_ops = node[1];
+            for (int *it = begin; it != end; ++it) {
+                vector<OperatorID> &ops = applicable_ops[*it];
+                for (int i = 0; i < num_ops; ++i)
+                    ops.push_back(OperatorID(node[2 + i]));
+            }
+            return;
+        }
+        default:
+            assert(false);
+            return;
+        }
+    }
+}
+
+void GeneratorProgram::generate_applicable_ops(
+    const vector<const int_packer::IntPacker::Bin *> &buffers,
+    const vector<int_packer::IntPacker::VariableLayout> &layouts,
+    vector<vector<OperatorID>> &applicable_ops) const {
+    assert(!code.empty());
+    assert(applicable_ops.size() == buffers.size());
+    int num_states = buffers.size();
+    if (num_states < MIN_BATCH_SIZE) {
+        for (int i = 0; i < num_states; ++i)
+            generate_applicable_ops(buffers[i], layouts, applicable_ops[i]);
+        return;
+    }
+    vector<int> indices(num_states);
+    for (int i = 0; i < num_states; ++i)
+        indices[i] = i;
+    BatchScratch scratch;
+    scratch.child_keys.resize(num_states);
+    scratch.sorted_indices.resize(num_states);
+    generate_applicable_ops_for_batch(
+        code.data(), indices.data(), indices.data() + num_states,
+        [&buffers, &layouts](int index, int var) {
+            return layouts[var].get(buffers[index]);
+        },
+        scratch, applicable_ops);
+}
+
+void GeneratorProgram::get_operators(
+    const int *node, vector<OperatorID> &operators) const {
+    switch (node[0]) {
+    case FORK:
+        for (int i = 0; i < node[1]; ++i)
+            get_operators(node + node[2 + i], operators);
+        break;
+    case SWITCH_VECTOR:
+        for (int value = 0; value < node[2]; ++value) {
+            int offset = node[3 + value];
+            if (offset != 0)
+                get_operators(node + offset, operators);
+        }
+        break;
+    case SWITCH_SORTED: {
+        int num_children = node[2];
+        for (int i = 0; i < num_children; ++i)
+            get_operators(node + node[3 + num_children + i], operators);
+        break;
+    }
+    case SWITCH_SINGLE:
+        get_operators(node + 3, operators);
+        break;
+    case LEAF:
+        for (int i = 0; i < node[1]; ++i)
+            operators.push_back(OperatorID(node[2 + i]));
+        break;
+    default:
+        assert(false);
+    }
+}
+
+void GeneratorProgram::get_operators(vector<OperatorID> &operators) const {
+    assert(!code.empty());
+    get_operators(code.data(), operators);
+}
+}
@@ -0,0 +1,138 @@
+#ifndef TASK_UTILS_SUCCESSOR_GENERATOR_PROGRAM_H
+#define TASK_UTILS_SUCCESSOR_GENERATOR_PROGRAM_H
+
+#include "../algorithms/int_packer.h"
+
+#include <vector>
+
+class OperatorID;
+class State;
+
+namespace successor_generator {
+/*
+  Compiled representation of a successor generator tree (see
+  successor_generator_internals.h). All nodes are stored in one vector
+  of ints, where each node starts with its type, followed by its
+  payload. Child nodes are referenced by their offset relative to the
+  start of the parent node (children are always stored after their
+  parent, so offsets are positive):
+
+  - fork:           [FORK, n, offset_1, ..., offset_n]
+  - vector switch:  [SWITCH_VECTOR, var, k, offset_0, ..., offset_k-1]
+                    with one offset per value of var (0 if there is no
+                    child for the value)
+  - sorted switch:  [SWITCH_SORTED, var, n, value_1, ..., value_n,
+                     offset_1, ..., offset_n]
+                    with value_1 < ... < value_n
+  - single switch:  [SWITCH_SINGLE, var, value], immediately followed
+                    by the child
+  - leaf:           [LEAF, n, op_id_1, ..., op_id_n]
+
+  The program is traversed in a non-virtual loop that only recurses for
+  forks and reads the state values without any indirection other than
+  the lookup of the variable layout. Operators are generated in the
+  same order as by the tree it was compiled from.
+
+  Several states can be processed in one traversal. The batch traversal
+  keeps a range of state indices per node: switches partition the range
+  by the child each state continues with, and leaves append their
+  operators to all states in the range. Every node is thus visited at
+  most once per batch instead of once per state. Grouping the states
+  costs more than it saves for small batches, which are therefore
+  processed state by state (MIN_BATCH_SIZE was chosen with blind search
+  on a few IPC tasks).
+
+  The tree nodes append themselves to the program in
+  GeneratorBase::compile.
+*/
+class GeneratorProgram {
+    static const int MIN_BATCH_SIZE = 32;
+
+    std::vector<int> code;
+
+    template<typename ValueReader>
+    void generate_applicable_ops(
+        const int *node, const ValueReader &get_value,
+        std::vector<OperatorID> &applicable_ops) const;
+    /*
+      Scratch space of the batch traversal with one entry per state of
+      the batch. The child key of a state at a vector or sorted switch is
+      0 if there is no child for its value and i + 1 if it continues with
+      the i-th child (the child for value i - 1 for vector switches).
+    */
+    struct BatchScratch {
+        std::vector<int> child_keys;
+        std::vector<int> key_starts;
+        std::vector<int> sorted_indices;
+    };
+
+    // Process the states with indices in [begin, end).
+    template<typename ValueReader>
+    void generate_applicable_ops_for_batch(
+        const int *node, int *begin, int *end, const ValueReader &get_value,
+        BatchScratch &scratch,
+        std::vector<std::vector<OperatorID>> &applicable_ops) const;
+    void get_operators(const int *node, std::vector<OperatorID> &operators) const;
+
+    // Offset of the child of a vector or sorted switch for value (0 if none).
+    static int get_child_offset(const int *node, int value);
+    static int get_child_key(const int *node, int value);
+    static int get_child_offset_for_key(const int *node, int key);
+    // Sort the state indices in [begin, end) by their child keys.
+    static void group_by_child(
+        int *begin, int *end, int num_keys, BatchScratch &scratch);
+public:
+    enum NodeType {
+        FORK,
+        SWITCH_VECTOR,
+        SWITCH_SORTED,
+        SWITCH_SINGLE,
+        LEAF
+    };
+
+    // Position at which the next node will be appended.
+    int get_size() const {
+        return code.size();
+    }
+
+    // Append an entry and return its position.
+    int append(int value) {
+        code.push_back(value);
+        return code.size() - 1;
+    }
+
+    // Set the entry at position pos to the offset from node_pos to the end.
+    void set_offset_to_end(int pos, int node_pos) {
+        code[pos] = code.size() - node_pos;
+    }
+
+    void shrink_to_fit() {
+        code.shrink_to_fit();
+    }
+
+    void generate_applicable_ops(
+        const State &state, std::vector<OperatorID> &applicable_ops) const;
+    // For packed states, with the layouts of the packer of the state.
+    void generate_applicable_ops(
+        const int_packer::IntPacker::Bin *buffer,
+        const std::vector<int_packer::IntPacker::VariableLayout> &layouts,
+        std::vector<OperatorID> &applicable_ops) const;
+    /*
+      For several packed states with the same layouts. The applicable
+      operators of buffers[i] are appended to applicable_ops[i].
+    */
+    void generate_applicable_ops(
+        const std::vector<const int_packer::IntPacker::Bin *> &buffers,
+        const std::vector<int_packer::IntPacker::VariableLayout> &layouts,
+        std::vector<std::vector<OperatorID>> &applicable_ops) const;
+
+    /*
+      Append all operators of the program in the order in which they are
+      generated. The applicable operators of every state are generated
+      in the order of this sequence.
+    */
+    void get_operators(std::vector<OperatorID> &operators) const;
+};
+}
+
+#endif
@@ -84,6 +84,14 @@ int get_min_operator_cost(TaskProxy task_proxy) {
     return min_cost;
 }
 
+int get_max_operator_cost(TaskProxy task_proxy) {
+    int max_cost = 0;
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        max_cost = max(max_cost, op.get_cost());
+    }
+    return max_cost;
+}
+
 void print_variable_statistics(const TaskProxy &task_proxy) {
     const int_packer::IntPacker &state_packer = g_state_packers[task_proxy];
 
@@ -151,15 +159,43 @@ void dump_task(const TaskProxy &task_proxy) {
     dump_goals(task_proxy.get_goals());
 }
 
+static vector<int> get_variable_ranges(const TaskProxy &task_proxy) {
+    VariablesProxy variables = task_proxy.get_variables();
+    vector<int> variable_ranges;
+    variable_ranges.reserve(variables.size());
+    for (VariableProxy var : variables) {
+        variable_ranges.push_back(var.get_domain_size());
+    }
+    return variable_ranges;
+}
+
 PerTaskInformation<int_packer::IntPacker> g_state_packers(
     [](const TaskProxy &task_proxy) {
-        VariablesProxy variables = task_proxy.get_variables();
-        vector<int> variable_ranges;
-        variable_ranges.reserve(variables.size());
-        for (VariableProxy var : variables) {
-            variable_ranges.push_back(var.get_domain_size());
+        return utils::make_unique_ptr<int_packer::IntPacker>(
+            get_variable_ranges(task_proxy));
+    }
+    );
+
+PerTaskInformation<int_packer::IntPacker> g_co_change_state_packers(
+    [](const TaskProxy &task_proxy) {
+        // Each operator changes the variables of its effects together.
+        vector<vector<int>> change_sets;
+        vector<bool> in_change_set(task_proxy.get_variables().size(), false);
+        for (OperatorProxy op : task_proxy.get_operators()) {
+            vector<int> change_set;
+            for (EffectProxy effect : op.get_effects()) {
+                int var = effect.get_fact().get_variable().get_id();
+                if (!in_change_set[var]) {
+                    in_change_set[var] = true;
+                    change_set.push_back(var);
+                }
+            }
+            for (int var : change_set)
+                in_change_set[var] = false;
+            change_sets.push_back(move(change_set));
         }
-        return utils::make_unique_ptr<int_packer::IntPacker>(variable_ranges);
+        return utils::make_unique_ptr<int_packer::IntPacker>(
+            get_variable_ranges(task_proxy), change_sets);
     }
     );
 }
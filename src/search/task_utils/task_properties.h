@@ -69,6 +69,7 @@ extern void verify_no_conditional_effects(TaskProxy task);
 extern std::vector<int> get_operator_costs(const TaskProxy &task_proxy);
 extern double get_average_operator_cost(TaskProxy task_proxy);
 extern int get_min_operator_cost(TaskProxy task_proxy);
+extern int get_max_operator_cost(TaskProxy task_proxy);
 
 template<class FactProxyCollection>
 std::vector<FactPair> get_fact_pairs(const FactProxyCollection &facts) {
@@ -87,6 +88,11 @@ extern void dump_goals(const GoalsProxy &goals);
 extern void dump_task(const TaskProxy &task_proxy);
 
 extern PerTaskInformation<int_packer::IntPacker> g_state_packers;
+/*
+  Packs variables that are changed by the same operators into the same
+  bins. Uses the same number of bins as g_state_packers.
+*/
+extern PerTaskInformation<int_packer::IntPacker> g_co_change_state_packers;
 }
 
 #endif
@@ -3,6 +3,7 @@
 #include "system.h"
 
 #include <chrono>
+#include <sstream>
 
 using namespace std;
 
@@ -30,4 +31,15 @@ RandomNumberGenerator::~RandomNumberGenerator() {
 void RandomNumberGenerator::seed(int seed) {
     rng.seed(seed);
 }
+
+string RandomNumberGenerator::get_state() const {
+    ostringstream stream;
+    stream << rng;
+    return stream.str();
+}
+
+void RandomNumberGenerator::set_state(const string &state) {
+    istringstream stream(state);
+    stream >> rng;
+}
 }
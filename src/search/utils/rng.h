@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <cassert>
 #include <random>
+#include <string>
 #include <vector>
 
 namespace utils {
@@ -20,6 +21,10 @@ public:
 
     void seed(int seed);
 
+    // Text representation of the internal state (e.g. for checkpoints).
+    std::string get_state() const;
+    void set_state(const std::string &state);
+
     // Return random double in [0..1).
     double operator()() {
         std::uniform_real_distribution<double> distribution(0.0, 1.0);
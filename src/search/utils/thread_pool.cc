@@ -0,0 +1,77 @@
+#include "thread_pool.h"
+
+#include <atomic>
+#include <cassert>
+
+using namespace std;
+
+namespace utils {
+ThreadPool::ThreadPool(int num_threads)
+    : job(nullptr),
+      job_number(0),
+      num_busy_workers(0),
+      stopping(false) {
+    assert(num_threads >= 1);
+    workers.reserve(num_threads - 1);
+    for (int thread_index = 1; thread_index < num_threads; ++thread_index)
+        workers.emplace_back(&ThreadPool::work, this, thread_index);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    job_started.notify_all();
+    for (thread &worker : workers)
+        worker.join();
+}
+
+void ThreadPool::work(int thread_index) {
+    int last_job_number = 0;
+    unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        job_started.wait(lock, [this, last_job_number]() {
+                             return stopping || job_number != last_job_number;
+                         });
+        if (stopping)
+            return;
+        last_job_number = job_number;
+        const function<void(int)> &current_job = *job;
+        lock.unlock();
+        current_job(thread_index);
+        lock.lock();
+        if (--num_busy_workers == 0)
+            job_finished.notify_one();
+    }
+}
+
+void ThreadPool::run(const function<void(int)> &new_job) {
+    if (workers.empty()) {
+        new_job(0);
+        return;
+    }
+    {
+        lock_guard<std::mutex> lock(mutex);
+        assert(!job && num_busy_workers == 0);
+        job = &new_job;
+        ++job_number;
+        num_busy_workers = workers.size();
+    }
+    job_started.notify_all();
+    new_job(0);
+    unique_lock<std::mutex> lock(mutex);
+    job_finished.wait(lock, [this]() {
+                          return num_busy_workers == 0;
+                      });
+    job = nullptr;
+}
+
+void ThreadPool::for_each(int num_tasks, const function<void(int, int)> &task) {
+    atomic<int> next_task(0);
+    run([&next_task, num_tasks, &task](int thread_index) {
+            for (int i = next_task++; i < num_tasks; i = next_task++)
+                task(thread_index, i);
+        });
+}
+}
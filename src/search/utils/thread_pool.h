@@ -0,0 +1,57 @@
+#ifndef UTILS_THREAD_POOL_H
+#define UTILS_THREAD_POOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace utils {
+/*
+  A fixed set of threads for fork-join parallelism. The pool starts
+  num_threads - 1 worker threads; the thread calling run or for_each
+  takes part in the work as thread 0.
+
+  run and for_each return once all threads have finished, so the caller
+  may pass references to local data. They must not be called
+  concurrently or from within a job.
+*/
+class ThreadPool {
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable job_started;
+    std::condition_variable job_finished;
+    const std::function<void(int)> *job;
+    // Incremented for every job, so that workers can tell new jobs apart.
+    int job_number;
+    int num_busy_workers;
+    bool stopping;
+
+    void work(int thread_index);
+
+public:
+    explicit ThreadPool(int num_threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    int get_num_threads() const {
+        return workers.size() + 1;
+    }
+
+    // Call job(thread_index) on every thread of the pool.
+    void run(const std::function<void(int)> &job);
+
+    /*
+      Call task(thread_index, i) for all 0 <= i < num_tasks. Threads
+      take the next unprocessed task when they are done with the
+      previous one, so which thread processes a task is not
+      deterministic.
+    */
+    void for_each(int num_tasks, const std::function<void(int, int)> &task);
+};
+}
+
+#endif